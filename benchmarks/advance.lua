@@ -0,0 +1,46 @@
+-- Measures the time spent by advance
+-- on pcg32 and pcg64 for small, large
+-- and negative (jump-back) deltas.
+-- 
+-- On builds emulating 128-bit integers
+-- (LUA_PCG_FORCE_U128_EMULATED), advance on
+-- pcg64 depends on the emulated 128-bit multiplication.
+-- 
+-- Usage: lua benchmarks/advance.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 100000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function measure(label, rng, delta)
+    local advance = rng.advance
+    local start = os.clock()
+    for _ = 1, iterations do
+        advance(rng, delta)
+    end
+    local elapsed = os.clock() - start
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure("pcg32 advance(0x1)", rng32, "0x1")
+measure("pcg32 advance(0x100000)", rng32, "0x100000")
+measure("pcg32 advance(0x8000000000000000)", rng32, "0x8000000000000000")
+measure("pcg32 advance(-1)", rng32, "0xFFFFFFFFFFFFFFFF")
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure("pcg64 advance(0x1)", rng64, "0x1")
+measure("pcg64 advance(0x100000)", rng64, "0x100000")
+measure("pcg64 advance(2^127)", rng64, "0x80000000000000000000000000000000")
+measure("pcg64 advance(-1)", rng64, "0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF")
+rng64:close()
@@ -0,0 +1,84 @@
+-- Measures the time spent by weighted draws
+-- through a binary search on the cumulative
+-- weights written in Lua against alias:sample(rng)
+-- and alias:sample(rng, n), on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/alias.lua [iterations [size]]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+local alias = pcg.alias
+
+local iterations = tonumber(arg and arg[1]) or 1000000
+local size = tonumber(arg and arg[2]) or 1000
+local batch = 1000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print(("iterations: %i, size: %i"):format(iterations, size))
+print()
+
+local weights = {}
+local cumulative = {}
+local sum = 0
+for i = 1, size do
+    weights[i] = 1 + (i * 7919) % 100
+    sum = sum + weights[i]
+    cumulative[i] = sum
+end
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local function measure_lua(label, rng)
+    local start = os.clock()
+    for _ = 1, iterations do
+        local u = rng:nextdouble() * sum
+        local lo, hi = 1, size
+        while (lo < hi) do
+            local mid = math.floor((lo + hi) / 2)
+            if (cumulative[mid] <= u) then
+                lo = mid + 1
+            else
+                hi = mid
+            end
+        end
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_alias(label, rng, a)
+    local start = os.clock()
+    for _ = 1, iterations do
+        a:sample(rng)
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_alias_bulk(label, rng, a)
+    local start = os.clock()
+    for _ = 1, iterations / batch do
+        a:sample(rng, batch)
+    end
+    report(label, os.clock() - start)
+end
+
+local start = os.clock()
+local a = alias.new(weights)
+print(("%-40s %10.2f us/call"):format("alias.new(weights)", 1e6 * (os.clock() - start)))
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_lua("pcg32 binary search in Lua", rng32)
+measure_alias("pcg32 alias:sample(rng)", rng32, a)
+measure_alias_bulk("pcg32 alias:sample(rng, " .. batch .. ")", rng32, a)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_lua("pcg64 binary search in Lua", rng64)
+measure_alias("pcg64 alias:sample(rng)", rng64, a)
+measure_alias_bulk("pcg64 alias:sample(rng, " .. batch .. ")", rng64, a)
+rng64:close()
@@ -0,0 +1,43 @@
+-- Measures the time spent by coin flips
+-- through next(2) against bool(), and
+-- small masks through next(16) against bits(4),
+-- on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/bits.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 10000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function measure(label, rng, method, ...)
+    local f = rng[method]
+    local start = os.clock()
+    for _ = 1, iterations do
+        f(rng, ...)
+    end
+    local elapsed = os.clock() - start
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure("pcg32 next(2)", rng32, "next", 2)
+measure("pcg32 bool()", rng32, "bool")
+measure("pcg32 next(16)", rng32, "next", 16)
+measure("pcg32 bits(4)", rng32, "bits", 4)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure("pcg64 next(2)", rng64, "next", 2)
+measure("pcg64 bool()", rng64, "bool")
+measure("pcg64 next(16)", rng64, "next", 16)
+measure("pcg64 bits(4)", rng64, "bits", 4)
+rng64:close()
@@ -0,0 +1,44 @@
+-- Measures the time spent by bounded draws
+-- of pcg64 compared to unbounded draws.
+-- 
+-- On builds emulating 64-bit integers
+-- (LUA_PCG_FORCE_U64_EMULATED), bounded draws
+-- depend on the emulated 64-bit division.
+-- 
+-- Usage: lua benchmarks/bounded64.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 1000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function measure(label, ...)
+    local rng = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+    local next = rng.next
+    local start = os.clock()
+    for _ = 1, iterations do
+        next(rng, ...)
+    end
+    local elapsed = os.clock() - start
+    rng:close()
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+measure("next()")
+measure("next(6)", 6)
+measure("next(1024)", 1024)
+measure("next(0x55555556)", 0x55555556)
+measure("next(1, 0xFFFFFFFF)", 1, 0xFFFFFFFF)
+
+-- 64-bit bounds can only be written as integers on Lua 5.3+ with 64-bit integers
+if (math.type ~= nil and pcg.has64bitinteger) then
+    measure("next(0x5555555555556000)", 0x5555555555556000)
+    measure("next(0x7FFFFFFFFFFFFFFF)", 0x7FFFFFFFFFFFFFFF)
+end
@@ -0,0 +1,43 @@
+-- Measures the time spent by parsing
+-- 64-bit and 128-bit arguments given as
+-- hex strings, compared to integers and
+-- binary strings passed as {binary = s},
+-- which skip hex decoding.
+-- 
+-- Usage: lua benchmarks/hexparse.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 1000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function measure(label, rng, initstate, initseq)
+    local seed = rng.seed
+    local start = os.clock()
+    for _ = 1, iterations do
+        seed(rng, initstate, initseq)
+    end
+    local elapsed = os.clock() - start
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local rng32 = pcg32.new()
+measure("pcg32 seed(hex 1 digit)", rng32, "0x1", "0x2")
+measure("pcg32 seed(hex 16 digits)", rng32, "0x853c49e6748fea9b", "0xda3e39cb94b95bdb")
+measure("pcg32 seed(integer)", rng32, 42, 54)
+measure("pcg32 seed(binary)", rng32, {binary = "\155\234\143\116\230\073\060\133"}, {binary = "\219\091\185\148\203\057\062\218"})
+rng32:close()
+
+local rng64 = pcg64.new()
+measure("pcg64 seed(hex 1 digit)", rng64, "0x1", "0x2")
+measure("pcg64 seed(hex 32 digits)", rng64, "0x979c9a98d84620057d3e9cb6cfe0549b", "0x0000000000000001da3e39cb94b95bdb")
+measure("pcg64 seed(integer)", rng64, 42, 54)
+rng64:close()
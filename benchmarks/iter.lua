@@ -0,0 +1,69 @@
+-- Measures the time spent by loops over
+-- random values written around rng:next()
+-- against the generic for of rng:iter(n),
+-- on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/iter.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 10000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local function measure_next(label, rng, a, b)
+    local sum = 0
+    local start = os.clock()
+    if (a == nil) then
+        for _ = 1, iterations do
+            sum = sum + rng:next()
+        end
+    else
+        for _ = 1, iterations do
+            sum = sum + rng:next(a, b)
+        end
+    end
+    report(label, os.clock() - start)
+    return sum
+end
+
+local function measure_iter(label, rng, a, b)
+    local sum = 0
+    local start = os.clock()
+    if (a == nil) then
+        for _, x in rng:iter(iterations) do
+            sum = sum + x
+        end
+    else
+        for _, x in rng:iter(iterations, a, b) do
+            sum = sum + x
+        end
+    end
+    report(label, os.clock() - start)
+    return sum
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_next("pcg32 for ... rng:next()", rng32)
+measure_iter("pcg32 for ... in rng:iter(n)", rng32)
+measure_next("pcg32 for ... rng:next(1, 7)", rng32, 1, 7)
+measure_iter("pcg32 for ... in rng:iter(n, 1, 7)", rng32, 1, 7)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_next("pcg64 for ... rng:next()", rng64)
+measure_iter("pcg64 for ... in rng:iter(n)", rng64)
+measure_next("pcg64 for ... rng:next(1, 7)", rng64, 1, 7)
+measure_iter("pcg64 for ... in rng:iter(n, 1, 7)", rng64, 1, 7)
+rng64:close()
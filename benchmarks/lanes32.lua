@@ -0,0 +1,40 @@
+-- Compares the throughput of pcg32
+-- against the multi-lane pcg32x8.
+-- 
+-- On LuaJIT, raw generation is also measured
+-- through fillbuffer on FFI arrays.
+-- 
+-- Usage: lua benchmarks/lanes32.lua [values]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg32x8 = pcg.pcg32x8
+
+local n = tonumber(arg and arg[1]) or 4000000
+local chunk = 4096
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("pcg32x8 kernel: " .. pcg32x8.kernel)
+print("values: " .. n)
+print()
+
+local function measure(label, rng, func, ...)
+    local start = os.clock()
+    for _ = 1, n / chunk do
+        func(rng, ...)
+    end
+    local elapsed = os.clock() - start
+    rng:close()
+    print(("%-32s %10.2f ns/value"):format(label, 1e9 * elapsed / n))
+end
+
+measure("pcg32 fill", pcg32.new(), pcg32.fill, chunk)
+measure("pcg32x8 fill", pcg32x8.new(), pcg32x8.fill, chunk)
+
+local has_ffi, ffi = pcall(require, "ffi")
+if (has_ffi) then
+    local buf = ffi.new("uint32_t[?]", chunk)
+    measure("pcg32 fillbuffer", pcg32.new(), pcg32.fillbuffer, buf, chunk)
+    measure("pcg32x8 fillbuffer", pcg32x8.new(), pcg32x8.fillbuffer, buf, chunk)
+end
@@ -0,0 +1,51 @@
+-- Measures the time spent by the
+-- 0, 1 and 2-argument forms of next
+-- on pcg32 and pcg64.
+-- 
+-- Usage: lua benchmarks/next.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 10000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function measure(label, rng, ...)
+    local next = rng.next
+    local start = os.clock()
+    for _ = 1, iterations do
+        next(rng, ...)
+    end
+    local elapsed = os.clock() - start
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local function measure_method(label, rng)
+    local start = os.clock()
+    for _ = 1, iterations do
+        rng:next()
+    end
+    local elapsed = os.clock() - start
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_method("pcg32 rng:next()", rng32)
+measure("pcg32 next()", rng32)
+measure("pcg32 next(6)", rng32, 6)
+measure("pcg32 next(1, 6)", rng32, 1, 6)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_method("pcg64 rng:next()", rng64)
+measure("pcg64 next()", rng64)
+measure("pcg64 next(6)", rng64, 6)
+measure("pcg64 next(1, 6)", rng64, 1, 6)
+rng64:close()
@@ -0,0 +1,52 @@
+-- Measures the time spent to build a random
+-- permutation of 1 to n through a table
+-- filled and shuffled in Lua against
+-- rng:permutation(n), on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/permutation.lua [size]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local size = tonumber(arg and arg[1]) or 1000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("size: " .. size)
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/element"):format(label, 1e9 * elapsed / size))
+end
+
+local function measure_lua(label, rng)
+    local start = os.clock()
+    local t = {}
+    for i = 1, size do
+        t[i] = i
+    end
+    for k = size, 2, -1 do
+        local r = rng:next(1, k + 1)
+        t[k], t[r] = t[r], t[k]
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_permutation(label, rng)
+    local start = os.clock()
+    rng:permutation(size)
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_lua("pcg32 permutation in Lua", rng32)
+measure_permutation("pcg32 rng:permutation(n)", rng32)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_lua("pcg64 permutation in Lua", rng64)
+measure_permutation("pcg64 rng:permutation(n)", rng64)
+rng64:close()
@@ -0,0 +1,81 @@
+-- Measures the time spent to keep k items out of
+-- a stream of n items through reservoir sampling
+-- written in Lua (a draw for each item) against
+-- pcg.reservoir (Algorithm L and A-ExpJ),
+-- on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/reservoir.lua [n [k [repetitions]]]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+local reservoir = pcg.reservoir
+
+local n = tonumber(arg and arg[1]) or 100000
+local k = tonumber(arg and arg[2]) or 100
+local repetitions = tonumber(arg and arg[3]) or 20
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print(("n: %i, k: %i, repetitions: %i"):format(n, k, repetitions))
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/item"):format(label, 1e9 * elapsed / (n * repetitions)))
+end
+
+local function measure_lua(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        local t = {}
+        for i = 1, n do
+            if (i <= k) then
+                t[i] = i
+            else
+                local r = rng:next(1, i + 1)
+                if (r <= k) then
+                    t[r] = i
+                end
+            end
+        end
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_reservoir(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        local r = reservoir.new(rng, k)
+        for i = 1, n do
+            r:push(i)
+        end
+        r:result()
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_weighted(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        local r = reservoir.new(rng, k, true)
+        for i = 1, n do
+            r:push(i, 1 + i % 10)
+        end
+        r:result()
+    end
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_lua("pcg32 reservoir in Lua", rng32)
+measure_reservoir("pcg32 reservoir:push(item)", rng32)
+measure_weighted("pcg32 reservoir:push(item, weight)", rng32)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_lua("pcg64 reservoir in Lua", rng64)
+measure_reservoir("pcg64 reservoir:push(item)", rng64)
+measure_weighted("pcg64 reservoir:push(item, weight)", rng64)
+rng64:close()
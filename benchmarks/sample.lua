@@ -0,0 +1,58 @@
+-- Measures the time spent to draw k distinct
+-- integers out of 1 to n through a table of
+-- n elements shuffled in Lua against
+-- rng:sample(n, k), on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/sample.lua [n [k [repetitions]]]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local n = tonumber(arg and arg[1]) or 100000
+local k = tonumber(arg and arg[2]) or 100
+local repetitions = tonumber(arg and arg[3]) or 100
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print(("n: %i, k: %i, repetitions: %i"):format(n, k, repetitions))
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f us/call"):format(label, 1e6 * elapsed / repetitions))
+end
+
+local function measure_lua(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        local t = {}
+        for i = 1, n do
+            t[i] = i
+        end
+        for i = 1, k do
+            local r = rng:next(i, n + 1)
+            t[i], t[r] = t[r], t[i]
+        end
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_sample(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        rng:sample(n, k)
+    end
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_lua("pcg32 partial shuffle in Lua", rng32)
+measure_sample("pcg32 rng:sample(n, k)", rng32)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_lua("pcg64 partial shuffle in Lua", rng64)
+measure_sample("pcg64 rng:sample(n, k)", rng64)
+rng64:close()
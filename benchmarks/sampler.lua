@@ -0,0 +1,72 @@
+-- Measures the time spent by bounded draws
+-- through next(a, b) against a sampler
+-- created once by sampler(a, b),
+-- on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/sampler.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 10000000
+local batch = 1000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / iterations))
+end
+
+local function measure_next(label, rng, a, b)
+    local start = os.clock()
+    for _ = 1, iterations do
+        rng:next(a, b)
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_sampler(label, rng, a, b)
+    local sampler = rng:sampler(a, b)
+    local start = os.clock()
+    for _ = 1, iterations do
+        sampler()
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_fill(label, rng, a, b)
+    local start = os.clock()
+    for _ = 1, iterations / batch do
+        rng:fill(batch, a, b)
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_sampler_bulk(label, rng, a, b)
+    local sampler = rng:sampler(a, b)
+    local start = os.clock()
+    for _ = 1, iterations / batch do
+        sampler(batch)
+    end
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_next("pcg32 next(1, 7)", rng32, 1, 7)
+measure_sampler("pcg32 sampler(1, 7)()", rng32, 1, 7)
+measure_fill("pcg32 fill(" .. batch .. ", 1, 7)", rng32, 1, 7)
+measure_sampler_bulk("pcg32 sampler(1, 7)(" .. batch .. ")", rng32, 1, 7)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_next("pcg64 next(1, 7)", rng64, 1, 7)
+measure_sampler("pcg64 sampler(1, 7)()", rng64, 1, 7)
+measure_fill("pcg64 fill(" .. batch .. ", 1, 7)", rng64, 1, 7)
+measure_sampler_bulk("pcg64 sampler(1, 7)(" .. batch .. ")", rng64, 1, 7)
+rng64:close()
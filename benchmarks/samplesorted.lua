@@ -0,0 +1,63 @@
+-- Measures the time spent to draw k distinct
+-- integers out of 1 to n in increasing order
+-- through rng:sample(n, k) followed by table.sort
+-- against rng:samplesorted(n, k) and
+-- rng:itersorted(n, k), on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/samplesorted.lua [n [k [repetitions]]]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local n = tonumber(arg and arg[1]) or 1000000
+local k = tonumber(arg and arg[2]) or 1000
+local repetitions = tonumber(arg and arg[3]) or 100
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print(("n: %i, k: %i, repetitions: %i"):format(n, k, repetitions))
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f us/call"):format(label, 1e6 * elapsed / repetitions))
+end
+
+local function measure_sort(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        table.sort(rng:sample(n, k))
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_samplesorted(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        rng:samplesorted(n, k)
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_itersorted(label, rng)
+    local start = os.clock()
+    for _ = 1, repetitions do
+        for _ in rng:itersorted(n, k) do
+        end
+    end
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_sort("pcg32 table.sort(rng:sample(n, k))", rng32)
+measure_samplesorted("pcg32 rng:samplesorted(n, k)", rng32)
+measure_itersorted("pcg32 rng:itersorted(n, k)", rng32)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_sort("pcg64 table.sort(rng:sample(n, k))", rng64)
+measure_samplesorted("pcg64 rng:samplesorted(n, k)", rng64)
+measure_itersorted("pcg64 rng:itersorted(n, k)", rng64)
+rng64:close()
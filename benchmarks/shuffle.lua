@@ -0,0 +1,52 @@
+-- Measures the time spent to shuffle a table
+-- through a Fisher-Yates loop written in Lua
+-- against rng:shuffle(t), on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/shuffle.lua [size]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local size = tonumber(arg and arg[1]) or 1000000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("size: " .. size)
+print()
+
+local t = {}
+for i = 1, size do
+    t[i] = i
+end
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/element"):format(label, 1e9 * elapsed / size))
+end
+
+local function measure_lua(label, rng)
+    local start = os.clock()
+    for k = size, 2, -1 do
+        local r = rng:next(1, k + 1)
+        t[k], t[r] = t[r], t[k]
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_shuffle(label, rng)
+    local start = os.clock()
+    rng:shuffle(t)
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_lua("pcg32 Fisher-Yates in Lua", rng32)
+measure_shuffle("pcg32 rng:shuffle(t)", rng32)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_lua("pcg64 Fisher-Yates in Lua", rng64)
+measure_shuffle("pcg64 rng:shuffle(t)", rng64)
+rng64:close()
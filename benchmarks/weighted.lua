@@ -0,0 +1,91 @@
+-- Measures the time spent to update a weight and
+-- draw an integer with probability proportional to
+-- its weight through a linear scan written in Lua,
+-- through an alias table rebuilt on every update and
+-- through weighted:set(i, w) and weighted:sample(rng),
+-- on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/weighted.lua [iterations [size]]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+local alias = pcg.alias
+local weighted = pcg.weighted
+
+local iterations = tonumber(arg and arg[1]) or 100000
+local size = tonumber(arg and arg[2]) or 1000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print(("iterations: %i, size: %i"):format(iterations, size))
+print()
+
+local function report(label, elapsed, count)
+    print(("%-40s %10.2f ns/call"):format(label, 1e9 * elapsed / count))
+end
+
+local function measure_lua(label, rng)
+    local weights = {}
+    local total = 0
+    for i = 1, size do
+        weights[i] = 1
+        total = total + 1
+    end
+    local start = os.clock()
+    for _ = 1, iterations do
+        local i = 1 + rng:next(size)
+        local w = 1 + rng:next(100)
+        total = total - weights[i] + w
+        weights[i] = w
+        local u = rng:nextdouble() * total
+        for j = 1, size do
+            u = u - weights[j]
+            if (u < 0) then
+                break
+            end
+        end
+    end
+    report(label, os.clock() - start, iterations)
+end
+
+local function measure_alias(label, rng)
+    local weights = {}
+    for i = 1, size do
+        weights[i] = 1
+    end
+    local count = math.max(1, math.floor(iterations / 100))
+    local start = os.clock()
+    for _ = 1, count do
+        weights[1 + rng:next(size)] = 1 + rng:next(100)
+        alias.new(weights):sample(rng)
+    end
+    report(label, os.clock() - start, count)
+end
+
+local function measure_weighted(label, rng)
+    local w = weighted.new(size)
+    for i = 1, size do
+        w:set(i, 1)
+    end
+    local start = os.clock()
+    for _ = 1, iterations do
+        w:set(1 + rng:next(size), 1 + rng:next(100))
+        w:sample(rng)
+    end
+    report(label, os.clock() - start, iterations)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_lua("pcg32 linear scan in Lua", rng32)
+measure_alias("pcg32 alias rebuilt per update", rng32)
+measure_weighted("pcg32 weighted:set + weighted:sample", rng32)
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_lua("pcg64 linear scan in Lua", rng64)
+measure_alias("pcg64 alias rebuilt per update", rng64)
+measure_weighted("pcg64 weighted:set + weighted:sample", rng64)
+rng64:close()
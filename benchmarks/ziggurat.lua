@@ -0,0 +1,83 @@
+-- Measures the time spent to generate normal and
+-- exponential numbers through Box-Muller and inversion
+-- written in Lua over rng:nextdouble() against the
+-- ziggurat methods rng:normal() and rng:exponential(),
+-- on pcg32 and pcg64.
+--
+-- Usage: lua benchmarks/ziggurat.lua [iterations]
+
+local pcg = require("lua-pcg")
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+
+local iterations = tonumber(arg and arg[1]) or 1000000
+local batch = 1000
+
+print("lua-pcg version: " .. pcg.version)
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+print("iterations: " .. iterations)
+print()
+
+local function report(label, elapsed)
+    print(("%-40s %10.2f ns/number"):format(label, 1e9 * elapsed / iterations))
+end
+
+local function measure_box_muller(label, rng)
+    local start = os.clock()
+    for _ = 1, iterations / 2 do
+        local radius = math.sqrt(-2 * math.log(1 - rng:nextdouble()))
+        local theta = 2 * math.pi * rng:nextdouble()
+        local _ = radius * math.cos(theta)
+        _ = radius * math.sin(theta)
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_inversion(label, rng)
+    local start = os.clock()
+    for _ = 1, iterations do
+        local _ = -math.log(1 - rng:nextdouble())
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure(label, rng, method)
+    local f = rng[method]
+    local start = os.clock()
+    for _ = 1, iterations do
+        f(rng)
+    end
+    report(label, os.clock() - start)
+end
+
+local function measure_bulk(label, rng, method)
+    local start = os.clock()
+    for _ = 1, iterations / batch do
+        if (method == "normal") then
+            rng:normal(0, 1, batch)
+        else
+            rng:exponential(1, batch)
+        end
+    end
+    report(label, os.clock() - start)
+end
+
+local rng32 = pcg32.new('0x853c49e6748fea9b', '0xda3e39cb94b95bdb')
+measure_box_muller("pcg32 Box-Muller in Lua", rng32)
+measure("pcg32 rng:normal()", rng32, "normal")
+measure_bulk("pcg32 rng:normal(0, 1, " .. batch .. ")", rng32, "normal")
+measure_inversion("pcg32 inversion in Lua", rng32)
+measure("pcg32 rng:exponential()", rng32, "exponential")
+measure_bulk("pcg32 rng:exponential(1, " .. batch .. ")", rng32, "exponential")
+rng32:close()
+
+local rng64 = pcg64.new('0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb')
+measure_box_muller("pcg64 Box-Muller in Lua", rng64)
+measure("pcg64 rng:normal()", rng64, "normal")
+measure_bulk("pcg64 rng:normal(0, 1, " .. batch .. ")", rng64, "normal")
+measure_inversion("pcg64 inversion in Lua", rng64)
+measure("pcg64 rng:exponential()", rng64, "exponential")
+measure_bulk("pcg64 rng:exponential(1, " .. batch .. ")", rng64, "exponential")
+rng64:close()
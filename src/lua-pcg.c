@@ -26,6 +26,8 @@
 
 #include <lualib.h>
 #include <lauxlib.h>
+#include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -33,6 +35,11 @@
 #define LUA_PCG_METATABLE "lua_pcg_metatable"
 #define LUA_PCG_PCG32_METATABLE "lua_pcg_pcg32_metatable"
 #define LUA_PCG_PCG64_METATABLE "lua_pcg_pcg64_metatable"
+#define LUA_PCG_PCG32X8_METATABLE "lua_pcg_pcg32x8_metatable"
+#define LUA_PCG_PCG64X4_METATABLE "lua_pcg_pcg64x4_metatable"
+#define LUA_PCG_RESERVOIR_METATABLE "lua_pcg_reservoir_metatable"
+#define LUA_PCG_ALIAS_METATABLE "lua_pcg_alias_metatable"
+#define LUA_PCG_WEIGHTED_METATABLE "lua_pcg_weighted_metatable"
 
 typedef unsigned char lua_pcg_u8;
 #define lua_pcg_u8_cast(x) ((lua_pcg_u8)((x) & 0xFF))
@@ -107,15 +114,17 @@ typedef unsigned __int64 lua_pcg_u64;
 ** the goal to find unique q and r
 ** satisfying a = q * b + r
 ** such that 0 <= r < b. To do that,
-** we operate candidate values (q * b)
-** on 128-bit with q varying from 1
-** to 0xFFFFFFFFFFFFFFFF (max value from uint64_t). 
-** Since the process to iterate
-** through all these values would
-** take a lot of time, we employ the bisection
-** method to find such q. Thus, the division
-** operation has O(N) time complexity,
-** where N is the number of bits (64) on uint64_t.
+** we also follow the idea that we
+** use to divide integers on paper,
+** "schoolbook long division"
+** (Knuth's Algorithm D), on 16-bit
+** words of a and b. Each quotient word
+** is estimated from the leading words
+** and corrected at most twice, so the
+** division costs O(W^2) 32-bit operations,
+** where W is the number of 16-bit
+** words (4) on uint64_t
+** (see lua_pcg_u64_div).
 ** 
 */
 typedef struct
@@ -760,31 +769,12 @@ static lua_pcg_u128 lua_pcg_u128_bnot(lua_pcg_u128 value)
     return lua_pcg_u128_lh((lua_pcg_u64_bnot((value.low))), (lua_pcg_u64_bnot((value.high))));
 }
 
-/* additive inverse: - value */
-static lua_pcg_u128 lua_pcg_u128_additive_inverse(lua_pcg_u128 value)
-{
-    /* - value <-> (~ value) + 1 */
-    return lua_pcg_u128_sum(lua_pcg_u128_bnot(value), lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U)));
-}
-
-/* subtraction: a - b */
-static lua_pcg_u128 lua_pcg_u128_subtraction(lua_pcg_u128 a, lua_pcg_u128 b)
-{
-    return lua_pcg_u128_sum(a, lua_pcg_u128_additive_inverse(b));
-}
-
 /* bitwise or: a | b */
 static lua_pcg_u128 lua_pcg_u128_bor(lua_pcg_u128 a, lua_pcg_u128 b)
 {
     return lua_pcg_u128_lh((lua_pcg_u64_bor((a.low), (b.low))), (lua_pcg_u64_bor((a.high), (b.high))));
 }
 
-/* bitwise and: a & b */
-static lua_pcg_u128 lua_pcg_u128_band(lua_pcg_u128 a, lua_pcg_u128 b)
-{
-    return lua_pcg_u128_lh((lua_pcg_u64_band((a.low), (b.low))), (lua_pcg_u64_band((a.high), (b.high))));
-}
-
 /* right shift: value >> n (0 < n < 128) */
 static lua_pcg_u128 lua_pcg_u128_rsh(lua_pcg_u128 value, unsigned int n)
 {
@@ -894,15 +884,26 @@ static lua_pcg_u128 lua_pcg_u128_mul(lua_pcg_u128 a, lua_pcg_u128 b)
 
 #ifdef LUA_PCG_U64_EMULATED
 
+/* fills words with the four 16-bit words of value in little-endian order */
+static void lua_pcg_u64_to_words(lua_pcg_u64 value, lua_pcg_u32 *words)
+{
+    words[0] = (lua_pcg_u32)lua_pcg_u16_cast(value.low);
+    words[1] = (lua_pcg_u32)lua_pcg_u16_cast(value.low >> 16U);
+    words[2] = (lua_pcg_u32)lua_pcg_u16_cast(value.high);
+    words[3] = (lua_pcg_u32)lua_pcg_u16_cast(value.high >> 16U);
+}
+
 /* division (64-bit) with 64-bit result: a / b */
 static int lua_pcg_u64_div(lua_pcg_u64 a, lua_pcg_u64 b, lua_pcg_u64 *q, lua_pcg_u64 *r)
 {
     int res = 0;
 
     /* variables definitions for the interesting case (a > b) */
-    int found = 0;
+    int i, j, m, n;
+    unsigned int s;
     lua_pcg_u32 q32, a_low, b_low;
-    lua_pcg_u128 _a, _b, _q, q_left, q_right, qb;
+    lua_pcg_u32 qhat, rhat, p, t, carry, borrow;
+    lua_pcg_u32 u[4], v[4], un[5], vn[4], qw[4], rw[4];
 
     /* b == 0 */
     if (lua_pcg_u64_eq(b, lua_pcg_u64_lh(0U, 0U)))
@@ -938,93 +939,115 @@ static int lua_pcg_u64_div(lua_pcg_u64 a, lua_pcg_u64 b, lua_pcg_u64 *q, lua_pcg
     }
     else /* a > b, the interesting case with a or b truly 64-bit values */
     {
-        /* 
-        ** In order to find both (q)uotient and (r)emainder,
-        ** q must be the maximum integer value
-        ** such that q * b <= a.
+        /*
+        ** Schoolbook long division (Knuth's Algorithm D)
+        ** on 16-bit words, such that every intermediate
+        ** product and sum fits on a 32-bit integer.
         ** 
-        ** By definition of q being a maximum,
-        ** this means that (q + 1) * b > a, which is the same as
-        ** q * b + b > a.
-        ** 
-        ** So, to find such q, we perform the bisection method
-        ** on q between [1, MAX_VALUE], where MAX_VALUE is the
-        ** maximum integer value for the type.
-        ** 
-        ** Thus, since all the other methods involved here are O(1),
-        ** the division has O(N) time complexity
-        ** where N is the number of bits of the integer type.
+        ** a is split on the words u[0..3] and b on the
+        ** words v[0..(n - 1)], where v[n - 1] is the most
+        ** significant non-zero word of b. Both are shifted
+        ** to the left by s bits in order to set the highest bit
+        ** of v[n - 1], which guarantees that each estimated
+        ** quotient word qhat exceeds the true word by at most 2.
         */
-        found = 0;
-
-        /* _a = (lua_pcg_u128) a */
-        _a = lua_pcg_u128_lh(a, lua_pcg_u64_lh(0U, 0U));
-
-        /* _b = (lua_pcg_u128) b */
-        _b = lua_pcg_u128_lh(b, lua_pcg_u64_lh(0U, 0U));
+        lua_pcg_u64_to_words(a, u);
+        lua_pcg_u64_to_words(b, v);
 
-        /* q_left = (lua_pcg_u128) 1U */
-        q_left = lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U));
+        for (n = 4; v[n - 1] == 0U; n--);
+        m = 4;
 
-        /* q_right = (lua_pcg_u128) UINT64_MAX */
-        q_right = lua_pcg_u128_lh(lua_pcg_u64_lh(0xFFFFFFFF, 0xFFFFFFFF), lua_pcg_u64_lh(0U, 0U));
-
-        do
+        for (i = 0; i < 4; i++)
         {
-            /* _q = (q_left + q_right) >> 1U */
-            _q = lua_pcg_u128_rsh(lua_pcg_u128_sum(q_left, q_right), 1U);
-
-            /* qb = _q * _b */
-            qb = lua_pcg_u128_mul(_q, _b);
+            qw[i] = 0U;
+            rw[i] = 0U;
+        }
 
-            /* qb == _a */
-            if (lua_pcg_u128_eq(qb, _a)) /* found an exact divison (a = q * b) */
+        if (n == 1) /* short division by a single word */
+        {
+            t = 0U;
+            for (j = m - 1; j >= 0; j--)
             {
-                q_left = _q;
-
-                /* q_right = _q + ((lua_pcg_u128) 1U) */
-                q_right = lua_pcg_u128_sum(_q, lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U)));
-
-                /* *q = (lua_pcg_u64) _q */
-                *q = lua_pcg_u128_cast_to_u64(_q);
+                p = (t << 16U) | u[j];
+                qw[j] = p / v[0];
+                t = p - qw[j] * v[0];
+            }
+            rw[0] = t;
+        }
+        else
+        {
+            /* normalize a and b */
+            for (s = 0U; (v[n - 1] & (((lua_pcg_u32)0x8000U) >> s)) == 0U; s++);
 
-                /* *r = (lua_pcg_u64) 0U */
-                *r = lua_pcg_u64_lh(0U, 0U);
+            for (i = n - 1; i > 0; i--)
+            {
+                vn[i] = lua_pcg_u16_cast((v[i] << s) | (v[i - 1] >> (16U - s)));
+            }
+            vn[0] = lua_pcg_u16_cast(v[0] << s);
 
-                /* set q and r as found */
-                found = 1;
+            un[m] = u[m - 1] >> (16U - s);
+            for (i = m - 1; i > 0; i--)
+            {
+                un[i] = lua_pcg_u16_cast((u[i] << s) | (u[i - 1] >> (16U - s)));
             }
-            /* qb < _a */
-            else if (lua_pcg_u128_lt(qb, _a))
+            un[0] = lua_pcg_u16_cast(u[0] << s);
+
+            for (j = m - n; j >= 0; j--)
             {
-                /* _a < qb + _b */
-                if (lua_pcg_u128_lt(_a, lua_pcg_u128_sum(qb, _b))) /* found a maximum q such that q * b < a */
-                {
-                    q_left = _q;
+                /* estimate qhat = (un[j + n] * 2^16 + un[j + n - 1]) / vn[n - 1] */
+                p = (un[j + n] << 16U) | un[j + n - 1];
+                qhat = p / vn[n - 1];
+                rhat = p - qhat * vn[n - 1];
 
-                    /* q_right = _q + ((lua_pcg_u128) 1U) */
-                    q_right = lua_pcg_u128_sum(_q, lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U)));
+                while (qhat > 0xFFFFU || qhat * vn[n - 2] > ((rhat << 16U) | un[j + n - 2]))
+                {
+                    qhat--;
+                    rhat += vn[n - 1];
+                    if (rhat > 0xFFFFU)
+                    {
+                        break;
+                    }
+                }
 
-                    /* *q = (lua_pcg_u64) _q */
-                    *q = lua_pcg_u128_cast_to_u64(_q);
+                /* un[j..(j + n)] -= qhat * vn[0..(n - 1)] */
+                carry = 0U;
+                borrow = 0U;
+                for (i = 0; i < n; i++)
+                {
+                    p = qhat * vn[i] + carry;
+                    carry = p >> 16U;
+                    t = un[i + j] + 0x10000U - lua_pcg_u16_cast(p) - borrow;
+                    un[i + j] = lua_pcg_u16_cast(t);
+                    borrow = (t > 0xFFFFU) ? 0U : 1U;
+                }
+                t = un[j + n] + 0x10000U - carry - borrow;
+                un[j + n] = lua_pcg_u16_cast(t);
 
-                    /* *r = (lua_pcg_u64) (_a - qb) */
-                    *r = lua_pcg_u128_cast_to_u64(lua_pcg_u128_subtraction(_a, qb));
+                qw[j] = qhat;
 
-                    /* set q and r as found */
-                    found = 1;
-                }
-                else
+                if (t <= 0xFFFFU) /* qhat was one unit too large, so add vn back */
                 {
-                    q_left = _q;
+                    qw[j]--;
+                    carry = 0U;
+                    for (i = 0; i < n; i++)
+                    {
+                        t = un[i + j] + vn[i] + carry;
+                        un[i + j] = lua_pcg_u16_cast(t);
+                        carry = t >> 16U;
+                    }
+                    un[j + n] = lua_pcg_u16_cast(un[j + n] + carry);
                 }
             }
-            else /* if (qb > a) */
+
+            /* unnormalize the remainder */
+            for (i = 0; i < n; i++)
             {
-                q_right = _q;
+                rw[i] = lua_pcg_u16_cast((un[i] >> s) | (un[i + 1] << (16U - s)));
             }
         }
-        while (!found);
+
+        *q = lua_pcg_u64_lh(lua_pcg_u32_lh(qw[0], qw[1]), lua_pcg_u32_lh(qw[2], qw[3]));
+        *r = lua_pcg_u64_lh(lua_pcg_u32_lh(rw[0], rw[1]), lua_pcg_u32_lh(rw[2], rw[3]));
     }
 
     return res;
@@ -1064,12 +1087,30 @@ static int lua_pcg_u64_div(lua_pcg_u64 a, lua_pcg_u64 b, lua_pcg_u64 *q, lua_pcg
 #define lua_pcg_u64_lsh(v,n) (lua_pcg_u64_cast((v)<<(n)))
 #define lua_pcg_u64_rsh(v,n) (lua_pcg_u64_cast((v)>>(n)))
 #define lua_pcg_u64_bor(a,b) (lua_pcg_u64_cast((a)|(b)))
+#define lua_pcg_u64_band(a,b) (lua_pcg_u64_cast((a)&(b)))
+#define lua_pcg_u64_eq(a,b) ((a)==(b))
+#define lua_pcg_u64_subtraction(a,b) (lua_pcg_u64_cast((a)-(b)))
+#ifndef lua_pcg_u64_sum
+#define lua_pcg_u64_sum(a,b) (lua_pcg_u64_cast((a)+(b)))
+#endif
+#ifndef lua_pcg_u64_mul
+#define lua_pcg_u64_mul(a,b) (lua_pcg_u64_cast(((lua_pcg_u64)a)*((lua_pcg_u64)b)))
+#endif
+#ifndef lua_pcg_u64_bnot
+#define lua_pcg_u64_bnot(v) (lua_pcg_u64_cast(~((lua_pcg_u64)v)))
+#endif
+#ifndef lua_pcg_u32_mul_ex
+#define lua_pcg_u32_mul_ex(a,b) (lua_pcg_u64_cast(((lua_pcg_u64)a)*((lua_pcg_u64)b)))
+#endif
 #endif
 
 #ifndef LUA_PCG_U128_EMULATED
 #define lua_pcg_u128_lsh(v,n) (((lua_pcg_u128)v)<<(n))
 #define lua_pcg_u128_rsh(v,n) (((lua_pcg_u128)v)>>(n))
 #define lua_pcg_u128_bor(a,b) (((lua_pcg_u128)a)|((lua_pcg_u128)b))
+#define lua_pcg_u128_sum(a,b) (((lua_pcg_u128)a)+((lua_pcg_u128)b))
+#define lua_pcg_u128_mul(a,b) (((lua_pcg_u128)a)*((lua_pcg_u128)b))
+#define lua_pcg_u128_bnot(v) (~((lua_pcg_u128)v))
 #define lua_pcg_u128_cast_to_u8(v) (lua_pcg_u8_cast((v)))
 #define lua_pcg_u128_cast_to_u16(v) (lua_pcg_u16_cast((v)))
 #define lua_pcg_u128_cast_to_u32(v) (lua_pcg_u32_cast((v)))
@@ -1084,25 +1125,21 @@ static int lua_pcg_u64_div(lua_pcg_u64 a, lua_pcg_u64 b, lua_pcg_u64 *q, lua_pcg
 #define lua_pcg_table_length lua_rawlen
 #endif
 
-static int lua_pcg_lua_Integer_has_32bit()
-{
-    #if LUA_VERSION_NUM < 503
-    /* use size_t as a kind of "unsigned ptrdiff_t" */
-    return (((((size_t)(~(size_t)0)) >> 15) >> 15) >= 3) ? 1 : 0;
-    #else
-    return (((((lua_Unsigned)(~(lua_Unsigned)0)) >> 15) >> 15) >= 3) ? 1 : 0;
-    #endif
-}
-
-static int lua_pcg_lua_Integer_has_64bit()
-{
-    #if LUA_VERSION_NUM < 503
-    /* use size_t as a kind of "unsigned ptrdiff_t" */
-    return (((((((size_t)(~(size_t)0)) >> 15) >> 15) >> 15) >> 15) >= 0xF) ? 1 : 0;
-    #else
-    return (((((((lua_Unsigned)(~(lua_Unsigned)0)) >> 15) >> 15) >> 15) >> 15) >= 0xF) ? 1 : 0;
-    #endif
-}
+/*
+** tells whether lua_Integer holds at least 32 (or 64) bits.
+** 
+** Note: these are constant expressions, such that
+** the probes are folded at compile time instead
+** of being evaluated on every call of the hot paths.
+*/
+#if LUA_VERSION_NUM < 503
+/* use size_t as a kind of "unsigned ptrdiff_t" */
+#define lua_pcg_lua_Integer_has_32bit() ((((((size_t)(~(size_t)0)) >> 15) >> 15) >= 3) ? 1 : 0)
+#define lua_pcg_lua_Integer_has_64bit() ((((((((size_t)(~(size_t)0)) >> 15) >> 15) >> 15) >> 15) >= 0xF) ? 1 : 0)
+#else
+#define lua_pcg_lua_Integer_has_32bit() ((((((lua_Unsigned)(~(lua_Unsigned)0)) >> 15) >> 15) >= 3) ? 1 : 0)
+#define lua_pcg_lua_Integer_has_64bit() ((((((((lua_Unsigned)(~(lua_Unsigned)0)) >> 15) >> 15) >> 15) >> 15) >= 0xF) ? 1 : 0)
+#endif
 
 #if LUA_VERSION_NUM < 503
 static int lua_pcg_aux_isinteger(lua_State *L, int idx)
@@ -1119,8 +1156,36 @@ static int lua_pcg_aux_isinteger(lua_State *L, int idx)
 #define lua_pcg_aux_isinteger lua_isinteger
 #endif
 
+/*
+** type of the keys accepted by
+** lua_rawgeti / lua_rawseti
+*/
+#if LUA_VERSION_NUM < 503
+typedef int lua_pcg_table_index;
+#define LUA_PCG_TABLE_INDEX_MAX INT_MAX
+#else
+typedef lua_Integer lua_pcg_table_index;
+#define LUA_PCG_TABLE_INDEX_MAX LUA_MAXINTEGER
+#endif
+
 /* end of utility methods to bind Lua functions */
 
+/*
+** macros to initialize static lua_pcg_u64 and lua_pcg_u128
+** tables from 32-bit words (least significant word first)
+*/
+#ifdef LUA_PCG_U64_EMULATED
+#define LUA_PCG_U64_INITIALIZER(w0,w1) {(w0), (w1)}
+#else
+#define LUA_PCG_U64_INITIALIZER(w0,w1) lua_pcg_u64_lh(w0, w1)
+#endif
+
+#ifdef LUA_PCG_U128_EMULATED
+#define LUA_PCG_U128_INITIALIZER(w0,w1,w2,w3) {LUA_PCG_U64_INITIALIZER(w0, w1), LUA_PCG_U64_INITIALIZER(w2, w3)}
+#else
+#define LUA_PCG_U128_INITIALIZER(w0,w1,w2,w3) lua_pcg_u128_lh(lua_pcg_u64_lh(w0, w1), lua_pcg_u64_lh(w2, w3))
+#endif
+
 /*
 ** *****************************************************
 ** *****************************************************
@@ -1146,6 +1211,160 @@ struct lua_pcg_state_setseq_64
 */
 #define LUA_PCG_DEFAULT_MULTIPLIER_64 (lua_pcg_u64_lh(0x4C957F2D,0x5851F42D))
 
+/*
+** Jump tables to advance the LCG with the default multiplier M:
+** stepping 2^i times maps state to
+** 
+**     state * M^(2^i) + inc * (1 + M + M^2 + ... + M^(2^i - 1))
+** 
+** where lua_pcg_jump_mult_64[i] holds M^(2^i), and
+** lua_pcg_jump_plus_64[i] holds the sum of powers of M,
+** which does not depend on the increment (inc) of the rng.
+** 
+** Both tables are constant, such that Lua states on
+** different threads can share them. They were generated
+** offline with exact integer arithmetic (modulo 2^64) from
+** 
+**     mult[0] = M, plus[0] = 1,
+**     plus[i] = (mult[i - 1] + 1) * plus[i - 1],
+**     mult[i] = mult[i - 1] * mult[i - 1].
+*/
+static const lua_pcg_u64 lua_pcg_jump_mult_64[64] =
+{
+    LUA_PCG_U64_INITIALIZER(0x4C957F2D, 0x5851F42D),
+    LUA_PCG_U64_INITIALIZER(0x018FADE9, 0x685F98A2),
+    LUA_PCG_U64_INITIALIZER(0x9272BE11, 0xFB4D3AE3),
+    LUA_PCG_U64_INITIALIZER(0x38413D21, 0xB59DDA5F),
+    LUA_PCG_U64_INITIALIZER(0x895ABE41, 0x8D5E2DDC),
+    LUA_PCG_U64_INITIALIZER(0xE5188C81, 0x96481983),
+    LUA_PCG_U64_INITIALIZER(0x6F4D5901, 0x4425EBBF),
+    LUA_PCG_U64_INITIALIZER(0x878BB201, 0x8980D00B),
+    LUA_PCG_U64_INITIALIZER(0xD6DB6401, 0x02078E0D),
+    LUA_PCG_U64_INITIALIZER(0xECC6C801, 0x659ACB4F),
+    LUA_PCG_U64_INITIALIZER(0xD5CD9001, 0xAA1421B9),
+    LUA_PCG_U64_INITIALIZER(0x9C9B2001, 0x88F21A23),
+    LUA_PCG_U64_INITIALIZER(0xFD364001, 0x469C6146),
+    LUA_PCG_U64_INITIALIZER(0x0A6C8001, 0x1DD8088D),
+    LUA_PCG_U64_INITIALIZER(0x54D90001, 0x7FA1B916),
+    LUA_PCG_U64_INITIALIZER(0xA9B20001, 0x52AE921D),
+    LUA_PCG_U64_INITIALIZER(0x53640001, 0x902DA3FF),
+    LUA_PCG_U64_INITIALIZER(0xA6C80001, 0xB4BD470E),
+    LUA_PCG_U64_INITIALIZER(0x4D900001, 0x04028A5D),
+    LUA_PCG_U64_INITIALIZER(0x9B200001, 0xBA2505BA),
+    LUA_PCG_U64_INITIALIZER(0x36400001, 0x7CC9CF75),
+    LUA_PCG_U64_INITIALIZER(0x6C800001, 0x1B92AEEA),
+    LUA_PCG_U64_INITIALIZER(0xD9000001, 0xBF219DD4),
+    LUA_PCG_U64_INITIALIZER(0xB2000001, 0x9E343BA9),
+    LUA_PCG_U64_INITIALIZER(0x64000001, 0xBC2C7753),
+    LUA_PCG_U64_INITIALIZER(0xC8000001, 0x7768EEA6),
+    LUA_PCG_U64_INITIALIZER(0x90000001, 0xEB11DD4D),
+    LUA_PCG_U64_INITIALIZER(0x20000001, 0xC723BA9B),
+    LUA_PCG_U64_INITIALIZER(0x40000001, 0x52477536),
+    LUA_PCG_U64_INITIALIZER(0x80000001, 0xB48EEA6C),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xA91DD4D9),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x523BA9B2),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xA4775364),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x48EEA6C8),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x91DD4D90),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x23BA9B20),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x47753640),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x8EEA6C80),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x1DD4D900),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x3BA9B200),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x77536400),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xEEA6C800),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xDD4D9000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xBA9B2000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x75364000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xEA6C8000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xD4D90000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xA9B20000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x53640000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xA6C80000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x4D900000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x9B200000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x36400000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x6C800000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xD9000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xB2000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x64000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0xC8000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x90000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x20000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x40000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x80000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x00000000),
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x00000000)
+};
+
+static const lua_pcg_u64 lua_pcg_jump_plus_64[64] =
+{
+    LUA_PCG_U64_INITIALIZER(0x00000001, 0x00000000),
+    LUA_PCG_U64_INITIALIZER(0x4C957F2E, 0x5851F42D),
+    LUA_PCG_U64_INITIALIZER(0x404A560C, 0xCBB5F646),
+    LUA_PCG_U64_INITIALIZER(0xDA6EF4D8, 0x9A8B7F78),
+    LUA_PCG_U64_INITIALIZER(0xDDEBFCB0, 0xFD8341FC),
+    LUA_PCG_U64_INITIALIZER(0x6241C560, 0x37521657),
+    LUA_PCG_U64_INITIALIZER(0x3E56BAC0, 0xB5EB8DF5),
+    LUA_PCG_U64_INITIALIZER(0x0F5A3580, 0x76E04EE6),
+    LUA_PCG_U64_INITIALIZER(0x64676B00, 0x41F7C92A),
+    LUA_PCG_U64_INITIALIZER(0xB79AD600, 0x3950E877),
+    LUA_PCG_U64_INITIALIZER(0xEA65AC00, 0xFE942169),
+    LUA_PCG_U64_INITIALIZER(0xC18B5800, 0x20706E33),
+    LUA_PCG_U64_INITIALIZER(0x3616B000, 0x5EEB7597),
+    LUA_PCG_U64_INITIALIZER(0x382D6000, 0x7C7AAD6D),
+    LUA_PCG_U64_INITIALIZER(0xA05AC000, 0x19EF4FD5),
+    LUA_PCG_U64_INITIALIZER(0x00B58000, 0x151DD398),
+    LUA_PCG_U64_INITIALIZER(0x016B0000, 0x39F376E3),
+    LUA_PCG_U64_INITIALIZER(0x02D60000, 0x089E2C92),
+    LUA_PCG_U64_INITIALIZER(0x05AC0000, 0x12D95454),
+    LUA_PCG_U64_INITIALIZER(0x0B580000, 0xA2269568),
+    LUA_PCG_U64_INITIALIZER(0x16B00000, 0xE61CDDD0),
+    LUA_PCG_U64_INITIALIZER(0x2D600000, 0xD37887A0),
+    LUA_PCG_U64_INITIALIZER(0x5AC00000, 0xC3EC3F40),
+    LUA_PCG_U64_INITIALIZER(0xB5800000, 0xFBC53E80),
+    LUA_PCG_U64_INITIALIZER(0x6B000000, 0xC73D7D01),
+    LUA_PCG_U64_INITIALIZER(0xD6000000, 0xCD46FA02),
+    LUA_PCG_U64_INITIALIZER(0xAC000000, 0x95BDF405),
+    LUA_PCG_U64_INITIALIZER(0x58000000, 0x183BE80B),
+    LUA_PCG_U64_INITIALIZER(0xB0000000, 0xE377D016),
+    LUA_PCG_U64_INITIALIZER(0x60000000, 0x92EFA02D),
+    LUA_PCG_U64_INITIALIZER(0xC0000000, 0x55DF405A),
+    LUA_PCG_U64_INITIALIZER(0x80000000, 0x6BBE80B5),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xD77D016B),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xAEFA02D6),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x5DF405AC),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xBBE80B58),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x77D016B0),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xEFA02D60),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xDF405AC0),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xBE80B580),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x7D016B00),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xFA02D600),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xF405AC00),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xE80B5800),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xD016B000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xA02D6000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x405AC000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x80B58000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x016B0000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x02D60000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x05AC0000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x0B580000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x16B00000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x2D600000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x5AC00000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xB5800000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x6B000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xD6000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xAC000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x58000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xB0000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x60000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0xC0000000),
+    LUA_PCG_U64_INITIALIZER(0x00000000, 0x80000000)
+};
+
 static lua_pcg_u32 lua_pcg_rotr_32(lua_pcg_u32 value, unsigned int rot)
 {
 #if (defined(_MSC_VER) && _MSC_VER >= 1100)
@@ -1202,12 +1421,15 @@ static void lua_pcg_setseq_64_srandom_r(struct lua_pcg_state_setseq_64 *rng, lua
     lua_pcg_setseq_64_step_r(rng);
 }
 
-static lua_pcg_u64 lua_pcg_advance_lcg_64(lua_pcg_u64 state, lua_pcg_u64 delta, lua_pcg_u64 cur_mult, lua_pcg_u64 cur_plus)
+/*
+** advances state by delta steps through the jump tables,
+** multiplying only for the set bits of delta
+*/
+static lua_pcg_u64 lua_pcg_advance_lcg_64(lua_pcg_u64 state, lua_pcg_u64 delta, lua_pcg_u64 cur_plus)
 {
-    /* 0U */
-    lua_pcg_u64 zero = lua_pcg_u64_lh(0U, 0U);
-    /* 1U */
-    lua_pcg_u64 one = lua_pcg_u64_lh(1U, 0U);
+    unsigned int i;
+    unsigned int w;
+    lua_pcg_u32 word;
 
     /* acc_mult = 1U */
     lua_pcg_u64 acc_mult = lua_pcg_u64_lh(1U, 0U);
@@ -1215,35 +1437,24 @@ static lua_pcg_u64 lua_pcg_advance_lcg_64(lua_pcg_u64 state, lua_pcg_u64 delta,
     /* acc_plus = 0U */
     lua_pcg_u64 acc_plus = lua_pcg_u64_lh(0U, 0U);
 
-    lua_pcg_u64 _delta = delta;
-    lua_pcg_u64 _cur_mult = cur_mult;
-    lua_pcg_u64 _cur_plus = cur_plus;
-
-    /* while (delta > 0) */
-    while (lua_pcg_u64_gt(_delta, zero))
+    for (w = 0; w < 2; w++)
     {
-        /* if (delta & 1) */
-        if (lua_pcg_u64_neq(lua_pcg_u64_band(_delta, one), zero))
+        word = w == 0 ? delta.low : delta.high;
+        for (i = 32 * w; word != 0U; i++, word >>= 1)
         {
-            /* acc_mult *= cur_mult */
-            acc_mult = lua_pcg_u64_mul(acc_mult, _cur_mult);
+            if (word & 1U)
+            {
+                /* acc_mult *= mult[i] */
+                acc_mult = lua_pcg_u64_mul(acc_mult, lua_pcg_jump_mult_64[i]);
 
-            /* acc_plus = acc_plus * cur_mult + cur_plus */
-            acc_plus = lua_pcg_u64_sum(lua_pcg_u64_mul(acc_plus, _cur_mult), _cur_plus);
+                /* acc_plus = acc_plus * mult[i] + plus[i] */
+                acc_plus = lua_pcg_u64_sum(lua_pcg_u64_mul(acc_plus, lua_pcg_jump_mult_64[i]), lua_pcg_jump_plus_64[i]);
+            }
         }
-
-        /* cur_plus = (cur_mult + 1) * cur_plus */
-        _cur_plus = lua_pcg_u64_mul(lua_pcg_u64_sum(_cur_mult, one), _cur_plus);
-
-        /* cur_mult *= cur_mult */
-        _cur_mult = lua_pcg_u64_mul(_cur_mult, _cur_mult);
-
-        /* delta /= 2 which is equal to delta >>= 1 */
-        _delta = lua_pcg_u64_rsh(_delta, 1);
     }
 
-    /* return acc_mult * state + acc_plus */
-    return lua_pcg_u64_sum(lua_pcg_u64_mul(acc_mult, state), acc_plus);
+    /* return acc_mult * state + acc_plus * cur_plus */
+    return lua_pcg_u64_sum(lua_pcg_u64_mul(acc_mult, state), lua_pcg_u64_mul(acc_plus, cur_plus));
 }
 
 #else
@@ -1274,63 +1485,133 @@ static void lua_pcg_setseq_64_srandom_r(struct lua_pcg_state_setseq_64 *rng, lua
     lua_pcg_setseq_64_step_r(rng);
 }
 
-static lua_pcg_u64 lua_pcg_advance_lcg_64(lua_pcg_u64 state, lua_pcg_u64 delta, lua_pcg_u64 cur_mult, lua_pcg_u64 cur_plus)
+/*
+** advances state by delta steps through the jump tables,
+** multiplying only for the set bits of delta
+*/
+static lua_pcg_u64 lua_pcg_advance_lcg_64(lua_pcg_u64 state, lua_pcg_u64 delta, lua_pcg_u64 cur_plus)
 {
+    unsigned int i;
     lua_pcg_u64 acc_mult = 1U;
     lua_pcg_u64 acc_plus = 0U;
 
-    lua_pcg_u64 _delta = delta;
-    lua_pcg_u64 _cur_mult = cur_mult;
-    lua_pcg_u64 _cur_plus = cur_plus;
-
-    while (_delta > 0U)
+    for (i = 0; delta > 0U; i++, delta >>= 1U)
     {
-        if (_delta & 1U)
+        if (delta & 1U)
         {
-            acc_mult = lua_pcg_u64_cast(acc_mult * _cur_mult);
-            acc_plus = lua_pcg_u64_cast(acc_plus * _cur_mult + _cur_plus);
+            acc_mult = lua_pcg_u64_cast(acc_mult * lua_pcg_jump_mult_64[i]);
+            acc_plus = lua_pcg_u64_cast(acc_plus * lua_pcg_jump_mult_64[i] + lua_pcg_jump_plus_64[i]);
         }
-        _cur_plus = lua_pcg_u64_cast((_cur_mult + 1U) * _cur_plus);
-        _cur_mult = lua_pcg_u64_cast(_cur_mult * _cur_mult);
-        _delta >>= 1U;
     }
 
-    return lua_pcg_u64_cast(acc_mult * state + acc_plus);
+    return lua_pcg_u64_cast(acc_mult * state + acc_plus * cur_plus);
 }
 
 #endif
 
 static void lua_pcg_setseq_64_advance_r(struct lua_pcg_state_setseq_64 *rng, lua_pcg_u64 delta)
 {
-    rng->state = lua_pcg_advance_lcg_64(rng->state, delta, LUA_PCG_DEFAULT_MULTIPLIER_64, rng->inc);
+    rng->state = lua_pcg_advance_lcg_64(rng->state, delta, rng->inc);
 }
 
+/*
+** Generates a value in the range [0, bound)
+** through Lemire's nearly divisionless method:
+** the 32-bit value r is multiplied by bound,
+** and the upper 32 bits of the 64-bit product
+** are the result. The lower 32 bits of the product
+** tell whether r must be rejected to avoid bias,
+** such that the threshold (2^32 - bound) % bound,
+** which requires a division, is only computed
+** when the lower 32 bits are less than bound.
+** 
+** When bound is a power of two, the lower
+** bits of r are returned without rejection.
+*/
 static lua_pcg_u32 lua_pcg_setseq_64_xsh_rr_32_boundedrand_r(struct lua_pcg_state_setseq_64 *rng, lua_pcg_u32 bound)
 {
-    lua_pcg_u32 r;
+    lua_pcg_u64 m;
+    lua_pcg_u32 low, threshold;
     lua_pcg_u32 safebound = lua_pcg_u32_cast(bound);
+
+    if ((safebound & (safebound - 1U)) == 0U)
+    {
+        return (lua_pcg_setseq_64_xsh_rr_32_random_r(rng) & (safebound - 1U));
+    }
+
+    m = lua_pcg_u32_mul_ex(lua_pcg_setseq_64_xsh_rr_32_random_r(rng), safebound);
+    low = lua_pcg_u64_cast_to_u32(m);
+
+    if (low < safebound)
+    {
 #if (defined(_MSC_VER) && _MSC_VER >= 1100)
 #pragma warning(push)
 #pragma warning(disable:4146)
 #endif
-    lua_pcg_u32 threshold = (-safebound) % safebound;
+        threshold = lua_pcg_u32_cast(-safebound) % safebound;
 #if (defined(_MSC_VER) && _MSC_VER >= 1100)
 #pragma warning(pop)
 #endif
 
-    do
+        while (low < threshold)
+        {
+            m = lua_pcg_u32_mul_ex(lua_pcg_setseq_64_xsh_rr_32_random_r(rng), safebound);
+            low = lua_pcg_u64_cast_to_u32(m);
+        }
+    }
+
+    return lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(m, 32U));
+}
+
+/*
+** Computes ahead of time the threshold (2^32 - bound) % bound
+** used by lua_pcg_setseq_64_xsh_rr_32_boundedrand_r
+** to reject biased values, for repeated draws on the same bound.
+*/
+static lua_pcg_u32 lua_pcg_setseq_64_xsh_rr_32_threshold(lua_pcg_u32 bound)
+{
+    lua_pcg_u32 safebound = lua_pcg_u32_cast(bound);
+
+#if (defined(_MSC_VER) && _MSC_VER >= 1100)
+#pragma warning(push)
+#pragma warning(disable:4146)
+#endif
+    return lua_pcg_u32_cast(-safebound) % safebound;
+#if (defined(_MSC_VER) && _MSC_VER >= 1100)
+#pragma warning(pop)
+#endif
+}
+
+/*
+** Same as lua_pcg_setseq_64_xsh_rr_32_boundedrand_r,
+** but taking the threshold computed by
+** lua_pcg_setseq_64_xsh_rr_32_threshold.
+** Both functions draw exactly the same values.
+*/
+static lua_pcg_u32 lua_pcg_setseq_64_xsh_rr_32_thresholdrand_r(struct lua_pcg_state_setseq_64 *rng, lua_pcg_u32 bound, lua_pcg_u32 threshold)
+{
+    lua_pcg_u64 m;
+    lua_pcg_u32 safebound = lua_pcg_u32_cast(bound);
+
+    if ((safebound & (safebound - 1U)) == 0U)
     {
-        r = lua_pcg_setseq_64_xsh_rr_32_random_r(rng);
+        return (lua_pcg_setseq_64_xsh_rr_32_random_r(rng) & (safebound - 1U));
     }
-    while (r < threshold);
 
-    return (r % safebound);
+    do
+    {
+        m = lua_pcg_u32_mul_ex(lua_pcg_setseq_64_xsh_rr_32_random_r(rng), safebound);
+    } while (lua_pcg_u64_cast_to_u32(m) < threshold);
+
+    return lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(m, 32U));
 }
 
 typedef struct lua_pcg_state_setseq_64 lua_pcg32_random_t;
 #define lua_pcg32_random_r lua_pcg_setseq_64_xsh_rr_32_random_r
 #define lua_pcg32_srandom_r lua_pcg_setseq_64_srandom_r
 #define lua_pcg32_boundedrand_r lua_pcg_setseq_64_xsh_rr_32_boundedrand_r
+#define lua_pcg32_threshold lua_pcg_setseq_64_xsh_rr_32_threshold
+#define lua_pcg32_thresholdrand_r lua_pcg_setseq_64_xsh_rr_32_thresholdrand_r
 #define lua_pcg32_advance_r lua_pcg_setseq_64_advance_r
 
 /*
@@ -1359,6 +1640,275 @@ struct lua_pcg_state_setseq_128
 */
 #define LUA_PCG_DEFAULT_MULTIPLIER_128 (lua_pcg_u128_lh(lua_pcg_u64_lh(0x9FCCF645,0x4385DF64), lua_pcg_u64_lh(0x1FC65DA4,0x2360ED05)))
 
+/*
+** Jump tables to advance the LCG with the default multiplier,
+** generated offline modulo 2^128 (see lua_pcg_jump_mult_64
+** and lua_pcg_jump_plus_64)
+*/
+static const lua_pcg_u128 lua_pcg_jump_mult_128[128] =
+{
+    LUA_PCG_U128_INITIALIZER(0x9FCCF645, 0x4385DF64, 0x1FC65DA4, 0x2360ED05),
+    LUA_PCG_U128_INITIALIZER(0x20E0AE99, 0x529ED9EB, 0xDF69743C, 0x17BCE35B),
+    LUA_PCG_U128_INITIALIZER(0x42D45771, 0xD194DFBE, 0x27DB7A9B, 0xF4DD4173),
+    LUA_PCG_U128_INITIALIZER(0x3505FFE1, 0xD1A2D6F3, 0x7A7898F6, 0x6347AF77),
+    LUA_PCG_U128_INITIALIZER(0x288C03C1, 0xF6EF6D3D, 0x3B315F84, 0xB6A4239F),
+    LUA_PCG_U128_INITIALIZER(0x6B261781, 0x82B631BA, 0xD1CB0CD1, 0x2C82901A),
+    LUA_PCG_U128_INITIALIZER(0xD2746F01, 0xE49E66C4, 0x8288676E, 0xDAB03F98),
+    LUA_PCG_U128_INITIALIZER(0x6D09DE01, 0x84FE009A, 0x1D86CF56, 0x60216733),
+    LUA_PCG_U128_INITIALIZER(0x3697BC01, 0xF04C80A2, 0x4D95B058, 0x61ECB5C2),
+    LUA_PCG_U128_INITIALIZER(0xBF3F7801, 0x60474E83, 0x654C28AA, 0x4A5C31E0),
+    LUA_PCG_U128_INITIALIZER(0xC6BEF001, 0x478331D3, 0x54FBECE1, 0xAE4F079D),
+    LUA_PCG_U128_INITIALIZER(0xAE7DE001, 0x7FF1ED50, 0x30C7CB92, 0x101B8CB8),
+    LUA_PCG_U128_INITIALIZER(0xE0FBC001, 0x563F3505, 0x056B00E7, 0xF54A27FC),
+    LUA_PCG_U128_INITIALIZER(0xD1F78001, 0xF98D719D, 0xA833D201, 0xDF8A6FC1),
+    LUA_PCG_U128_INITIALIZER(0xE3EF0001, 0xA7E3F183, 0x5F101A4E, 0x5480A501),
+    LUA_PCG_U128_INITIALIZER(0xC7DE0001, 0x5F539C28, 0x76E5D792, 0xA498509E),
+    LUA_PCG_U128_INITIALIZER(0x8FBC0001, 0x60121CD5, 0xB10DC72E, 0x0798A3D8),
+    LUA_PCG_U128_INITIALIZER(0x1F780001, 0x5FAFCBBB, 0x8EC02E66, 0x1647D1E7),
+    LUA_PCG_U128_INITIALIZER(0x3EF00001, 0x0C8DDFB6, 0x5E72BF8C, 0xA7C98228),
+    LUA_PCG_U128_INITIALIZER(0x7DE00001, 0xC5D4E06C, 0xFB8C56DB, 0x3EB78EE8),
+    LUA_PCG_U128_INITIALIZER(0xFBC00001, 0xFE8E44D8, 0x4681F2F9, 0x72D03B6F),
+    LUA_PCG_U128_INITIALIZER(0xF7800001, 0xC8AE99B1, 0x4F502C9B, 0xEA85F81E),
+    LUA_PCG_U128_INITIALIZER(0xEF000001, 0xBFA57363, 0xB08B00C6, 0x629C320D),
+    LUA_PCG_U128_INITIALIZER(0xDE000001, 0x386BE6C7, 0x268D074A, 0xC5C4B9CE),
+    LUA_PCG_U128_INITIALIZER(0xBC000001, 0x555BCD8F, 0xD1596187, 0xF30BBBBE),
+    LUA_PCG_U128_INITIALIZER(0x78000001, 0x3CC79B1F, 0x26C9EEDA, 0x4A1000FB),
+    LUA_PCG_U128_INITIALIZER(0xF0000001, 0xC1CF363E, 0xF6BF8CE2, 0x89FB5307),
+    LUA_PCG_U128_INITIALIZER(0xE0000001, 0xA49E6C7D, 0x58A5D67E, 0x830B7B33),
+    LUA_PCG_U128_INITIALIZER(0xC0000001, 0xCD3CD8FB, 0x91A69FE1, 0xFD8A51DA),
+    LUA_PCG_U128_INITIALIZER(0x80000001, 0xAA79B1F7, 0x42B90B55, 0x901A48B6),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x94F363EF, 0xF32144F3, 0x118CDEFD),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x29E6C7DE, 0x1CFF4308, 0x0A88C0A9),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x53CD8FBC, 0x14F16A94, 0x433BEF43),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xA79B1F78, 0x95AE6738, 0xC294B029),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x4F363EF0, 0xDA8B16B1, 0x913575E0),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x9E6C7DE0, 0x71CF4E62, 0x2F61B9F8),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x3CD8FBC0, 0xD68320C5, 0x78D26CCB),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x79B1F780, 0x7898518A, 0x8B7EBD03),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xF363EF00, 0x1F78E314, 0x0B5507B6),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xE6C7DE00, 0xF812C629, 0x4F884628),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xCD8FBC00, 0xD4A98C53, 0xBE896744),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x9B1F7800, 0x3B6318A7, 0xDAF63A55),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x363EF000, 0xBF06314F, 0x2D7A23D8),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x6C7DE000, 0x9F0C629E, 0x392B046A),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xD8FBC000, 0xC218C53C, 0xEB30FBB9),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xB1F78000, 0x94318A79, 0xB9CDC305),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x63EF0000, 0x686314F3, 0x014AB453),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xC7DE0000, 0xD0C629E6, 0x395221C7),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x8FBC0000, 0xA18C53CD, 0x4D972813),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x1F780000, 0x4318A79B, 0x06F9E237),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x3EF00000, 0x86314F36, 0xBD220CAE),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x7DE00000, 0x0C629E6C, 0x36FD3A5D),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xFBC00000, 0x18C53CD8, 0x60DEF8BA),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xF7800000, 0x318A79B1, 0x8D500174),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xEF000000, 0x6314F363, 0x48E842E8),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xDE000000, 0xC629E6C7, 0x4AF185D0),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xBC000000, 0x8C53CD8F, 0x7A670BA1),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x78000000, 0x18A79B1F, 0x86DE1743),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xF0000000, 0x314F363E, 0x55FC2E86),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xE0000000, 0x629E6C7D, 0xCCF85D0C),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0xC0000000, 0xC53CD8FB, 0x1DF0BA18),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x80000000, 0x8A79B1F7, 0x4BE17431),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x14F363EF, 0xD7C2E863),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x29E6C7DE, 0xAF85D0C6),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x53CD8FBC, 0x5F0BA18C),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xA79B1F78, 0xBE174318),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x4F363EF0, 0x7C2E8631),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x9E6C7DE0, 0xF85D0C62),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x3CD8FBC0, 0xF0BA18C5),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x79B1F780, 0xE174318A),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xF363EF00, 0xC2E86314),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xE6C7DE00, 0x85D0C629),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xCD8FBC00, 0x0BA18C53),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x9B1F7800, 0x174318A7),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x363EF000, 0x2E86314F),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x6C7DE000, 0x5D0C629E),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xD8FBC000, 0xBA18C53C),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xB1F78000, 0x74318A79),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x63EF0000, 0xE86314F3),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xC7DE0000, 0xD0C629E6),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x8FBC0000, 0xA18C53CD),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x1F780000, 0x4318A79B),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x3EF00000, 0x86314F36),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x7DE00000, 0x0C629E6C),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xFBC00000, 0x18C53CD8),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xF7800000, 0x318A79B1),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xEF000000, 0x6314F363),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xDE000000, 0xC629E6C7),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xBC000000, 0x8C53CD8F),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x78000000, 0x18A79B1F),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xF0000000, 0x314F363E),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xE0000000, 0x629E6C7D),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0xC0000000, 0xC53CD8FB),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x80000000, 0x8A79B1F7),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x14F363EF),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x29E6C7DE),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x53CD8FBC),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xA79B1F78),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x4F363EF0),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x9E6C7DE0),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x3CD8FBC0),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x79B1F780),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xF363EF00),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xE6C7DE00),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xCD8FBC00),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x9B1F7800),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x363EF000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x6C7DE000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xD8FBC000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xB1F78000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x63EF0000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xC7DE0000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x8FBC0000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x1F780000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x3EF00000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x7DE00000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xFBC00000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xF7800000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xEF000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xDE000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xBC000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x78000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xF0000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xE0000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0xC0000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x80000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x00000000),
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x00000000)
+};
+
+static const lua_pcg_u128 lua_pcg_jump_plus_128[128] =
+{
+    LUA_PCG_U128_INITIALIZER(0x00000001, 0x00000000, 0x00000000, 0x00000000),
+    LUA_PCG_U128_INITIALIZER(0x9FCCF646, 0x4385DF64, 0x1FC65DA4, 0x2360ED05),
+    LUA_PCG_U128_INITIALIZER(0xADEFBA1C, 0x817FA187, 0x4B07E063, 0x610E11A1),
+    LUA_PCG_U128_INITIALIZER(0x44306478, 0x292967D1, 0x0B39425C, 0x22AB9B11),
+    LUA_PCG_U128_INITIALIZER(0x352439F0, 0xA9072151, 0x168FB143, 0x6ED699DB),
+    LUA_PCG_U128_INITIALIZER(0xE161B7E0, 0xE2DEEA36, 0xFE438D94, 0x8B144946),
+    LUA_PCG_U128_INITIALIZER(0x26647FC0, 0xDF08A33A, 0x953B44B4, 0xDB8761D6),
+    LUA_PCG_U128_INITIALIZER(0x432D3F80, 0x6F07A26F, 0x667B980D, 0x8C092058),
+    LUA_PCG_U128_INITIALIZER(0x7EEB7F00, 0xFCA794C0, 0x43BD8562, 0x199CAE22),
+    LUA_PCG_U128_INITIALIZER(0xD81AFE00, 0x27636E67, 0x03F09ACA, 0x87D1E4CE),
+    LUA_PCG_U128_INITIALIZER(0xD945FC00, 0xD185D642, 0xE08BB69A, 0x81417387),
+    LUA_PCG_U128_INITIALIZER(0x56CBF800, 0x437E6F10, 0x0DDA0F13, 0xE093F57A),
+    LUA_PCG_U128_INITIALIZER(0x3E97F000, 0xEA79AE3B, 0x30EE08F0, 0x3A0EC29F),
+    LUA_PCG_U128_INITIALIZER(0xC12FE000, 0x8022CC60, 0xD218CCA0, 0xB3716586),
+    LUA_PCG_U128_INITIALIZER(0x925FC000, 0x91C4D46A, 0xC7A9C89B, 0x25E1DE6C),
+    LUA_PCG_U128_INITIALIZER(0x64BF8000, 0x3D927779, 0xE12BF7D0, 0x4BC96EBF),
+    LUA_PCG_U128_INITIALIZER(0xC97F0000, 0x63A72983, 0xFAF08E76, 0x5D57B94A),
+    LUA_PCG_U128_INITIALIZER(0x92FE0000, 0x6C4F3D4B, 0x2DC26B7E, 0x26D2394F),
+    LUA_PCG_U128_INITIALIZER(0x25FC0000, 0x846223A7, 0x28CBA5F3, 0x092ACAF1),
+    LUA_PCG_U128_INITIALIZER(0x4BF80000, 0x75D2EB8E, 0xBD6EDB42, 0xB9FF6D21),
+    LUA_PCG_U128_INITIALIZER(0x97F00000, 0x8FE0681C, 0xEB196FF8, 0x72F64944),
+    LUA_PCG_U128_INITIALIZER(0x2FE00000, 0x30AB1439, 0x4DBBA5EF, 0xD2A8477E),
+    LUA_PCG_U128_INITIALIZER(0x5FC00000, 0xA4FF3872, 0x29496552, 0x3FEE0D4F),
+    LUA_PCG_U128_INITIALIZER(0xBF800000, 0x58A2B0E4, 0xB5533C56, 0x90C0589D),
+    LUA_PCG_U128_INITIALIZER(0x7F000000, 0xEBD661C9, 0x31689E70, 0xC96AD9DD),
+    LUA_PCG_U128_INITIALIZER(0xFE000000, 0xC1F0C392, 0x5BDCCBF2, 0x8EB88B11),
+    LUA_PCG_U128_INITIALIZER(0xFC000000, 0x2CF18725, 0x8BFF9429, 0xE5D914DD),
+    LUA_PCG_U128_INITIALIZER(0xF8000000, 0xFE230E4B, 0xE9D51960, 0x24E6DD9D),
+    LUA_PCG_U128_INITIALIZER(0xF0000000, 0x8D461C97, 0x20F1F6FC, 0x76413283),
+    LUA_PCG_U128_INITIALIZER(0xE0000000, 0x5E8C392F, 0xA682FEE3, 0x8B038003),
+    LUA_PCG_U128_INITIALIZER(0xC0000000, 0xCD18725F, 0x5B82416F, 0xF0855AFE),
+    LUA_PCG_U128_INITIALIZER(0x80000000, 0xDA30E4BF, 0xD0F59183, 0xFCD399E4),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xB461C97F, 0x09AF5D98, 0xD74683C9),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x68C392FE, 0xB26FA575, 0x98E84A87),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xD18725FC, 0xE122F3FA, 0x7A2DB8A5),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xA30E4BF8, 0xB3548C35, 0x0D50BDA5),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x461C97F0, 0x2AE3A96B, 0x3A7C9CB3),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x8C392FE0, 0x66B196D6, 0xD4953F05),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x18725FC0, 0x110C3DAD, 0x29169487),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x30E4BF80, 0x30BCBB5A, 0x5DBD82FF),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x61C97F00, 0x9C0A76B4, 0x48BC6DC2),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xC392FE00, 0x2258ED68, 0xBE7E7A96),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x8725FC00, 0xEDC1DAD1, 0xF113716F),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x0E4BF800, 0x7FC3B5A3, 0xB280D3EE),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x1C97F000, 0x90876B46, 0xA6696C17),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x392FE000, 0x650ED68C, 0x5271E919),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x725FC000, 0xDA1DAD18, 0xBB6015DB),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xE4BF8000, 0xF43B5A30, 0xD0B13A5B),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xC97F0000, 0xE876B461, 0x0926AF48),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x92FE0000, 0xD0ED68C3, 0xB15E48D5),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x25FC0000, 0xA1DAD187, 0xDF003ABB),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x4BF80000, 0x43B5A30E, 0xAF0F19B7),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x97F00000, 0x876B461C, 0x2258C46E),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x2FE00000, 0x0ED68C39, 0x559BCCDD),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x5FC00000, 0x1DAD1872, 0xEEE0A9BA),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xBF800000, 0x3B5A30E4, 0xEC659374),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x7F000000, 0x76B461C9, 0x135C26E8),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xFE000000, 0xED68C392, 0x10FC4DD0),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xFC000000, 0xDAD18725, 0xCB089BA1),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xF8000000, 0xB5A30E4B, 0x3A513743),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xF0000000, 0x6B461C97, 0x05A26E87),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xE0000000, 0xD68C392F, 0x4F44DD0E),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0xC0000000, 0xAD18725F, 0xAE89BA1D),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x80000000, 0x5A30E4BF, 0x9D13743B),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xB461C97F, 0x3A26E876),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x68C392FE, 0x744DD0ED),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xD18725FC, 0xE89BA1DA),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xA30E4BF8, 0xD13743B5),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x461C97F0, 0xA26E876B),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x8C392FE0, 0x44DD0ED6),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x18725FC0, 0x89BA1DAD),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x30E4BF80, 0x13743B5A),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x61C97F00, 0x26E876B4),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xC392FE00, 0x4DD0ED68),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x8725FC00, 0x9BA1DAD1),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x0E4BF800, 0x3743B5A3),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x1C97F000, 0x6E876B46),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x392FE000, 0xDD0ED68C),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x725FC000, 0xBA1DAD18),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xE4BF8000, 0x743B5A30),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xC97F0000, 0xE876B461),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x92FE0000, 0xD0ED68C3),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x25FC0000, 0xA1DAD187),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x4BF80000, 0x43B5A30E),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x97F00000, 0x876B461C),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x2FE00000, 0x0ED68C39),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x5FC00000, 0x1DAD1872),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xBF800000, 0x3B5A30E4),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x7F000000, 0x76B461C9),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xFE000000, 0xED68C392),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xFC000000, 0xDAD18725),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xF8000000, 0xB5A30E4B),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xF0000000, 0x6B461C97),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xE0000000, 0xD68C392F),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0xC0000000, 0xAD18725F),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x80000000, 0x5A30E4BF),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xB461C97F),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x68C392FE),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xD18725FC),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xA30E4BF8),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x461C97F0),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x8C392FE0),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x18725FC0),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x30E4BF80),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x61C97F00),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xC392FE00),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x8725FC00),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x0E4BF800),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x1C97F000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x392FE000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x725FC000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xE4BF8000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xC97F0000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x92FE0000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x25FC0000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x4BF80000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x97F00000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x2FE00000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x5FC00000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xBF800000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x7F000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xFE000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xFC000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xF8000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xF0000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xE0000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0xC0000000),
+    LUA_PCG_U128_INITIALIZER(0x00000000, 0x00000000, 0x00000000, 0x80000000)
+};
+
 #ifdef LUA_PCG_U128_EMULATED
 
 static lua_pcg_u64 lua_pcg_rotr_64(lua_pcg_u64 value, unsigned int rot)
@@ -1426,42 +1976,104 @@ static void lua_pcg_setseq_128_srandom_r(struct lua_pcg_state_setseq_128 *rng, l
     lua_pcg_setseq_128_step_r(rng);
 }
 
+/*
+** Generates a value in the range [0, bound)
+** through Lemire's nearly divisionless method
+** (see lua_pcg_setseq_64_xsh_rr_32_boundedrand_r)
+** on the 128-bit product of the 64-bit value r and bound.
+*/
 static lua_pcg_u64 lua_pcg_setseq_128_xsl_rr_64_boundedrand_r(struct lua_pcg_state_setseq_128 *rng, lua_pcg_u64 bound)
 {
-    int div_res;
-    lua_pcg_u64 boundedrand, q, r, threshold;
-    boundedrand = lua_pcg_u64_lh(0U, 0U);
+    lua_pcg_u128 m;
+    lua_pcg_u64 q, threshold;
+    lua_pcg_u64 mask = lua_pcg_u64_subtraction(bound, lua_pcg_u64_lh(1U, 0U));
+
+    if (lua_pcg_u64_eq(lua_pcg_u64_band(bound, mask), lua_pcg_u64_lh(0U, 0U)))
+    {
+        return lua_pcg_u64_band(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), mask);
+    }
+
+    m = lua_pcg_u64_mul_ex(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), bound);
+
+    if (lua_pcg_u64_lt(m.low, bound))
+    {
 #if (defined(_MSC_VER) && _MSC_VER >= 1100)
 #pragma warning(push)
 #pragma warning(disable:4146)
 #endif
-    div_res = lua_pcg_u64_div(lua_pcg_u64_additive_inverse(bound), bound, &q, &threshold);
+        if (lua_pcg_u64_div(lua_pcg_u64_additive_inverse(bound), bound, &q, &threshold) != 0)
+        {
+            return lua_pcg_u64_lh(0U, 0U);
+        }
 #if (defined(_MSC_VER) && _MSC_VER >= 1100)
 #pragma warning(pop)
 #endif
-    if (div_res == 0)
-    {
-        do
-        {
-            r = lua_pcg_setseq_128_xsl_rr_64_random_r(rng);
-        }
-        while (lua_pcg_u64_lt(r, threshold));
 
-        div_res = lua_pcg_u64_div(r, bound, &q, &boundedrand);
-        if (div_res != 0)
+        while (lua_pcg_u64_lt(m.low, threshold))
         {
-            boundedrand = lua_pcg_u64_lh(0U, 0U);
+            m = lua_pcg_u64_mul_ex(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), bound);
         }
     }
-    return boundedrand;
+
+    return m.high;
+}
+
+/*
+** Computes ahead of time the threshold (2^64 - bound) % bound
+** (see lua_pcg_setseq_64_xsh_rr_32_threshold)
+*/
+static lua_pcg_u64 lua_pcg_setseq_128_xsl_rr_64_threshold(lua_pcg_u64 bound)
+{
+    lua_pcg_u64 q, threshold;
+
+#if (defined(_MSC_VER) && _MSC_VER >= 1100)
+#pragma warning(push)
+#pragma warning(disable:4146)
+#endif
+    if (lua_pcg_u64_div(lua_pcg_u64_additive_inverse(bound), bound, &q, &threshold) != 0)
+    {
+        return lua_pcg_u64_lh(0U, 0U);
+    }
+#if (defined(_MSC_VER) && _MSC_VER >= 1100)
+#pragma warning(pop)
+#endif
+
+    return threshold;
+}
+
+/*
+** Generates a value in the range [0, bound)
+** from a precomputed threshold
+** (see lua_pcg_setseq_64_xsh_rr_32_thresholdrand_r)
+*/
+static lua_pcg_u64 lua_pcg_setseq_128_xsl_rr_64_thresholdrand_r(struct lua_pcg_state_setseq_128 *rng, lua_pcg_u64 bound, lua_pcg_u64 threshold)
+{
+    lua_pcg_u128 m;
+    lua_pcg_u64 mask = lua_pcg_u64_subtraction(bound, lua_pcg_u64_lh(1U, 0U));
+
+    if (lua_pcg_u64_eq(lua_pcg_u64_band(bound, mask), lua_pcg_u64_lh(0U, 0U)))
+    {
+        return lua_pcg_u64_band(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), mask);
+    }
+
+    do
+    {
+        m = lua_pcg_u64_mul_ex(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), bound);
+    } while (lua_pcg_u64_lt(m.low, threshold));
+
+    return m.high;
 }
 
-static lua_pcg_u128 lua_pcg_advance_lcg_128(lua_pcg_u128 state, lua_pcg_u128 delta, lua_pcg_u128 cur_mult, lua_pcg_u128 cur_plus)
+/*
+** advances state by delta steps through the jump tables,
+** multiplying only for the set bits of delta
+*/
+static lua_pcg_u128 lua_pcg_advance_lcg_128(lua_pcg_u128 state, lua_pcg_u128 delta, lua_pcg_u128 cur_plus)
 {
-    /* 0U */
-    lua_pcg_u128 zero = lua_pcg_u128_lh(lua_pcg_u64_lh(0U, 0U), lua_pcg_u64_lh(0U, 0U));
-    /* 1U */
-    lua_pcg_u128 one = lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U));
+    unsigned int i;
+    unsigned int w;
+    lua_pcg_u32 word;
+    lua_pcg_u32 words[4];
 
     /* acc_mult = 1U */
     lua_pcg_u128 acc_mult = lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U));
@@ -1469,35 +2081,30 @@ static lua_pcg_u128 lua_pcg_advance_lcg_128(lua_pcg_u128 state, lua_pcg_u128 del
     /* acc_plus = 0U */
     lua_pcg_u128 acc_plus = lua_pcg_u128_lh(lua_pcg_u64_lh(0U, 0U), lua_pcg_u64_lh(0U, 0U));
 
-    lua_pcg_u128 _delta = delta;
-    lua_pcg_u128 _cur_mult = cur_mult;
-    lua_pcg_u128 _cur_plus = cur_plus;
+    /* split delta in 32-bit words (least significant first) */
+    words[0] = lua_pcg_u64_cast_to_u32(delta.low);
+    words[1] = lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(delta.low, 32));
+    words[2] = lua_pcg_u64_cast_to_u32(delta.high);
+    words[3] = lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(delta.high, 32));
 
-    /* while (delta > 0) */
-    while (lua_pcg_u128_gt(_delta, zero))
+    for (w = 0; w < 4; w++)
     {
-        /* if (delta & 1) */
-        if (lua_pcg_u128_neq(lua_pcg_u128_band(_delta, one), zero))
+        word = words[w];
+        for (i = 32 * w; word != 0U; i++, word >>= 1)
         {
-            /* acc_mult *= cur_mult */
-            acc_mult = lua_pcg_u128_mul(acc_mult, _cur_mult);
+            if (word & 1U)
+            {
+                /* acc_mult *= mult[i] */
+                acc_mult = lua_pcg_u128_mul(acc_mult, lua_pcg_jump_mult_128[i]);
 
-            /* acc_plus = acc_plus * cur_mult + cur_plus */
-            acc_plus = lua_pcg_u128_sum(lua_pcg_u128_mul(acc_plus, _cur_mult), _cur_plus);
+                /* acc_plus = acc_plus * mult[i] + plus[i] */
+                acc_plus = lua_pcg_u128_sum(lua_pcg_u128_mul(acc_plus, lua_pcg_jump_mult_128[i]), lua_pcg_jump_plus_128[i]);
+            }
         }
-
-        /* cur_plus = (cur_mult + 1) * cur_plus */
-        _cur_plus = lua_pcg_u128_mul(lua_pcg_u128_sum(_cur_mult, one), _cur_plus);
-
-        /* cur_mult *= cur_mult */
-        _cur_mult = lua_pcg_u128_mul(_cur_mult, _cur_mult);
-
-        /* delta /= 2 which is equal to delta >>= 1 */
-        _delta = lua_pcg_u128_rsh(_delta, 1);
     }
 
-    /* return acc_mult * state + acc_plus */
-    return lua_pcg_u128_sum(lua_pcg_u128_mul(acc_mult, state), acc_plus);
+    /* return acc_mult * state + acc_plus * cur_plus */
+    return lua_pcg_u128_sum(lua_pcg_u128_mul(acc_mult, state), lua_pcg_u128_mul(acc_plus, cur_plus));
 }
 
 #else /* both 64-bit and 128-bit are available */
@@ -1534,54 +2141,128 @@ static void lua_pcg_setseq_128_srandom_r(struct lua_pcg_state_setseq_128 *rng, l
 
 static lua_pcg_u64 lua_pcg_setseq_128_xsl_rr_64_boundedrand_r(struct lua_pcg_state_setseq_128 *rng, lua_pcg_u64 bound)
 {
-    lua_pcg_u64 r;
+    lua_pcg_u128 m;
+    lua_pcg_u64 low, threshold;
     lua_pcg_u64 safebound = lua_pcg_u64_cast(bound);
-    lua_pcg_u64 threshold = (-safebound) % safebound;
 
-    do
+    if ((safebound & (safebound - 1U)) == 0U)
+    {
+        return (lua_pcg_setseq_128_xsl_rr_64_random_r(rng) & (safebound - 1U));
+    }
+
+    m = ((lua_pcg_u128)lua_pcg_setseq_128_xsl_rr_64_random_r(rng)) * safebound;
+    low = lua_pcg_u64_cast(m);
+
+    if (low < safebound)
+    {
+        threshold = lua_pcg_u64_cast(-safebound) % safebound;
+
+        while (low < threshold)
+        {
+            m = ((lua_pcg_u128)lua_pcg_setseq_128_xsl_rr_64_random_r(rng)) * safebound;
+            low = lua_pcg_u64_cast(m);
+        }
+    }
+
+    return lua_pcg_u64_cast(m >> 64U);
+}
+
+static lua_pcg_u64 lua_pcg_setseq_128_xsl_rr_64_threshold(lua_pcg_u64 bound)
+{
+    lua_pcg_u64 safebound = lua_pcg_u64_cast(bound);
+    return lua_pcg_u64_cast(-safebound) % safebound;
+}
+
+static lua_pcg_u64 lua_pcg_setseq_128_xsl_rr_64_thresholdrand_r(struct lua_pcg_state_setseq_128 *rng, lua_pcg_u64 bound, lua_pcg_u64 threshold)
+{
+    lua_pcg_u128 m;
+    lua_pcg_u64 safebound = lua_pcg_u64_cast(bound);
+
+    if ((safebound & (safebound - 1U)) == 0U)
     {
-        r = lua_pcg_setseq_128_xsl_rr_64_random_r(rng);
+        return (lua_pcg_setseq_128_xsl_rr_64_random_r(rng) & (safebound - 1U));
     }
-    while (r < threshold);
 
-    return (r % safebound);
+    do
+    {
+        m = ((lua_pcg_u128)lua_pcg_setseq_128_xsl_rr_64_random_r(rng)) * safebound;
+    } while (lua_pcg_u64_cast(m) < threshold);
+
+    return lua_pcg_u64_cast(m >> 64U);
 }
 
-static lua_pcg_u128 lua_pcg_advance_lcg_128(lua_pcg_u128 state, lua_pcg_u128 delta, lua_pcg_u128 cur_mult, lua_pcg_u128 cur_plus)
+/*
+** advances state by delta steps through the jump tables,
+** multiplying only for the set bits of delta
+*/
+static lua_pcg_u128 lua_pcg_advance_lcg_128(lua_pcg_u128 state, lua_pcg_u128 delta, lua_pcg_u128 cur_plus)
 {
+    unsigned int i;
     lua_pcg_u128 acc_mult = 1U;
     lua_pcg_u128 acc_plus = 0U;
 
-    lua_pcg_u128 _delta = delta;
-    lua_pcg_u128 _cur_mult = cur_mult;
-    lua_pcg_u128 _cur_plus = cur_plus;
-
-    while (_delta > 0U)
+    for (i = 0; delta > 0U; i++, delta >>= 1U)
     {
-        if (_delta & 1U)
+        if (delta & 1U)
         {
-            acc_mult = acc_mult * _cur_mult;
-            acc_plus = acc_plus * _cur_mult + _cur_plus;
+            acc_mult = acc_mult * lua_pcg_jump_mult_128[i];
+            acc_plus = acc_plus * lua_pcg_jump_mult_128[i] + lua_pcg_jump_plus_128[i];
         }
-        _cur_plus = (_cur_mult + 1U) * _cur_plus;
-        _cur_mult = _cur_mult * _cur_mult;
-        _delta >>= 1U;
     }
 
-    return acc_mult * state + acc_plus;
+    return acc_mult * state + acc_plus * cur_plus;
 }
 
 #endif
 
 static void lua_pcg_setseq_128_advance_r(struct lua_pcg_state_setseq_128 *rng, lua_pcg_u128 delta)
 {
-    rng->state = lua_pcg_advance_lcg_128(rng->state, delta, LUA_PCG_DEFAULT_MULTIPLIER_128, rng->inc);
+    rng->state = lua_pcg_advance_lcg_128(rng->state, delta, rng->inc);
+}
+
+/*
+** Generates a value in the range [0, bound) for a 32-bit bound
+** from the upper 32 bits of a 64-bit value r, through
+** Lemire's method on the 64-bit product of the upper bits
+** of r and bound (see lua_pcg_setseq_64_xsh_rr_32_boundedrand_r),
+** which is cheaper than the 128-bit product required by
+** lua_pcg_setseq_128_xsl_rr_64_boundedrand_r.
+*/
+static lua_pcg_u32 lua_pcg_setseq_128_xsl_rr_64_boundedrand32_r(struct lua_pcg_state_setseq_128 *rng, lua_pcg_u32 bound)
+{
+    lua_pcg_u64 m;
+    lua_pcg_u32 low, threshold;
+    lua_pcg_u32 safebound = lua_pcg_u32_cast(bound);
+
+    if ((safebound & (safebound - 1U)) == 0U)
+    {
+        return (lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), 32U)) & (safebound - 1U));
+    }
+
+    m = lua_pcg_u32_mul_ex(lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), 32U)), safebound);
+    low = lua_pcg_u64_cast_to_u32(m);
+
+    if (low < safebound)
+    {
+        threshold = lua_pcg_setseq_64_xsh_rr_32_threshold(safebound);
+
+        while (low < threshold)
+        {
+            m = lua_pcg_u32_mul_ex(lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(lua_pcg_setseq_128_xsl_rr_64_random_r(rng), 32U)), safebound);
+            low = lua_pcg_u64_cast_to_u32(m);
+        }
+    }
+
+    return lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(m, 32U));
 }
 
 typedef struct lua_pcg_state_setseq_128 lua_pcg64_random_t;
 #define lua_pcg64_random_r lua_pcg_setseq_128_xsl_rr_64_random_r
 #define lua_pcg64_srandom_r lua_pcg_setseq_128_srandom_r
 #define lua_pcg64_boundedrand_r lua_pcg_setseq_128_xsl_rr_64_boundedrand_r
+#define lua_pcg64_boundedrand32_r lua_pcg_setseq_128_xsl_rr_64_boundedrand32_r
+#define lua_pcg64_threshold lua_pcg_setseq_128_xsl_rr_64_threshold
+#define lua_pcg64_thresholdrand_r lua_pcg_setseq_128_xsl_rr_64_thresholdrand_r
 #define lua_pcg64_advance_r lua_pcg_setseq_128_advance_r
 
 /*
@@ -1593,143 +2274,76 @@ typedef struct lua_pcg_state_setseq_128 lua_pcg64_random_t;
 ** 
 */
 
+/*
+** Lookup table mapping each char (as unsigned char)
+** to the value of the hex digit [0-9a-fA-F] it represents,
+** or to 0xFF when the char is not a hex digit.
+** 
+** Note: the table is constant, such that Lua states on
+** different threads can share it, and it is indexed by
+** ASCII codes, the character set assumed by the lexer
+** of Lua itself (see lctype.c).
+*/
+static const unsigned char lua_pcg_hexdigit_table[UCHAR_MAX + 1] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
 /* 
-** Parses a hex digit matching
-** the following regex pattern: [0-9a-fA-F]
+** Decodes the hex digits on positions [2, len) of
+** the string s in a single pass (right to left),
+** writing them straight into 32-bit words
+** (least significant word first).
+** 
+** Note: words must hold at least
+** ((len - 2) / 8) rounded up elements.
 ** 
 ** return value:
-**    0: everything went fine
-**    1: unexpected translation from hex digit to decimal
-**    2: not a hex digit
+**   -1: everything went fine
+**   otherwise: the position of the first char
+**              (from the right) that is not a hex digit
 */
-static int lua_pcg_parse_hexdigit(char c, lua_pcg_u32 *digit)
+static int lua_pcg_decode_hex_words(const char *s, size_t len, lua_pcg_u32 *words)
 {
-    int res = 0;
-    int d;
+    size_t i;
+    unsigned char digit;
+    unsigned int shift = 0U;
+    lua_pcg_u32 *word = words;
 
-    switch (c)
+    for (i = len; i > 2; i--)
     {
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
+        digit = lua_pcg_hexdigit_table[(unsigned char)s[i - 1]];
+        if (digit > 0xF)
         {
-            d = ((int)c) - ((int)'0');
+            return (int)(i - 1);
+        }
 
-            if (!(0 <= d && d <= 9))
-            {
-                res = 1;
-            }
+        *word |= ((lua_pcg_u32)digit) << shift;
 
-            break;
-        }
-        case 'a':
-        case 'b':
-        case 'c':
-        case 'd':
-        case 'e':
-        case 'f':
-        {
-            d = ((int)c) - ((int)'a') + 0xA;
-
-            if (!(0xA <= d && d <= 0xF))
-            {
-                res = 1;
-            }
-
-            break;
-        }
-        case 'A':
-        case 'B':
-        case 'C':
-        case 'D':
-        case 'E':
-        case 'F':
-        {
-            d = ((int)c) - ((int)'A') + 0xA;
-
-            if (!(0xA <= d && d <= 0xF))
-            {
-                res = 1;
-            }
-
-            break;
-        }
-        default:
-        {
-            res = 2;
-            break;
-        }
-    }
-
-    if (res == 0)
-    {
-        *digit = (lua_pcg_u32)d;
-    }
-
-    return res;
-}
-
-/* 
-** Parses a lua_pcg_u32 from a hex string (right to left)
-** starting at the (e)nd position
-** but not going further than (s)tart position.
-** Matches the following regex pattern: [0-9a-fA-F]{1,8}
-** 
-** return value:
-**    0: everything went fine
-**    1: unexpected translation from hex digit to decimal
-**    2: not a hex digit
-**    3: s or e are out of range
-*/
-static int lua_pcg_parse_u32_from_hexstring(const char *buff, int s, int e, lua_pcg_u32 *result, lua_pcg_u32 *consumed, int *failed_index)
-{
-    int res = 0;
-    lua_pcg_u32 digit;
-    lua_pcg_u32 value = 0U;
-    lua_pcg_u32 con = 0U;
-    int i = e;
-
-    if (e < 0 || e < s)
-    {
-        res = 3;
-    }
-    else
-    {
-        while ((i >= s) && (con < 8U) && ((res = lua_pcg_parse_hexdigit(buff[i], &digit)) == 0))
+        shift += 4U;
+        if (shift == 32U)
         {
-            con++;
-
-            if (con == 1U)
-            {
-                value |= digit;
-            }
-            else /* con <= 8U */
-            {
-                value |= (digit << ((con - 1U) << 2U));
-            }
-
-            i--;
+            shift = 0U;
+            word++;
         }
     }
 
-    if (res == 0)
-    {
-        *result = value;
-        *consumed = con;
-    }
-    else
-    {
-        *failed_index = i;
-    }
-
-    return res;
+    return -1;
 }
 
 /*
@@ -1741,62 +2355,25 @@ static int lua_pcg_parse_u32_from_hexstring(const char *buff, int s, int e, lua_
 */
 static lua_pcg_u64 lua_pcg_parse_u64_hex_arg(lua_State *L, int index)
 {
-    int i, j;
     size_t len;
-    lua_pcg_u32 consumed = 0U;
+    int failed_index;
 
     /* holds low and high */
     lua_pcg_u32 words[2];
 
-    int parse_status;
-    int failed_index = -1;
     const char *s = luaL_checklstring(L, index, &len);
 
     luaL_argcheck(L, len >= 2, index, "Hex string too short.");
     luaL_argcheck(L, len <= 18, index, "Too many characters in the hex string.");
     luaL_argcheck(L, (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')), index, "Hex prefix not found.");
 
-    /* fill low and high with zeros */
+    /* fill the words with zeros */
     memset((void *)words, 0, sizeof(words));
 
-    i = (int)(len - 1);
-    j = 0;
-
-    while (i >= 2)
+    failed_index = lua_pcg_decode_hex_words(s, len, words);
+    if (failed_index >= 0)
     {
-        parse_status = lua_pcg_parse_u32_from_hexstring(s, 2, i, &(words[j]), &consumed, &failed_index);
-
-        switch (parse_status)
-        {
-            case 0:
-            {
-                /* everything went fine */
-                break;
-            }
-            case 1:
-            {
-                luaL_error(L, "Unxpected condition while parsing digit at position %d on argument #%d", failed_index + 1, index);
-                break;
-            }
-            case 2:
-            {
-                luaL_error(L, "Position %d is not a digit on argument #%d", failed_index + 1, index);
-                break;
-            }
-            case 3:
-            {
-                luaL_error(L, "Internal error (wrong string positions [%d, %d]). Report this issue to the team maintaining the lua-pcg library.", 2, i);
-                break;
-            }
-            default:
-            {
-                luaL_error(L, "Unknown digit conversion result at position %d on argument #%d", failed_index + 1, index);
-                break;
-            }
-        }
-
-        i -= consumed;
-        j++;
+        luaL_error(L, "Position %d is not a digit on argument #%d", failed_index + 1, index);
     }
 
     return lua_pcg_u64_lh(words[0], words[1]);
@@ -1871,20 +2448,170 @@ static lua_pcg_u64 lua_pcg_parse_u64_table_arg(lua_State *L, int index)
     return result;
 }
 
+/* loads a lua_pcg_u64 stored on src in little-endian byte order */
+static lua_pcg_u64 lua_pcg_unpack_u64(const unsigned char *src)
+{
+    lua_pcg_u32 low = ((lua_pcg_u32)src[0]) | (((lua_pcg_u32)src[1]) << 8) | (((lua_pcg_u32)src[2]) << 16) | (((lua_pcg_u32)src[3]) << 24);
+    lua_pcg_u32 high = ((lua_pcg_u32)src[4]) | (((lua_pcg_u32)src[5]) << 8) | (((lua_pcg_u32)src[6]) << 16) | (((lua_pcg_u32)src[7]) << 24);
+    return lua_pcg_u64_lh(low, high);
+}
+
+/* loads a lua_pcg_u128 stored on src in little-endian byte order */
+static lua_pcg_u128 lua_pcg_unpack_u128(const unsigned char *src)
+{
+    return lua_pcg_u128_lh(lua_pcg_unpack_u64(src), lua_pcg_unpack_u64(src + 8));
+}
+
+/*
+** Gets the binary string held by the field 'binary' of
+** the table located at stack position 'index'
+** (e.g.: {binary = string.pack("<I8", n)}), which
+** must hold exactly 'size' bytes in little-endian byte order.
+** 
+** return value:
+**    NULL: the table has no field 'binary'
+**    otherwise: the bytes of the binary string,
+**               which is left on the top of the stack
+*/
+static const unsigned char *lua_pcg_check_binary_field(lua_State *L, int index, size_t size)
+{
+    size_t len;
+    const char *s;
+
+    lua_pushliteral(L, "binary");
+    lua_rawget(L, index);
+
+    if (lua_isnil(L, -1))
+    {
+        lua_pop(L, 1);
+        return NULL;
+    }
+
+    s = lua_type(L, -1) == LUA_TSTRING ? lua_tolstring(L, -1, &len) : NULL;
+    if (s == NULL || len != size)
+    {
+        luaL_error(L, "field 'binary' must be a string holding %d bytes on argument #%d", (int)size, index);
+    }
+
+    return (const unsigned char *)s;
+}
+
+/*
+** Parses the integer located at stack position
+** given by 'index' as 64-bit two's complement.
+** 
+** For n >= 0, low and high are filled with the words of n.
+** For n < 0, low and high are filled with the words of (-n - 1),
+** whose bitwise not is n in two's complement, such that
+** the caller sign-extends n to the width it needs.
+** 
+** return value:
+**    0: n >= 0
+**    1: n < 0
+** 
+** Note: on Lua 5.1 and 5.2, numbers are doubles,
+** and must be integral with magnitude up to 2^53.
+*/
+static int lua_pcg_parse_integer_words(lua_State *L, int index, lua_pcg_u32 *low, lua_pcg_u32 *high)
+{
+    int negative;
+#if LUA_VERSION_NUM < 503
+    lua_Number remainder;
+    lua_Number n = luaL_checknumber(L, index);
+    lua_Number m;
+
+    luaL_argcheck(L, -9007199254740992.0 <= n && n <= 9007199254740992.0, index, "integer is out of [-2^53, 2^53] range");
+    negative = n < 0;
+    m = negative ? (-n - 1) : n;
+    luaL_argcheck(L, m >= 0, index, "number has no integer representation");
+    *high = (lua_pcg_u32)(m / 4294967296.0);
+    remainder = m - ((lua_Number)(*high)) * 4294967296.0;
+    *low = (lua_pcg_u32)remainder;
+    luaL_argcheck(L, remainder == (lua_Number)(*low), index, "number has no integer representation");
+#else
+    lua_Integer n = luaL_checkinteger(L, index);
+    lua_Integer m;
+
+    negative = n < 0;
+    m = negative ? -(n + 1) : n;
+    *low = lua_pcg_u32_cast(m);
+    *high = lua_pcg_u32_cast((m / 65536) / 65536);
+#endif
+    return negative;
+}
+
+/*
+** Parses lua_pcg_u64 as integer argument
+** located at stack position given by 'index',
+** where negative integers are taken in two's complement
+** (e.g.: -1 is 0xFFFFFFFFFFFFFFFF)
+*/
+static lua_pcg_u64 lua_pcg_parse_u64_integer_arg(lua_State *L, int index)
+{
+    lua_pcg_u32 low;
+    lua_pcg_u32 high;
+    int negative = lua_pcg_parse_integer_words(L, index, &low, &high);
+    lua_pcg_u64 result = lua_pcg_u64_lh(low, high);
+    return negative ? lua_pcg_u64_bnot(result) : result;
+}
+
+/*
+** Parses lua_pcg_u128 as integer argument
+** located at stack position given by 'index',
+** where negative integers are sign-extended to 128-bit
+** (e.g.: -1 is 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF)
+*/
+static lua_pcg_u128 lua_pcg_parse_u128_integer_arg(lua_State *L, int index)
+{
+    lua_pcg_u32 low;
+    lua_pcg_u32 high;
+    int negative = lua_pcg_parse_integer_words(L, index, &low, &high);
+    lua_pcg_u128 result = lua_pcg_u128_lh(lua_pcg_u64_lh(low, high), lua_pcg_u64_lh(0U, 0U));
+    return negative ? lua_pcg_u128_bnot(result) : result;
+}
+
 /*
 ** Parses lua_pcg_u64 argument
 ** located at stack position given by 'index'
+** 
+** Accepted arguments:
+**    - integer (negative values in two's complement);
+**    - hex string;
+**    - table of bytes (little-endian);
+**    - table holding a binary string of 8 bytes
+**      (little-endian) on the field 'binary'.
+** 
+** Note: strings are always parsed as hex, such that
+** binary strings are only taken through the field
+** 'binary', which cannot be mistaken for a hex string.
 */
 static lua_pcg_u64 lua_pcg_parse_u64_arg(lua_State *L, int index)
 {
     lua_pcg_u64 result;
+    const unsigned char *binary;
     int t = lua_type(L, index);
 
     switch (t)
     {
         case LUA_TTABLE:
         {
-            result = lua_pcg_parse_u64_table_arg(L, index);
+            binary = lua_pcg_check_binary_field(L, index, 8U);
+            if (binary != NULL)
+            {
+                result = lua_pcg_unpack_u64(binary);
+
+                /* removes the binary string from the top */
+                lua_pop(L, 1);
+            }
+            else
+            {
+                result = lua_pcg_parse_u64_table_arg(L, index);
+            }
+            break;
+        }
+        case LUA_TNUMBER:
+        {
+            result = lua_pcg_parse_u64_integer_arg(L, index);
             break;
         }
         case LUA_TSTRING:
@@ -1917,62 +2644,25 @@ static lua_pcg_u64 lua_pcg_parse_u64_arg(lua_State *L, int index)
 */
 static lua_pcg_u128 lua_pcg_parse_u128_hex_arg(lua_State *L, int index)
 {
-    int i, j;
     size_t len;
-    lua_pcg_u32 consumed = 0U;
+    int failed_index;
 
     /* holds low (low and high) and high (low and high) */
     lua_pcg_u32 words[4];
 
-    int parse_status;
-    int failed_index = -1;
     const char *s = luaL_checklstring(L, index, &len);
 
     luaL_argcheck(L, len >= 2, index, "Hex string too short.");
     luaL_argcheck(L, len <= 34, index, "Too many characters in the hex string.");
     luaL_argcheck(L, (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')), index, "Hex prefix not found.");
 
-    /* fill low and high with zeros */
+    /* fill the words with zeros */
     memset((void *)words, 0, sizeof(words));
 
-    i = (int)(len - 1);
-    j = 0;
-
-    while (i >= 2)
+    failed_index = lua_pcg_decode_hex_words(s, len, words);
+    if (failed_index >= 0)
     {
-        parse_status = lua_pcg_parse_u32_from_hexstring(s, 2, i, &(words[j]), &consumed, &failed_index);
-
-        switch (parse_status)
-        {
-            case 0:
-            {
-                /* everything went fine */
-                break;
-            }
-            case 1:
-            {
-                luaL_error(L, "Unxpected condition while parsing digit at position %d on argument #%d", failed_index + 1, index);
-                break;
-            }
-            case 2:
-            {
-                luaL_error(L, "Position %d is not a digit on argument #%d", failed_index + 1, index);
-                break;
-            }
-            case 3:
-            {
-                luaL_error(L, "Internal error (wrong string positions [%d, %d]). Report this issue to the team maintaining the lua-pcg library.", 2, i);
-                break;
-            }
-            default:
-            {
-                luaL_error(L, "Unknown digit conversion result at position %d on argument #%d", failed_index + 1, index);
-                break;
-            }
-        }
-
-        i -= consumed;
-        j++;
+        luaL_error(L, "Position %d is not a digit on argument #%d", failed_index + 1, index);
     }
 
     return lua_pcg_u128_lh(lua_pcg_u64_lh(words[0], words[1]), lua_pcg_u64_lh(words[2], words[3]));
@@ -2050,17 +2740,37 @@ static lua_pcg_u128 lua_pcg_parse_u128_table_arg(lua_State *L, int index)
 /*
 ** Parses lua_pcg_u128 argument
 ** located at stack position given by 'index'
+** (see lua_pcg_parse_u64_arg)
+** 
+** Note: the field 'binary' must hold 16 bytes.
 */
 static lua_pcg_u128 lua_pcg_parse_u128_arg(lua_State *L, int index)
 {
     lua_pcg_u128 result;
+    const unsigned char *binary;
     int t = lua_type(L, index);
 
     switch (t)
     {
         case LUA_TTABLE:
         {
-            result = lua_pcg_parse_u128_table_arg(L, index);
+            binary = lua_pcg_check_binary_field(L, index, 16U);
+            if (binary != NULL)
+            {
+                result = lua_pcg_unpack_u128(binary);
+
+                /* removes the binary string from the top */
+                lua_pop(L, 1);
+            }
+            else
+            {
+                result = lua_pcg_parse_u128_table_arg(L, index);
+            }
+            break;
+        }
+        case LUA_TNUMBER:
+        {
+            result = lua_pcg_parse_u128_integer_arg(L, index);
             break;
         }
         case LUA_TSTRING:
@@ -2263,545 +2973,5397 @@ static void lua_pcg_fill_with_random_bytes(void *ud, lua_pcg_u128 *v1, lua_pcg_u
 }
 
 /*
-** Dynamically allocate 'size' bytes
+** LuaJIT reports FFI cdata
+** objects with this type
+** through lua_type
 */
-static void *lua_pcg_alloc(lua_State *L, size_t size)
-{
-#ifdef LUA_PCG_USE_LUA_ALLOC
-    void *ud;
-    lua_Alloc allocf = lua_getallocf(L, &ud);
-    return allocf(ud, NULL, 0, size);
-#else
-    (void)L;
-    return malloc(size);
-#endif
-}
+#define LUA_PCG_TCDATA 10
 
 /*
-** Free the memory on 'ptr' which is holding 'size' bytes
-** previously allocated.
+** Gets the address held by the LuaJIT FFI
+** cdata located at stack position 'index'.
+**
+** lua_topointer yields the address of the
+** cdata payload, which is the memory block
+** itself for arrays and structures, but the
+** storage of the pointer for pointers. Thus,
+** the cdata is converted by ffi.cast("void *", x)
+** and the address is read from the payload
+** of the resulting pointer, which covers
+** arrays, structures, pointers and integer
+** addresses (e.g.: ffi.cast("uintptr_t", p)).
 */
-static void lua_pcg_free(lua_State *L, void *ptr, size_t size)
+static void *lua_pcg_check_cdata_address(lua_State *L, int index)
 {
-#ifdef LUA_PCG_USE_LUA_ALLOC
-    void *ud;
-    lua_Alloc allocf = lua_getallocf(L, &ud);
-    ((void)allocf(ud, ptr, size, 0));
-#else
-    (void)L;
-    (void)size;
-    return free(ptr);
-#endif
-}
+    void *ptr = NULL;
+    int top = lua_gettop(L);
+    int converted = 0;
 
-/* end of utility functions */
+    lua_getfield(L, LUA_REGISTRYINDEX, "_LOADED");
+    if (lua_type(L, -1) == LUA_TTABLE)
+    {
+        lua_getfield(L, -1, "ffi");
+        if (lua_type(L, -1) == LUA_TTABLE)
+        {
+            lua_getfield(L, -1, "cast");
+            if (lua_type(L, -1) == LUA_TFUNCTION)
+            {
+                lua_pushliteral(L, "void *");
+                lua_pushvalue(L, index);
+                if (lua_pcall(L, 2, 1, 0) == 0 && lua_type(L, -1) == LUA_PCG_TCDATA)
+                {
+                    memcpy((void *)&ptr, lua_topointer(L, -1), sizeof(void *));
+                    converted = 1;
+                }
+            }
+        }
+    }
+    lua_settop(L, top);
 
-/* 
-** *********************************************
-** *********************************************
-** 
-** Now that pcg32 methods were implemented,
-** we are going to bridge it to Lua.
-** 
-** *********************************************
-** *********************************************
-*/
+    luaL_argcheck(L, converted, index, "cdata cannot be converted to a pointer");
+    return ptr;
+}
 
 /*
-** Structure to wrap a lua_pcg32_random_t
-** 
-** Note: it might be thought unnecessary
-**       to wrap the type 'lua_pcg32_random_t'
-**       in order to expose methods to Lua.
-**       However, 'lua_newuserdata' has
-**       some hard to spot alignment problems
-**       (see https://github.com/LuaJIT/LuaJIT/issues/1161 ).
-** 
-**       Even with PUC-Lua interpreter, on Linux with GCC, I've ran
-**       into such alignment issues, especially
-**       in the 'advance' function on lua_pcg64_random_t
-**       below for the (native system's provided) __int128.
-** 
-**       Thus, to avoid any possibility to run into
-**       such alignment issues, we wrap the
-**       'lua_pcg32_random_t' and allocate it
-**       using 'malloc' which works well in all cases.
+** Gets the address of a memory block
+** owned by the caller located at stack
+** position 'index'. The memory block is
+** given either as a lightuserdata or
+** as a LuaJIT FFI cdata (e.g.: an array
+** created through ffi.new("uint32_t[?]", n)
+** or a pointer such as ffi.cast("uint32_t *", x)).
 */
-typedef struct
+static unsigned char *lua_pcg_check_buffer(lua_State *L, int index)
 {
-    lua_pcg32_random_t *rng;
-} lua_pcg32_random_t_wrapper;
+    void *ptr = NULL;
 
-static lua_pcg32_random_t_wrapper *lua_pcg_pcg32_check(lua_State *L, int index)
-{
-    void *ud = luaL_checkudata(L, index, LUA_PCG_PCG32_METATABLE);
-    luaL_argcheck(L, ud != NULL, index, "pcg32 random expected");
-    return (lua_pcg32_random_t_wrapper *)ud;
+    switch (lua_type(L, index))
+    {
+        case LUA_TLIGHTUSERDATA:
+        {
+            ptr = lua_touserdata(L, index);
+            break;
+        }
+        case LUA_PCG_TCDATA:
+        {
+            ptr = lua_pcg_check_cdata_address(L, index);
+            break;
+        }
+        default:
+        {
+            luaL_argerror(L, index, "lightuserdata or cdata expected");
+            break;
+        }
+    }
+
+    luaL_argcheck(L, ptr != NULL, index, "the buffer cannot be NULL");
+    return (unsigned char *)ptr;
 }
 
-static lua_pcg32_random_t *lua_pcg_pcg32_check_rng(lua_State *L, int index)
+/* tells whether the system stores integers in little-endian byte order */
+static int lua_pcg_is_little_endian(void)
 {
-    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check(L, index);
-    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg32 random was closed previously");
-    return wrapper->rng;
+    lua_pcg_u32 one = 1U;
+    return (*((unsigned char *)&one)) == 1U;
 }
 
-/* creates a lua_pcg32_random_t (rng) */
-static int lua_pcg_pcg32_new(lua_State *L)
+/* stores the 32-bits of value on dst using the byte order of the system */
+static void lua_pcg_store_u32(unsigned char *dst, lua_pcg_u32 value)
 {
-    lua_pcg_u128 v1;
-    lua_pcg_u128 v2;
-    lua_pcg_u64 initstate;
-    lua_pcg_u64 initseq;
-    lua_pcg32_random_t_wrapper *wrapper;
-    lua_pcg32_random_t *rng;
-    void *ud;
-    int nargs;
+    int i;
 
-    nargs = lua_gettop(L);
-    ud = lua_newuserdata(L, sizeof(lua_pcg32_random_t_wrapper));
-    if (ud == NULL)
+    if (sizeof(lua_pcg_u32) == 4U)
     {
-        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32 random");
+        memcpy((void *)dst, (const void *)&value, 4U);
     }
-    luaL_getmetatable(L, LUA_PCG_PCG32_METATABLE);
-    lua_setmetatable(L, -2);
-
-    wrapper = (lua_pcg32_random_t_wrapper *)ud;
-    wrapper->rng = (lua_pcg32_random_t *)(lua_pcg_alloc(L, sizeof(lua_pcg32_random_t)));
-    if (wrapper->rng == NULL)
+    else if (lua_pcg_is_little_endian())
     {
-        return luaL_error(L, "Memory allocation failed to initialize lua_pcg32_random_t");
+        for (i = 0; i < 4; i++, value >>= 8U)
+        {
+            dst[i] = lua_pcg_u8_cast(value);
+        }
     }
-    rng = wrapper->rng;
-
-    switch (nargs)
+    else
     {
-        case 0: /* no args? generate both initstate and initseq */
+        for (i = 3; i >= 0; i--, value >>= 8U)
         {
-            lua_pcg_fill_with_random_bytes(ud, &v1, &v2);
-            initstate = lua_pcg_u128_cast_to_u64(v1);
-            initseq = lua_pcg_u128_cast_to_u64(v2);
-            break;
+            dst[i] = lua_pcg_u8_cast(value);
         }
-        case 1: /* only initstate was provided? then generate initseq */
-        {
-            initstate = lua_pcg_parse_u64_arg(L, 1);
-            lua_pcg_fill_with_random_bytes(ud, NULL, &v2);
-            initseq = lua_pcg_u128_cast_to_u64(v2);
-            break;
+    }
+}
+
+/* stores the 64-bits of value on dst using the byte order of the system */
+static void lua_pcg_store_u64(unsigned char *dst, lua_pcg_u64 value)
+{
+#ifdef LUA_PCG_U64_EMULATED
+    if (lua_pcg_is_little_endian())
+    {
+        lua_pcg_store_u32(dst, value.low);
+        lua_pcg_store_u32(dst + 4, value.high);
+    }
+    else
+    {
+        lua_pcg_store_u32(dst, value.high);
+        lua_pcg_store_u32(dst + 4, value.low);
+    }
+#else
+    if (sizeof(lua_pcg_u64) == 8U)
+    {
+        memcpy((void *)dst, (const void *)&value, 8U);
+    }
+    else if (lua_pcg_is_little_endian())
+    {
+        lua_pcg_store_u32(dst, lua_pcg_u64_cast_to_u32(value));
+        lua_pcg_store_u32(dst + 4, lua_pcg_u64_cast_to_u32(value >> 32U));
+    }
+    else
+    {
+        lua_pcg_store_u32(dst, lua_pcg_u64_cast_to_u32(value >> 32U));
+        lua_pcg_store_u32(dst + 4, lua_pcg_u64_cast_to_u32(value));
+    }
+#endif
+}
+
+/* stores the 64-bits of value on dst in little-endian byte order */
+static void lua_pcg_pack_u64(unsigned char *dst, lua_pcg_u64 value)
+{
+    int i;
+
+    if (lua_pcg_is_little_endian())
+    {
+        lua_pcg_store_u64(dst, value);
+    }
+    else
+    {
+        for (i = 0; i < 8; i++, value = lua_pcg_u64_rsh(value, 8U))
+        {
+            dst[i] = lua_pcg_u64_cast_to_u8(value);
+        }
+    }
+}
+
+/* stores the 128-bits of value on dst in little-endian byte order */
+static void lua_pcg_pack_u128(unsigned char *dst, lua_pcg_u128 value)
+{
+    lua_pcg_pack_u64(dst, lua_pcg_u128_cast_to_u64(value));
+    lua_pcg_pack_u64(dst + 8, lua_pcg_u128_cast_to_u64(lua_pcg_u128_rsh(value, 64U)));
+}
+
+/*
+** Parses the number of elements and the size
+** of each element (in bytes) of a buffer owned by the caller
+** located at stack positions 'index' and 'index + 1'.
+** 
+** Note: elemsize must be 4 or 8.
+*/
+static size_t lua_pcg_check_buffer_count(lua_State *L, int index, size_t default_elemsize, size_t *elemsize)
+{
+    lua_Integer count = luaL_checkinteger(L, index);
+    lua_Integer size = luaL_optinteger(L, index + 1, (lua_Integer)default_elemsize);
+
+    luaL_argcheck(L, 0 <= count, index, "count must be a non-negative integer");
+    luaL_argcheck(L, size == 4 || size == 8, index + 1, "elemsize must be 4 or 8");
+    luaL_argcheck(L, ((lua_Integer)(((size_t)count) & (((size_t)(~(size_t)0)) >> 3))) == count, index, "count is out of range");
+
+    *elemsize = (size_t)size;
+    return (size_t)count;
+}
+
+/*
+** stores the value k of a permutation on dst
+** as an element of elemsize (4 or 8) bytes
+*/
+static void lua_pcg_permutation_store(unsigned char *dst, size_t elemsize, size_t k)
+{
+    if (elemsize == 4U)
+    {
+        lua_pcg_store_u32(dst, lua_pcg_u32_cast(k));
+    }
+    else
+    {
+        lua_pcg_store_u64(dst, lua_pcg_u64_lh(lua_pcg_u32_cast(k), lua_pcg_u32_cast(((k >> 15) >> 15) >> 2)));
+    }
+}
+
+/*
+** Set of positive integers through open addressing
+** with linear probing, used to draw samples
+** without replacement. The slots are stored on a
+** userdata left on the stack by lua_pcg_intset_push,
+** where the value 0 marks an empty slot.
+*/
+typedef struct
+{
+    lua_Integer *slots;
+    size_t mask;
+    unsigned int shift;
+} lua_pcg_intset;
+
+/*
+** pushes the slots of a set able to hold 'count' integers,
+** keeping the load factor of the set at most 1/2
+** 
+** Note: the slots are indexed by a 32-bit hash,
+**       such that count must not exceed 2^31.
+*/
+static void lua_pcg_intset_push(lua_State *L, lua_pcg_intset *set, size_t count)
+{
+    size_t capacity = 2U;
+    unsigned int bits = 1U;
+
+    while (capacity < 2U * count)
+    {
+        capacity <<= 1U;
+        bits++;
+    }
+
+    set->slots = (lua_Integer *)lua_newuserdata(L, capacity * sizeof(lua_Integer));
+    if (set->slots == NULL)
+    {
+        luaL_error(L, "Memory allocation on Lua failed to create user data for a set of integers");
+        return;
+    }
+    memset((void *)set->slots, 0, capacity * sizeof(lua_Integer));
+    set->mask = capacity - 1U;
+    set->shift = 32U - bits;
+}
+
+/*
+** inserts the positive integer v on the set,
+** telling whether v was absent from it.
+** 
+** The slot is taken from the upper bits of the
+** 32-bit multiplicative (Fibonacci) hash of v.
+*/
+static int lua_pcg_intset_insert(lua_pcg_intset *set, lua_Integer v)
+{
+    unsigned long h = (unsigned long)(v ^ (((v >> 15) >> 15) >> 2));
+    size_t i = ((size_t)(((h * 2654435769UL) & 0xFFFFFFFFUL) >> set->shift)) & set->mask;
+
+    while (set->slots[i] != 0)
+    {
+        if (set->slots[i] == v)
+        {
+            return 0;
+        }
+        i = (i + 1U) & set->mask;
+    }
+
+    set->slots[i] = v;
+    return 1;
+}
+
+/* generator of uniform numbers in (0, 1] from an rng */
+typedef double (*lua_pcg_uniform_fn)(void *rng);
+
+/*
+** State of Vitter's sequential random sampling,
+** which selects n of the N records left to be scanned,
+** in increasing order, through skips of S records.
+** 
+** Algorithm D draws each skip with O(1) uniforms
+** from an approximation of the distribution of S,
+** while the number of records N is large compared to
+** the number of samples n (LUA_PCG_VITTER_ALPHA * n < N).
+** Afterwards, Algorithm A draws each skip from
+** its exact distribution, in time proportional to S.
+** 
+** See J. S. Vitter, "An efficient algorithm for sequential
+** random sampling", ACM Trans. Math. Softw. 13(1), 1987.
+*/
+typedef struct
+{
+    double N;
+    double n;
+    double vprime;
+    int method_d;
+} lua_pcg_vitter_t;
+
+#define LUA_PCG_VITTER_ALPHA 13.0
+
+/* Vprime = U^(1 / n), which is the largest of n uniforms */
+static double lua_pcg_vitter_vprime(double n, lua_pcg_uniform_fn uniform, void *rng)
+{
+    return exp(log(uniform(rng)) / n);
+}
+
+/* prepares the selection of n out of N records */
+static void lua_pcg_vitter_init(lua_pcg_vitter_t *v, double N, double n, lua_pcg_uniform_fn uniform, void *rng)
+{
+    v->N = N;
+    v->n = n;
+    v->method_d = (n > 0.0 && LUA_PCG_VITTER_ALPHA * n < N);
+    v->vprime = v->method_d ? lua_pcg_vitter_vprime(n, uniform, rng) : 1.0;
+}
+
+/* skip of Algorithm A, for n >= 2 */
+static double lua_pcg_vitter_skip_a(lua_pcg_vitter_t *v, lua_pcg_uniform_fn uniform, void *rng)
+{
+    double S = 0.0;
+    double top = v->N - v->n;
+    double Nreal = v->N;
+    double V = uniform(rng);
+    double quot = top / Nreal;
+
+    while (quot > V)
+    {
+        S += 1.0;
+        top -= 1.0;
+        Nreal -= 1.0;
+        quot = (quot * top) / Nreal;
+    }
+    return S;
+}
+
+/* skip of Algorithm D, for n >= 2 */
+static double lua_pcg_vitter_skip_d(lua_pcg_vitter_t *v, lua_pcg_uniform_fn uniform, void *rng)
+{
+    double S, X, U, y1, y2, top, bottom, limit, t;
+    double N = v->N;
+    double n = v->n;
+    double qu1 = N - n + 1.0;
+    double nmin1inv = 1.0 / (n - 1.0);
+
+    for (;;)
+    {
+        /* draws X from the approximation of S */
+        for (;;)
+        {
+            X = N * (1.0 - v->vprime);
+            S = floor(X);
+            if (S < qu1)
+            {
+                break;
+            }
+            v->vprime = lua_pcg_vitter_vprime(n, uniform, rng);
+        }
+
+        /* quick acceptance, whose computation is reused on Vprime */
+        U = uniform(rng);
+        y1 = exp(log(U * N / qu1) * nmin1inv);
+        v->vprime = y1 * (1.0 - X / N) * (qu1 / (qu1 - S));
+        if (v->vprime <= 1.0)
+        {
+            break;
+        }
+
+        /* exact acceptance */
+        y2 = 1.0;
+        top = N - 1.0;
+        if (n - 1.0 > S)
+        {
+            bottom = N - n;
+            limit = N - S;
+        }
+        else
+        {
+            bottom = N - S - 1.0;
+            limit = qu1;
+        }
+        for (t = N - 1.0; t >= limit; t -= 1.0)
+        {
+            y2 = (y2 * top) / bottom;
+            top -= 1.0;
+            bottom -= 1.0;
+        }
+        if (N / (N - X) >= y1 * exp(log(y2) * nmin1inv))
+        {
+            v->vprime = lua_pcg_vitter_vprime(n - 1.0, uniform, rng);
+            break;
+        }
+        v->vprime = lua_pcg_vitter_vprime(n, uniform, rng);
+    }
+
+    return S;
+}
+
+/*
+** draws the number of records S to be skipped
+** before the next selected record, updating
+** the numbers of records and samples left.
+** Only called while v->n >= 1.
+*/
+static double lua_pcg_vitter_skip(lua_pcg_vitter_t *v, lua_pcg_uniform_fn uniform, void *rng)
+{
+    double S;
+
+    if (v->n >= 2.0)
+    {
+        if (v->method_d && LUA_PCG_VITTER_ALPHA * v->n >= v->N)
+        {
+            v->method_d = 0;
+        }
+        S = v->method_d ? lua_pcg_vitter_skip_d(v, uniform, rng) : lua_pcg_vitter_skip_a(v, uniform, rng);
+    }
+    else
+    {
+        /* the last sample is uniform on the records left */
+        S = floor(v->N * (v->method_d ? v->vprime : (1.0 - uniform(rng))));
+    }
+
+    /* guards against rounding, leaving a record for each sample left */
+    if (S > v->N - v->n)
+    {
+        S = v->N - v->n;
+    }
+
+    v->N -= S + 1.0;
+    v->n -= 1.0;
+    return S;
+}
+
+/*
+** Scale factors that map the bits
+** of a random integer to the
+** mantissa of a floating-point
+** number in the range [0, 1)
+*/
+#define LUA_PCG_FLOAT_SCALE (1.0 / 16777216.0) /* 2^(-24) */
+#define LUA_PCG_DOUBLE_SCALE (1.0 / 9007199254740992.0) /* 2^(-53) */
+
+/*
+** Ziggurat method for the standard normal and exponential
+** distributions on 256 layers of equal area v under the
+** density f: the layer i covers [0, x[i]) x [f(x[i]), f(x[i + 1])),
+** where x[0] = v / f(r), x[1] = r is the start of the tail
+** and x[256] = 0. A draw takes 8 bits for the layer i, 1 bit
+** for the sign (normal only) and 53 bits for a uniform u,
+** returning u * x[i] straight away when it falls below
+** x[i + 1], which happens on about 99% of the draws.
+** Otherwise, the wedge of the layer (or the tail, for i = 0)
+** is sampled exactly by rejection.
+** 
+** See G. Marsaglia and W. W. Tsang, "The ziggurat method
+** for generating random variables", J. Stat. Softw. 5(8), 2000.
+** 
+** The tables are constant, such that Lua states on
+** different threads can share them. They were generated
+** offline in double precision, printing each entry with
+** the format %.17g (which round-trips a double), from
+** 
+**     x[0] = v / f(r), x[1] = r, x[256] = 0,
+**     x[i + 1] = f^-1(v / x[i] + f(x[i])) for 1 <= i < 255,
+**     f[i] = f(x[i]) for 0 <= i <= 256,
+** 
+** with f(x) = exp(-x^2 / 2) and f^-1(y) = sqrt(-2 log(y))
+** for the normal, and f(x) = exp(-x) and f^-1(y) = -log(y)
+** for the exponential.
+*/
+#define LUA_PCG_ZIGGURAT_LAYERS 256
+#define LUA_PCG_ZIGGURAT_NORMAL_R 3.6541528853610088
+#define LUA_PCG_ZIGGURAT_NORMAL_V 4.928673233974658e-3
+#define LUA_PCG_ZIGGURAT_EXPONENTIAL_R 7.69711747013104972
+#define LUA_PCG_ZIGGURAT_EXPONENTIAL_V 3.949659822581556e-3
+
+static const double lua_pcg_ziggurat_normal_x[LUA_PCG_ZIGGURAT_LAYERS + 1] =
+{
+    3.9107579595249167, 3.6541528853610088, 3.4492782985614312, 3.3202447338398251,
+    3.2245750520478009, 3.147889289518, 3.0835261320021425, 3.0278377917695929,
+    2.9786032798818427, 2.9343668672088872, 2.8941210536134121, 2.8571387308732241,
+    2.8228773968264425, 2.7909211740019271, 2.7609440052799856, 2.732685359044011,
+    2.7059336561230616, 2.6805146432857443, 2.6562830375767423, 2.6331163936315818,
+    2.6109105184888226, 2.5895759867082857, 2.5690354526818426, 2.5492215503247819,
+    2.5300752321598527, 2.5115444416266928, 2.4935830412710454, 2.4761499396705218,
+    2.4592083743347035, 2.4427253182003628, 2.4266709849371453, 2.4110184139011182,
+    2.3957431197819261, 2.3808227951720844, 2.3662370567172899, 2.3519672273791441,
+    2.337996148796528, 2.324308018871132, 2.3108882506013715, 2.297723348902863,
+    2.2848008027244915, 2.2721089902283813, 2.2596370951737872, 2.2473750329473887,
+    2.2353133849299205, 2.2234433400925098, 2.21175664288416, 2.2002455466112756,
+    2.1889027716263598, 2.1777214677402918, 2.1666951803543073, 2.1558178198767362,
+    2.1450836340478876, 2.1344871828460157, 2.1240233156895223, 2.1136871506866517,
+    2.1034740557148757, 2.0933796311387902, 2.0833996939983028, 2.0735302635187414,
+    2.0637675478117306, 2.0541079316506505, 2.04454796521753, 2.0350843537296175,
+    2.0257139478638528, 2.0164337349062027, 2.0072408305605274, 1.9981324713584183,
+    1.9891060076174367, 1.9801588969004753, 1.9712886979336579, 1.9624930649443617,
+    1.9537697423846454, 1.9451165600086768, 1.9365314282756931, 1.928012334052664,
+    1.9195573365931864, 1.9111645637712515, 1.9028322085504275, 1.8945585256707029,
+    1.886341828536781, 1.8781804862929941, 1.870072921071265, 1.8620176053996724,
+    1.8540130597602003, 1.8460578502851839, 1.8381505865828049, 1.8302899196827553,
+    1.8224745400938844, 1.8147031759662813, 1.8069745913508195, 1.7992875845497187,
+    1.791640986552161, 1.7840336595494399, 1.7764644955245215, 1.7689324149112673,
+    1.7614363653189091, 1.7539753203176704, 1.7465482782817214, 1.7391542612859108,
+    1.7317923140529623, 1.7244615029480441, 1.7171609150178224, 1.7098896570713011,
+    1.7026468547999223, 1.6954316519345607, 1.6882432094371944, 1.681080704725173,
+    1.6739433309261242, 1.6668302961616648, 1.6597408228581818, 1.6526741470830553,
+    1.6456295179047817, 1.638606196775547, 1.6316034569348727, 1.624620582833034,
+    1.6176568695730149, 1.6107116223698297, 1.6037841560260941, 1.5968737944227878,
+    1.5899798700241905, 1.5831017233960289, 1.5762387027359059, 1.5693901634151233,
+    1.5625554675310445, 1.5557339834691761, 1.5489250854741732, 1.5421281532290017,
+    1.5353425714415139, 1.528567729437712, 1.5218030207609978, 1.5150478427767144,
+    1.5083015962813113, 1.5015636851154637, 1.4948335157804935, 1.4881104970574472,
+    1.4813940396281871, 1.4746835556978553, 1.4679784586180793, 1.4612781625102753,
+    1.4545820818884101, 1.4478896312805758, 1.4412002248487237, 1.4345132760058918,
+    1.4278281970302555, 1.4211443986753085, 1.4144612897754707, 1.4077782768463982,
+    1.4010947636792503, 1.3944101509281404, 1.3877238356899755, 1.3810352110758548,
+    1.3743436657731656, 1.3676485835974754, 1.3609493430332822, 1.354245316762634,
+    1.3475358711805863, 1.3408203658964031, 1.334098153219359, 1.3273685776279247,
+    1.3206309752210552, 1.3138846731502194, 1.30712898903073, 1.3003632303308361,
+    1.2935866937369467, 1.2867986644932425, 1.2799984157138169, 1.2731852076653554,
+    1.2663582870182284, 1.2595168860637131, 1.2526602218948961, 1.2457874955486261,
+    1.2388978911056863, 1.231990574746135, 1.2250646937565297, 1.2181193754854807,
+    1.2111537262436982, 1.2041668301443804, 1.1971577478794404, 1.190125515426691,
+    1.1830691426826856, 1.1759876120154509, 1.1688798767308322, 1.1617448594456106,
+    1.1545814503599268, 1.1473885054208481, 1.1401648443681505, 1.132909248652533,
+    1.1256204592155323, 1.1182971741193437, 1.1109380460135743, 1.1035416794246382,
+    1.09610662785202, 1.0886313906539782, 1.0811144097034022, 1.0735540657924345,
+    1.0659486747621207, 1.0582964833306734, 1.0505956645909282, 1.0428443131441474,
+    1.0350404398334394, 1.0271819660356445, 1.019266717465483, 1.0112924174399947,
+    1.003256679544672, 0.99515699963509008, 0.98699074709906154, 0.97875515529422374,
+    0.97044731106422355, 0.96206414322303968, 0.95360240988108524, 0.94505868446816454,
+    0.93642934028657421, 0.92771053340199916, 0.91889818364958964, 0.90998795349671757,
+    0.9009752244612208, 0.89185507073294046, 0.88262222958516456, 0.87327106808885968,
+    0.86379554555330784, 0.85418917100816283, 0.84444495490915294, 0.83455535408638104,
+    0.82451220875229114, 0.81430667013521418, 0.80392911698997016, 0.79336905884062225,
+    0.78261502330723198, 0.77165442422456687, 0.76047340643010686, 0.74905666201781407,
+    0.73738721143429442, 0.72544614090999848, 0.71321228519097479, 0.70066184110681384,
+    0.68776789279578721, 0.67449982283729248, 0.66082257424441826, 0.64669571489499222,
+    0.63207223638605947, 0.61689699000774956, 0.60110461775599078, 0.58461676610637747,
+    0.5673382570538168, 0.54915170232716304, 0.52990972066155595, 0.50942332960208958,
+    0.48744396613923352, 0.4636343367908794, 0.43751840220786858, 0.40838913461198767,
+    0.37512133287837662, 0.33573751921442047, 0.28617459179206622, 0.21524189598487156,
+    0
+};
+
+static const double lua_pcg_ziggurat_normal_f[LUA_PCG_ZIGGURAT_LAYERS + 1] =
+{
+    0.0004774677646093862, 0.001260285930498598, 0.002609072746102164, 0.0040379725933630374,
+    0.0055224032992510106, 0.0070508754713732415, 0.0086165827693987489, 0.010214971439701487,
+    0.01184275785790791, 0.01349745060173989, 0.015177088307935337, 0.016880083152543187,
+    0.018605121275724671, 0.020351096230044538, 0.022117062707308899, 0.02390220330579591,
+    0.025705804008548945, 0.027527235669603148, 0.029365939758133387, 0.031221417191920328,
+    0.03309321945857862, 0.034980941461716174, 0.036884215688567402, 0.038802707404526238,
+    0.040736110655941085, 0.042684144916474612, 0.044646552251294602, 0.046623094901930527,
+    0.048613553215868695, 0.050617723860947941, 0.052635418276792377, 0.054666461324889094,
+    0.056710690106203082, 0.058767952920933925, 0.060838108349540017, 0.062921024437758225,
+    0.065016577971242953, 0.067124653827788566, 0.069245144397006825, 0.071377949058890472,
+    0.073522973713981379, 0.075680130358927178, 0.077849336702096122, 0.080030515814663153,
+    0.082223595813202988, 0.084428509570353541, 0.086645194450558141, 0.088873592068275969,
+    0.091113648066373829, 0.093365311912691096, 0.095628536713009082, 0.09790327903886259,
+    0.1001894987688101, 0.10248715894193534, 0.10479622562248721, 0.107116667774684,
+    0.10944845714681205, 0.11179156816383844, 0.11414597782783878, 0.11651166562561123,
+    0.11888861344291038, 0.12127680548479063, 0.1236762282015969, 0.12608687022018628,
+    0.1285087222799999, 0.13094177717364472, 0.13338602969166952, 0.13584147657125412,
+    0.13830811644855109, 0.14078594981444506, 0.14327497897351382, 0.14577520800599442,
+    0.14828664273257494, 0.15080929068184615, 0.1533431610602633, 0.15588826472447975,
+    0.15844461415592484, 0.16101222343751165, 0.16359110823236628, 0.16618128576448263,
+    0.16878277480121209, 0.1713955956375065, 0.17401977008183936, 0.17665532144373555,
+    0.17930227452284822, 0.18196065559952312, 0.18463049242679985, 0.1873118142238008,
+    0.19000465167046546, 0.19270903690358965, 0.1954250035141348, 0.19815258654577567,
+    0.20089182249465717, 0.20364274931033544, 0.20640540639788124, 0.20917983462112549,
+    0.2119660763070306, 0.214764175251174, 0.21757417672433152, 0.22039612748015233,
+    0.22323007576391782, 0.22607607132238053, 0.22893416541468053, 0.23180441082433889,
+    0.23468686187233026, 0.23758157443123834, 0.24048860594050084, 0.24340801542275048,
+    0.24633986350126399, 0.24928421241852858, 0.25224112605594223, 0.25521066995466196,
+    0.25819291133761924, 0.26118791913272121, 0.26419576399726119, 0.26721651834356147,
+    0.27025025636587546, 0.27329705406857707, 0.27635698929566832, 0.27943014176163794,
+    0.28251659308370758, 0.28561642681550176, 0.28872972848218292, 0.29185658561709521,
+    0.29499708779996181, 0.29815132669668548, 0.30131939610080305, 0.30450139197664999,
+    0.30769741250429206, 0.31090755812628651, 0.31413193159633718, 0.31737063802991361,
+    0.32062378495690536, 0.32389148237639109, 0.3271738428136014, 0.33047098137916359,
+    0.33378301583071845, 0.33711006663700605, 0.34045225704452187, 0.34380971314685072,
+    0.34718256395679364, 0.35057094148140611, 0.35397498080007678, 0.3573948201457805,
+    0.36083060098964803, 0.36428246812900406, 0.36775056977903259, 0.37123505766823955,
+    0.37473608713789125, 0.37825381724561929, 0.38178841087339377, 0.38534003484007745,
+    0.38890886001878894, 0.39249506145931584, 0.39609881851583273, 0.39972031498019756,
+    0.40335973922111484, 0.40701728432947376, 0.41069314827018866, 0.41438753404089163,
+    0.41810064983784861, 0.42183270922949634, 0.42558393133802241, 0.42935454102944193,
+    0.43314476911265276, 0.43695485254798599, 0.44078503466580438, 0.44463556539573978,
+    0.4485067015072034, 0.45239870686184896, 0.45631185267871677, 0.4602464178128432,
+    0.46420268904817463, 0.46818096140569387, 0.47218153846773042, 0.47620473271950614,
+    0.48025086590904703, 0.4843202694266836, 0.48841328470545831, 0.49253026364386882,
+    0.4966715690524901, 0.50083757512614913, 0.50502866794346846, 0.50924524599574816,
+    0.51348772074732718, 0.51775651722975646, 0.52205207467232195, 0.52637484717168459,
+    0.53072530440366228, 0.53510393238045795, 0.53951123425695258, 0.54394773119002671,
+    0.54841396325526637, 0.55291049042583296, 0.55743789361876661, 0.56199677581452512,
+    0.566587763256165, 0.57121150673525378, 0.57586868297235427, 0.58055999610079145,
+    0.58528617926337179, 0.59004799633282623, 0.59484624376798767, 0.5996817526191256,
+    0.604555390697468, 0.60946806492577366, 0.61442072388891411, 0.61941436060583455,
+    0.62445001554702673, 0.62952877992483691, 0.63465179928762383, 0.63982027745305681,
+    0.64503548082082263, 0.65029874311081703, 0.6556114705796976, 0.66097514777666344,
+    0.66639134390875043, 0.67186171989708243, 0.67738803621877375, 0.68297216164499508,
+    0.68861608300467203, 0.69432191612611693, 0.70009191813651184, 0.70592850133275453,
+    0.71183424887824864, 0.71781193263072218, 0.72386453346863044, 0.72999526456147645,
+    0.73620759812686298, 0.74250529634015139, 0.74889244721915715, 0.75537350650709645,
+    0.7619533468367955, 0.76863731579848649, 0.7754313049811874, 0.78234183265480273,
+    0.78937614356602492, 0.7965423304229593, 0.80384948317096472, 0.81130787431265672,
+    0.81892919160370292, 0.82672683394622204, 0.8347162929868841, 0.84291565311220484,
+    0.85134625845867862, 0.8600336211963322, 0.86900868803685771, 0.87830965580891807,
+    0.88798466075583415, 0.89809592189834431, 0.90872644005213177, 0.91999150503934801,
+    0.93206007595923157, 0.94519895344230087, 0.95987909180010811, 0.97710170126767337,
+    1
+};
+
+static const double lua_pcg_ziggurat_exponential_x[LUA_PCG_ZIGGURAT_LAYERS + 1] =
+{
+    8.697117470131051, 7.6971174701310501, 6.9410336293772126, 6.4783784938325697,
+    6.1441646657724727, 5.8821443157953999, 5.6664101674540337, 5.4828906275260625,
+    5.323090505754398, 5.1814872813015, 5.0542884899813041, 4.9387770859012505,
+    4.832939741025112, 4.7352429966017411, 4.6444918854200852, 4.5597370617073514,
+    4.4802117465284219, 4.4052876934735732, 4.334443680317273, 4.2672424802773659,
+    4.2033137137351844, 4.1423408656640515, 4.0840513104082978, 4.0282085446479368,
+    3.9746060666737888, 3.9230625001354897, 3.8734176703995091, 3.8255294185223367,
+    3.7792709924116679, 3.7345288940397974, 3.6912010902374188, 3.6491955157608538,
+    3.6084288131289095, 3.568825265648337, 3.5303158891293434, 3.4928376547740596,
+    3.4563328211327602, 3.4207483572511199, 3.386035442460301, 3.3521490309001094,
+    3.319047470970748, 3.2866921715990687, 3.2550473085704499, 3.2240795652862642,
+    3.1937579032122403, 3.1640533580259729, 3.1349388580844404, 3.1063890623398245,
+    3.0783802152540902, 3.0508900166154551, 3.0238975044556766, 2.9973829495161306,
+    2.9713277599210897, 2.9457143948950457, 2.9205262865127408, 2.8957477686001418,
+    2.8713640120155364, 2.8473609656351888, 2.8237253024500353, 2.8004443702507378,
+    2.7775061464397566, 2.7548991965623446, 2.7326126361947001, 2.7106360958679288,
+    2.6889596887418037, 2.6675739807732666, 2.6464699631518092, 2.6256390267977885,
+    2.6050729387408356, 2.5847638202141408, 2.5647041263169053, 2.54488662711187,
+    2.525304390037828, 2.505950763528594, 2.4868193617402095, 2.4679040502973648,
+    2.4491989329782498, 2.4306983392644197, 2.4123968126888706, 2.3942890999214579,
+    2.3763701405361406, 2.3586350574093373, 2.3410791477030344, 2.3236978743901964,
+    2.3064868582835798, 2.2894418705322694, 2.2725588255531548, 2.2558337743672192,
+    2.239262898312909, 2.2228425031110368, 2.2065690132576639, 2.19043896672322,
+    2.1744490099377747, 2.158595893043886, 2.142876465399842, 2.1272876713173683,
+    2.1118265460190422, 2.096490211801715, 2.0812758743932251, 2.0661808194905755,
+    2.0512024094685848, 2.0363380802487696, 2.0215853383189262, 2.0069417578945186,
+    1.9924049782135766, 1.9779727009573604, 1.9636426877895483, 1.9494127580071849,
+    1.9352807862970514, 1.9212447005915281, 1.9073024800183875, 1.8934521529393082,
+    1.8796917950722112, 1.866019527692828, 1.8524335159111756, 1.83893196701888,
+    1.8255131289035198, 1.8121752885263906, 1.7989167704602909, 1.785735935484126,
+    1.7726311792313056, 1.7596009308890748, 1.7466436519460744, 1.7337578349855716,
+    1.7209420025219353, 1.7081947058780578, 1.6955145241015379, 1.6829000629175539,
+    1.6703499537164521, 1.6578628525741728, 1.6454374393037237, 1.6330724165359913,
+    1.6207665088282579, 1.6085184617988584, 1.5963270412864834, 1.5841910325326889,
+    1.5721092393862297, 1.5600804835278881, 1.5481036037145135, 1.5361774550410321,
+    1.5243009082192263, 1.5124728488721171, 1.5006921768428167, 1.4889578055167461,
+    1.4772686611561339, 1.4656236822457454, 1.4540218188487934, 1.4424620319720125,
+    1.4309432929388797, 1.4194645827699832, 1.4080248915695357, 1.3966232179170421,
+    1.3852585682631222, 1.3739299563284908, 1.362636402505087, 1.3513769332583354,
+    1.3401505805295051, 1.328956381137117, 1.3177933761763252, 1.3066606104151746,
+    1.2955571316866015, 1.2844819902750131, 1.2734342382962416, 1.2624129290696158,
+    1.251417116480853, 1.240445854334407, 1.2294981956938498, 1.218573192208791,
+    1.2076698934267622, 1.196787346088404, 1.1859245934042031, 1.1750806743109123,
+    1.1642546227056796, 1.1534454666557754, 1.1426522275816735, 1.1318739194110792,
+    1.1211095477013311, 1.1103581087274119, 1.0996185885325982, 1.0888899619385479,
+    1.0781711915113732, 1.0674612264799688, 1.0567590016025523, 1.0460634359770451,
+    1.0353734317905294, 1.0246878730026183, 1.0140056239570978, 1.0033255279156981,
+    0.99264640550727723, 0.98196705308506393, 0.97128624098390481, 0.96060271166866795,
+    0.94991517776407741, 0.93922231995526384, 0.92852278474721195, 0.91781518207004575,
+    0.90709808271569181, 0.89637001558989149, 0.88562946476175308, 0.87487486629102673,
+    0.86410460481100604, 0.85331700984237491, 0.84251035181037004, 0.83168283773427465,
+    0.82083260655441337, 0.80995772405741995, 0.79905617735548873, 0.7881258688694941,
+    0.77716460975913126, 0.76617011273543623, 0.7551399841819838, 0.74407171550050955,
+    0.73296267358436695, 0.72181009030875776, 0.71061105090965648, 0.6993624811032334,
+    0.68806113277374936, 0.67670356802952414, 0.66528614139267939, 0.6538049798476665,
+    0.64225596042453792, 0.63063468493349195, 0.61893645139487774, 0.60715622162030169,
+    0.59528858429150444, 0.58332771274877115, 0.57126731653258989, 0.55910058551154218,
+    0.54682012516331213, 0.53441788123716705, 0.52188505159213661, 0.50921198244365595,
+    0.4963880455186726, 0.4834014916534633, 0.47023927508217045, 0.45688684093142179,
+    0.44332786607355412, 0.42954394022541259, 0.41551416960035825, 0.4012146788962796,
+    0.3866179779411214, 0.37169214532991918, 0.3563997602583957, 0.34069648106485118,
+    0.32452911701691145, 0.30783295467493427, 0.29052795549123261, 0.27251318547846703,
+    0.25365836338591446, 0.23379048305967726, 0.21267151063096923, 0.18995868962243467,
+    0.16512762256419042, 0.13730498094001628, 0.10483850756582322, 0.063852163815007607,
+    0
+};
+
+static const double lua_pcg_ziggurat_exponential_f[LUA_PCG_ZIGGURAT_LAYERS + 1] =
+{
+    0.00016706669230796367, 0.0004541343538414966, 0.00096726928232717432, 0.0015362997803015726,
+    0.0021459677437189071, 0.0027887987935740757, 0.003460264777836904, 0.004157295120833797,
+    0.0048776559835423958, 0.0056196422072054891, 0.0063819059373191834, 0.0071633531836349908,
+    0.0079630774380170435, 0.008780314985808977, 0.0096144136425022116, 0.010464810181029981,
+    0.0113310135978346, 0.012212592426255378, 0.013109164931254991, 0.014020391403181943,
+    0.014945968011691148, 0.015885621839973156, 0.016839106826039941, 0.017806200410911355,
+    0.018786700744696024, 0.01978042433800974, 0.020787204072578114, 0.021806887504283581,
+    0.02283933540638524, 0.023884420511558174, 0.024942026419731787, 0.026012046645134221,
+    0.027094383780955803, 0.028188948763978646, 0.029295660224637411, 0.030414443910466622,
+    0.031545232172893622, 0.032687963508959555, 0.033842582150874358, 0.035009037697397431,
+    0.036187284781931443, 0.037377282772959382, 0.038578995503074871, 0.039792391023374139,
+    0.04101744138041484, 0.042254122413316254, 0.043502413568888197, 0.044762297732943289,
+    0.046033761076175184, 0.047316792913181561, 0.048611385573379504, 0.049917534282706379,
+    0.051235237055126281, 0.052564494593071685, 0.05390531019604608, 0.05525768967669703,
+    0.05662164128374287, 0.057997175631200659, 0.05938430563342028, 0.06078304644547966,
+    0.062193415408541036, 0.063615431999807376, 0.065049117786753805, 0.066494496385339816,
+    0.067951593421936643, 0.069420436498728783, 0.070901055162371843, 0.072393480875708752,
+    0.073897746992364746, 0.07541388873405841, 0.076941943170480517, 0.078481949201606435,
+    0.080033947542319905, 0.081597980709237419, 0.083174093009632397, 0.084762330532368146,
+    0.086362741140756927, 0.087975374467270231, 0.089600281910032886, 0.091237516631040197,
+    0.092887133556043569, 0.094549189376055873, 0.096223742550432825, 0.097910853311492213,
+    0.099610583670637132, 0.10132299742595363, 0.1030481601712577, 0.10478613930657016,
+    0.10653700405000163, 0.10830082545103376, 0.11007767640518536, 0.11186763167005628,
+    0.11367076788274429, 0.11548716357863351, 0.11731689921155553, 0.11916005717532764,
+    0.12101672182667479, 0.12288697950954511, 0.12477091858083093, 0.12666862943751067,
+    0.1285802045452282, 0.13050573846833077, 0.13244532790138749, 0.1343990717022136,
+    0.13636707092642883, 0.13834942886358018, 0.1403462510748624, 0.14235764543247215,
+    0.14438372216063472, 0.14642459387834489, 0.14848037564386674, 0.15055118500103984,
+    0.1526371420274428, 0.15473836938446803, 0.15685499236936515, 0.15898713896931413,
+    0.16113493991759195, 0.16329852875190173, 0.16547804187493592, 0.16767361861725008,
+    0.16988540130252755, 0.17211353531531998, 0.17435816917135341, 0.17661945459049483,
+    0.17889754657247828, 0.18119260347549626, 0.18350478709776744, 0.18583426276219708,
+    0.18818119940425426, 0.19054576966319536, 0.1929281499767713, 0.19532852067956319,
+    0.19774706610509882, 0.20018397469191121, 0.20263943909370896, 0.20511365629383765,
+    0.20760682772422198, 0.21011915938898823, 0.21265086199297822, 0.21520215107537863,
+    0.21777324714870047, 0.22036437584335944, 0.22297576805812011, 0.22560766011668396,
+    0.22826029393071662, 0.23093391716962736, 0.23362878343743329, 0.23634515245705956,
+    0.23908329026244909, 0.24184346939887713, 0.24462596913189202, 0.24743107566532754,
+    0.25025908236886218, 0.25311029001562935, 0.25598500703041527, 0.25888354974901606,
+    0.26180624268936281, 0.26475341883506204, 0.26772541993204463, 0.27072259679905986,
+    0.2737453096528028, 0.27679392844851719, 0.27986883323697276, 0.28297041453878063,
+    0.28609907373707671, 0.28925522348967758, 0.29243928816189241, 0.29565170428126097,
+    0.29889292101558151, 0.30216340067569331, 0.30546361924459003, 0.30879406693455996,
+    0.31215524877417938, 0.31554768522712873, 0.31897191284495702, 0.322428484956089,
+    0.32591797239355602, 0.32944096426413616, 0.33299806876180876, 0.33658991402867738,
+    0.34021714906677986, 0.34388044470450224, 0.34758049462163682, 0.35131801643748317,
+    0.35509375286678729, 0.35890847294874956, 0.3627629733548175, 0.36665807978151388,
+    0.37059464843514572, 0.37457356761590188, 0.37859575940958051, 0.3826621814960095,
+    0.38677382908413738, 0.39093173698479677, 0.39513698183328982, 0.39939068447523074,
+    0.40369401253052994, 0.40804818315203206, 0.41245446599716085, 0.41691418643300254,
+    0.42142872899761624, 0.42599954114303401, 0.4306281372884585, 0.43531610321563624,
+    0.44006510084235351, 0.44487687341454812, 0.44975325116275461, 0.45469615747461511,
+    0.4597076156421373, 0.46478975625042579, 0.46994482528395959, 0.47517519303737699,
+    0.48048336393045382, 0.48587198734188453, 0.49134386959403215, 0.49690198724154916,
+    0.50254950184134728, 0.50828977641064244, 0.51412639381474812, 0.52006317736823315,
+    0.52610421398361928, 0.53225388026304277, 0.53851687200286136, 0.54489823767243917,
+    0.55140341654064084, 0.558038282262587, 0.56480919291239973, 0.57172304866482526,
+    0.57878735860284447, 0.58601031847726748, 0.59340090169173287, 0.60096896636523167,
+    0.60872538207962146, 0.61668218091520699, 0.62485273870366531, 0.6332519942143654,
+    0.64189671642726531, 0.65080583341457021, 0.66000084107899892, 0.66950631673192396,
+    0.67935057226476459, 0.6895664961170771, 0.70019265508278727, 0.71127476080507501,
+    0.72286765959357102, 0.73503809243142249, 0.74786862198519399, 0.76146338884989506,
+    0.77595685204011433, 0.79152763697249429, 0.80842165152300693, 0.82699329664304877,
+    0.84778550062398783, 0.87170433238120149, 0.90046992992574371, 0.93814368086217081,
+    1
+};
+
+/* generator of 64 random bits, split into high and low 32-bit words */
+typedef void (*lua_pcg_words_fn)(void *rng, lua_pcg_u32 *high, lua_pcg_u32 *low);
+
+/*
+** draws the layer (low 8 bits), the sign (bit 8) and
+** a uniform u in [0, 1) (upper 53 bits) of a ziggurat draw
+*/
+static unsigned int lua_pcg_ziggurat_draw(lua_pcg_words_fn words, void *rng, double *u)
+{
+    lua_pcg_u32 high;
+    lua_pcg_u32 low;
+
+    words(rng, &high, &low);
+    *u = (((double)high) * 2097152.0 + ((double)(low >> 11U))) * LUA_PCG_DOUBLE_SCALE;
+    return (unsigned int)(low & 0x1FF);
+}
+
+/* generates a standard normal number through the ziggurat method */
+static double lua_pcg_ziggurat_normal(lua_pcg_words_fn words, lua_pcg_uniform_fn uniform, void *rng)
+{
+    unsigned int bits;
+    int i;
+    double u, x, y;
+    const double *zx = lua_pcg_ziggurat_normal_x;
+    const double *zf = lua_pcg_ziggurat_normal_f;
+
+    for (;;)
+    {
+        bits = lua_pcg_ziggurat_draw(words, rng, &u);
+        i = (int)(bits & 0xFF);
+        x = u * zx[i];
+
+        /* rectangle */
+        if (x < zx[i + 1])
+        {
+            break;
+        }
+
+        /* tail */
+        if (i == 0)
+        {
+            do
+            {
+                x = -log(uniform(rng)) / LUA_PCG_ZIGGURAT_NORMAL_R;
+                y = -log(uniform(rng));
+            } while (y + y < x * x);
+            x += LUA_PCG_ZIGGURAT_NORMAL_R;
+            break;
+        }
+
+        /* wedge */
+        y = zf[i] + (1.0 - uniform(rng)) * (zf[i + 1] - zf[i]);
+        if (y < exp(-0.5 * x * x))
+        {
+            break;
+        }
+    }
+
+    return (bits & 0x100) ? -x : x;
+}
+
+/* generates a standard exponential number through the ziggurat method */
+static double lua_pcg_ziggurat_exponential(lua_pcg_words_fn words, lua_pcg_uniform_fn uniform, void *rng)
+{
+    int i;
+    double u, x, y;
+    const double *zx = lua_pcg_ziggurat_exponential_x;
+    const double *zf = lua_pcg_ziggurat_exponential_f;
+
+    for (;;)
+    {
+        i = (int)(lua_pcg_ziggurat_draw(words, rng, &u) & 0xFF);
+        x = u * zx[i];
+
+        /* rectangle */
+        if (x < zx[i + 1])
+        {
+            return x;
+        }
+
+        /* tail, which is the exponential distribution shifted by r */
+        if (i == 0)
+        {
+            return LUA_PCG_ZIGGURAT_EXPONENTIAL_R - log(uniform(rng));
+        }
+
+        /* wedge */
+        y = zf[i] + (1.0 - uniform(rng)) * (zf[i + 1] - zf[i]);
+        if (y < exp(-x))
+        {
+            return x;
+        }
+    }
+}
+
+/*
+** pushes (offset + scale * z), where z is a standard normal
+** (or exponential) number, or a table holding count of such
+** numbers when an integer count is given at stack position 'index'
+*/
+static int lua_pcg_ziggurat_push(lua_State *L, int index, int normal, lua_pcg_words_fn words, lua_pcg_uniform_fn uniform, void *rng, lua_Number offset, lua_Number scale)
+{
+    lua_Integer count;
+    lua_pcg_table_index key;
+
+    if (lua_isnoneornil(L, index))
+    {
+        lua_pushnumber(L, offset + scale * ((lua_Number)(normal ? lua_pcg_ziggurat_normal(words, uniform, rng) : lua_pcg_ziggurat_exponential(words, uniform, rng))));
+        return 1;
+    }
+
+    count = luaL_checkinteger(L, index);
+    luaL_argcheck(L, 0 <= count && count <= LUA_PCG_TABLE_INDEX_MAX, index, "n is out of range");
+
+    lua_createtable(L, count <= INT_MAX ? (int)count : 0, 0);
+    for (key = 0; key < (lua_pcg_table_index)count;)
+    {
+        key++;
+        lua_pushnumber(L, offset + scale * ((lua_Number)(normal ? lua_pcg_ziggurat_normal(words, uniform, rng) : lua_pcg_ziggurat_exponential(words, uniform, rng))));
+        lua_rawseti(L, -2, key);
+    }
+    return 1;
+}
+
+/*
+** Parses the optional arguments (a [, b])
+** used to generate floating-point numbers,
+** starting at stack position 'index',
+** where 'nargs' is the number of arguments provided.
+** 
+** The numbers are generated as (offset + scale * u),
+** where u is a number in the range [0, 1).
+** When no arguments are given, offset is set to 0
+** and scale to 1. When a single argument is given,
+** it is the upper limit b, offset is set to 0
+** and scale to b. When two arguments are given,
+** offset is set to a and scale to (b - a).
+*/
+static void lua_pcg_parse_real_bounds(lua_State *L, int index, int nargs, const char *name, lua_Number *offset, lua_Number *scale)
+{
+    lua_Number a, b, c;
+
+    switch (nargs)
+    {
+        case 0: /* no args? */
+        {
+            *offset = 0;
+            *scale = 1;
+            break;
+        }
+        case 1: /* upper limit is given */
+        {
+            b = luaL_checknumber(L, index);
+            luaL_argcheck(L, 0 < b, index, "b must be a positive number");
+            luaL_argcheck(L, (b - b) == 0, index, "b must be a finite number");
+            *offset = 0;
+            *scale = b;
+            break;
+        }
+        case 2: /* a, b were provided */
+        {
+            a = luaL_checknumber(L, index);
+            b = luaL_checknumber(L, index + 1);
+            luaL_argcheck(L, a < b, index, "a cannot be greater than or equal to b");
+
+            c = b - a;
+            luaL_argcheck(L, (c - c) == 0, index, "the number (b - a) must be finite");
+            *offset = a;
+            *scale = c;
+            break;
+        }
+        default:
+        {
+            luaL_error(L, "Unknown number of arguments to generate a next floating-point number from %s", name);
+            break;
+        }
+    }
+}
+
+/*
+** Union holding the strictest alignment
+** required by the rng structures,
+** notably the native __int128 on pcg64.
+*/
+typedef union
+{
+    lua_pcg_u128 u128;
+    lua_pcg_u64 u64;
+    double d;
+    void *p;
+} lua_pcg_max_align_t;
+
+#define LUA_PCG_MAX_ALIGN (sizeof(lua_pcg_max_align_t))
+
+/*
+** Creates a userdata made of 'header' bytes
+** followed by a block of 'size' bytes aligned
+** to LUA_PCG_MAX_ALIGN, which is returned on 'block'.
+** 
+** Note: 'lua_newuserdata' does not
+**       guarantee the alignment required by __int128
+**       (see https://github.com/LuaJIT/LuaJIT/issues/1161 ).
+**       Thus, the userdata is over-allocated by
+**       (LUA_PCG_MAX_ALIGN - 1) bytes, and the block
+**       is placed on the first aligned address after the header.
+*/
+static void *lua_pcg_newuserdata_aligned(lua_State *L, size_t header, size_t size, void **block)
+{
+    size_t misalignment;
+    unsigned char *ud = (unsigned char *)lua_newuserdata(L, header + size + LUA_PCG_MAX_ALIGN - 1);
+
+    if (ud != NULL)
+    {
+        misalignment = ((size_t)(ud + header)) % LUA_PCG_MAX_ALIGN;
+        *block = (void *)(ud + header + (misalignment == 0 ? 0 : LUA_PCG_MAX_ALIGN - misalignment));
+    }
+    return (void *)ud;
+}
+
+/*
+** registers the functions of 'funcs' on the table at the
+** top of the stack as C closures holding that table as upvalue
+*/
+static void lua_pcg_setfuncs_upvalue(lua_State *L, const luaL_Reg *funcs)
+{
+    for (; funcs->name != NULL; funcs++)
+    {
+        lua_pushstring(L, funcs->name);
+        lua_pushvalue(L, -2);
+        lua_pushcclosure(L, funcs->func, 1);
+        lua_settable(L, -3);
+    }
+}
+
+/* end of utility functions */
+
+/* 
+** *********************************************
+** *********************************************
+** 
+** Now that pcg32 methods were implemented,
+** we are going to bridge it to Lua.
+** 
+** *********************************************
+** *********************************************
+*/
+
+/*
+** Structure to wrap a lua_pcg32_random_t
+** 
+** The rng is stored inline, on the same userdata
+** right after the wrapper, on an address aligned
+** by lua_pcg_newuserdata_aligned. Thus, creating
+** a pcg32 instance takes a single allocation and
+** no finalizer. 'rng' is set to NULL by 'close'.
+** 
+** 'bits' caches the 'nbits' output bits of the rng
+** not consumed yet by the methods 'bits' and 'bool'.
+*/
+typedef struct
+{
+    lua_pcg32_random_t *rng;
+    lua_pcg_u32 bits;
+    unsigned int nbits;
+} lua_pcg32_random_t_wrapper;
+
+static lua_pcg32_random_t_wrapper *lua_pcg_pcg32_check(lua_State *L, int index)
+{
+    void *ud = luaL_checkudata(L, index, LUA_PCG_PCG32_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "pcg32 random expected");
+    return (lua_pcg32_random_t_wrapper *)ud;
+}
+
+static lua_pcg32_random_t_wrapper *lua_pcg_pcg32_check_open(lua_State *L, int index)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check(L, index);
+    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg32 random was closed previously");
+    return wrapper;
+}
+
+static lua_pcg32_random_t *lua_pcg_pcg32_check_rng(lua_State *L, int index)
+{
+    return lua_pcg_pcg32_check_open(L, index)->rng;
+}
+
+/*
+** pushes a new pcg32 userdata on the stack,
+** holding the lua_pcg32_random_t (rng) that it wraps.
+** The state of the rng is left uninitialized.
+*/
+static lua_pcg32_random_t_wrapper *lua_pcg_pcg32_push(lua_State *L)
+{
+    void *block;
+    lua_pcg32_random_t_wrapper *wrapper;
+    void *ud = lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg32_random_t_wrapper), sizeof(lua_pcg32_random_t), &block);
+    if (ud == NULL)
+    {
+        luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32 random");
+        return NULL;
+    }
+    wrapper = (lua_pcg32_random_t_wrapper *)ud;
+    wrapper->rng = (lua_pcg32_random_t *)block;
+    wrapper->bits = 0U;
+    wrapper->nbits = 0U;
+    luaL_getmetatable(L, LUA_PCG_PCG32_METATABLE);
+    lua_setmetatable(L, -2);
+    return wrapper;
+}
+
+/* creates a lua_pcg32_random_t (rng) */
+static int lua_pcg_pcg32_new(lua_State *L)
+{
+    lua_pcg_u128 v1;
+    lua_pcg_u128 v2;
+    lua_pcg_u64 initstate;
+    lua_pcg_u64 initseq;
+    lua_pcg32_random_t_wrapper *wrapper;
+    lua_pcg32_random_t *rng;
+    void *ud;
+    int nargs;
+
+    nargs = lua_gettop(L);
+    wrapper = lua_pcg_pcg32_push(L);
+    ud = (void *)wrapper;
+    rng = wrapper->rng;
+
+    switch (nargs)
+    {
+        case 0: /* no args? generate both initstate and initseq */
+        {
+            lua_pcg_fill_with_random_bytes(ud, &v1, &v2);
+            initstate = lua_pcg_u128_cast_to_u64(v1);
+            initseq = lua_pcg_u128_cast_to_u64(v2);
+            break;
+        }
+        case 1: /* only initstate was provided? then generate initseq */
+        {
+            initstate = lua_pcg_parse_u64_arg(L, 1);
+            lua_pcg_fill_with_random_bytes(ud, NULL, &v2);
+            initseq = lua_pcg_u128_cast_to_u64(v2);
+            break;
+        }
+        case 2: /* both initstate and initseq were provided */
+        {
+            initstate = lua_pcg_parse_u64_arg(L, 1);
+            initseq = lua_pcg_parse_u64_arg(L, 2);
+            break;
+        }
+        default:
+        {
+            return luaL_error(L, "Unknown number of arguments to create a pcg32 instance");
+        }
+    }
+
+    lua_pcg32_srandom_r(rng, initstate, initseq);
+    return 1;
+}
+
+/* advances a lua_pcg32_random_t (rng) by delta */
+static int lua_pcg_pcg32_advance(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check_open(L, 1);
+    lua_pcg_u64 delta = lua_pcg_parse_u64_arg(L, 2);
+    lua_pcg32_advance_r(wrapper->rng, delta);
+    wrapper->bits = 0U;
+    wrapper->nbits = 0U;
+    return 0;
+}
+
+/* seed the pcg32 rng */
+static int lua_pcg_pcg32_seed(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check_open(L, 1);
+    lua_pcg_u64 initstate = lua_pcg_parse_u64_arg(L, 2);
+    lua_pcg_u64 initseq = lua_pcg_parse_u64_arg(L, 3);
+    lua_pcg32_srandom_r(wrapper->rng, initstate, initseq);
+    wrapper->bits = 0U;
+    wrapper->nbits = 0U;
+    return 0;
+}
+
+/*
+** The state of the pcg32 rng is serialized as a binary string
+** of 21 bytes: the 64-bit state, the 64-bit increment (inc)
+** and the 32-bit cache of the methods 'bits' and 'bool',
+** all of them in little-endian byte order, followed by
+** a byte holding the number of cached bits.
+** Thus, the same string is produced on native and emulated builds.
+*/
+#define LUA_PCG_PCG32_STATE_SIZE 21
+
+/* parses the binary state at stack position 'index' into the rng and its bit cache */
+static void lua_pcg_pcg32_parse_state(lua_State *L, int index, lua_pcg32_random_t *rng, lua_pcg_u32 *bits, unsigned int *nbits)
+{
+    size_t len;
+    lua_pcg_u32 cached;
+    unsigned int ncached;
+    const unsigned char *s = (const unsigned char *)luaL_checklstring(L, index, &len);
+
+    luaL_argcheck(L, len == LUA_PCG_PCG32_STATE_SIZE, index, "state must be a string holding 21 bytes");
+    luaL_argcheck(L, (s[8] & 1U) != 0, index, "state holds an even increment");
+
+    cached = ((lua_pcg_u32)s[16]) | (((lua_pcg_u32)s[17]) << 8) | (((lua_pcg_u32)s[18]) << 16) | (((lua_pcg_u32)s[19]) << 24);
+    ncached = (unsigned int)s[20];
+    luaL_argcheck(L, ncached < 32U && (cached >> ncached) == 0U, index, "state holds an invalid bit cache");
+
+    rng->state = lua_pcg_unpack_u64(s);
+    rng->inc = lua_pcg_unpack_u64(s + 8);
+    *bits = cached;
+    *nbits = ncached;
+}
+
+/* gets the current state of the pcg32 rng as a binary string */
+static int lua_pcg_pcg32_getstate(lua_State *L)
+{
+    int i;
+    lua_pcg_u32 bits;
+    unsigned char buffer[LUA_PCG_PCG32_STATE_SIZE];
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check_open(L, 1);
+
+    lua_pcg_pack_u64(buffer, wrapper->rng->state);
+    lua_pcg_pack_u64(buffer + 8, wrapper->rng->inc);
+    for (i = 16, bits = wrapper->bits; i < 20; i++, bits >>= 8)
+    {
+        buffer[i] = lua_pcg_u8_cast(bits);
+    }
+    buffer[20] = (unsigned char)wrapper->nbits;
+    lua_pushlstring(L, (const char *)buffer, LUA_PCG_PCG32_STATE_SIZE);
+    return 1;
+}
+
+/* restores the state of the pcg32 rng from a binary string */
+static int lua_pcg_pcg32_setstate(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check_open(L, 1);
+    lua_pcg_pcg32_parse_state(L, 2, wrapper->rng, &(wrapper->bits), &(wrapper->nbits));
+    return 0;
+}
+
+/* creates a lua_pcg32_random_t (rng) from a binary string */
+static int lua_pcg_pcg32_fromstate(lua_State *L)
+{
+    lua_pcg32_random_t state;
+    lua_pcg_u32 bits;
+    unsigned int nbits;
+    lua_pcg32_random_t_wrapper *wrapper;
+
+    lua_pcg_pcg32_parse_state(L, 1, &state, &bits, &nbits);
+    wrapper = lua_pcg_pcg32_push(L);
+    *(wrapper->rng) = state;
+    wrapper->bits = bits;
+    wrapper->nbits = nbits;
+    return 1;
+}
+
+/*
+** splits the pcg32 rng into a table of k new generators.
+** 
+** Without delta, child i is seeded with an initstate
+** drawn from the parent and the stream (base + i),
+** where base is drawn once from the parent, such that
+** the k children have pairwise distinct increments.
+** 
+** With delta, every child shares the stream of the parent:
+** child i starts at the position (i * delta) of the parent,
+** which is moved past the k non-overlapping blocks
+** of delta values handed over to the children.
+*/
+static int lua_pcg_pcg32_split(lua_State *L)
+{
+    lua_pcg_u32 low;
+    lua_pcg_u32 high;
+    lua_pcg_u64 base;
+    lua_pcg_u64 delta;
+    lua_pcg_u64 initstate;
+    lua_Integer i;
+    lua_pcg32_random_t *child;
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Integer k = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 1 <= k && k <= LUA_PCG_TABLE_INDEX_MAX, 2, "k is out of range");
+    luaL_argcheck(L, nargs <= 3, 4, "too many arguments");
+
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 0);
+    if (nargs == 3)
+    {
+        delta = lua_pcg_parse_u64_arg(L, 3);
+        for (i = 0; i < k; i++)
+        {
+            child = lua_pcg_pcg32_push(L)->rng;
+            *child = *rng;
+            lua_rawseti(L, -2, (lua_pcg_table_index)(i + 1));
+            lua_pcg32_advance_r(rng, delta);
+        }
+    }
+    else
+    {
+        low = lua_pcg32_random_r(rng);
+        high = lua_pcg32_random_r(rng);
+        base = lua_pcg_u64_lh(low, high);
+        for (i = 0; i < k; i++)
+        {
+            low = lua_pcg32_random_r(rng);
+            high = lua_pcg32_random_r(rng);
+            initstate = lua_pcg_u64_lh(low, high);
+            child = lua_pcg_pcg32_push(L)->rng;
+            lua_pcg32_srandom_r(child, initstate, base);
+            lua_rawseti(L, -2, (lua_pcg_table_index)(i + 1));
+
+            /* base = base + 1 */
+            base = lua_pcg_u64_sum(base, lua_pcg_u64_lh(1U, 0U));
+        }
+    }
+    return 1;
+}
+
+/*
+** Parses the optional arguments (a [, b])
+** of the pcg32 rng starting at stack position 'index',
+** where 'nargs' is the number of arguments provided.
+** 
+** When a single argument is given, it is the bound,
+** and offset is set to 0. When two arguments
+** are given, bound is set to (b - a) and offset to a.
+** 
+** return value:
+**    0: no arguments were provided
+**    1: bound and offset were filled
+*/
+static int lua_pcg_pcg32_parse_bounds(lua_State *L, int index, int nargs, lua_pcg_u32 *bound, lua_Integer *offset)
+{
+    int res = 0;
+    lua_Integer a, b, c;
+
+    switch (nargs)
+    {
+        case 0: /* no args? */
+        {
+            break;
+        }
+        case 1: /* bound is given */
+        {
+            a = luaL_checkinteger(L, index);
+            luaL_argcheck(L, 0 < a && a <= 0xFFFFFFFF, index, "bound is out of [1, 4294967295] range");
+            *bound = lua_pcg_u32_cast(a);
+            *offset = 0;
+            res = 1;
+            break;
+        }
+        case 2: /* a, b were provided */
+        {
+            a = luaL_checkinteger(L, index);
+            b = luaL_checkinteger(L, index + 1);
+            luaL_argcheck(L, a < b, index, "a cannot be greater than or equal to b");
+
+            c = b - a;
+            luaL_argcheck(L, c <= 0xFFFFFFFF, index, "the integer (b - a) is out of [1, 4294967295] range");
+            *bound = lua_pcg_u32_cast(c);
+            *offset = a;
+            res = 1;
+            break;
+        }
+        default:
+        {
+            luaL_error(L, "Unknown number of arguments to generate a next number from pcg32");
+            break;
+        }
+    }
+
+    return res;
+}
+
+/*
+** Generates 'count' values from the pcg32 rng,
+** storing them on the table located at stack
+** position 'index', starting at key 'first'.
+*/
+static void lua_pcg_pcg32_fill_table(lua_State *L, lua_pcg32_random_t *rng, int index, lua_pcg_table_index first, lua_Integer count, int has_bounds, lua_pcg_u32 bound, lua_Integer offset)
+{
+    lua_Integer k;
+    lua_pcg_table_index key = first - 1;
+
+    if (has_bounds)
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushinteger(L, offset + ((lua_Integer)lua_pcg32_boundedrand_r(rng, bound)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+    else
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushinteger(L, (lua_Integer)lua_pcg32_random_r(rng));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+}
+
+/*
+** checks whether the value at stack position 'index'
+** is a pcg32 random, comparing its metatable against
+** the metatable cached as the first upvalue
+** of the running C function, which avoids looking up
+** the metatable by name on the registry.
+*/
+static lua_pcg32_random_t_wrapper *lua_pcg_pcg32_check_open_upvalue(lua_State *L, int index)
+{
+    lua_pcg32_random_t_wrapper *wrapper = (lua_pcg32_random_t_wrapper *)lua_touserdata(L, index);
+
+    if (wrapper == NULL || !lua_getmetatable(L, index) || !lua_rawequal(L, -1, lua_upvalueindex(1)))
+    {
+        /* raises the usual error */
+        return lua_pcg_pcg32_check_open(L, index);
+    }
+    lua_pop(L, 1);
+
+    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg32 random was closed previously");
+    return wrapper;
+}
+
+static lua_pcg32_random_t *lua_pcg_pcg32_check_rng_upvalue(lua_State *L, int index)
+{
+    return lua_pcg_pcg32_check_open_upvalue(L, index)->rng;
+}
+
+/* gets the next lua_pcg_u32 value from the pcg32 rng */
+static int lua_pcg_pcg32_next0(lua_State *L, lua_pcg32_random_t *rng)
+{
+    lua_pcg_u32 n = lua_pcg32_random_r(rng);
+    lua_pushinteger(L, (lua_Integer)n);
+    return 1;
+}
+
+/* gets the next lua_pcg_u32 value from the pcg32 rng in [0, bound) */
+static int lua_pcg_pcg32_next1(lua_State *L, lua_pcg32_random_t *rng)
+{
+    lua_pcg_u32 n;
+    lua_pcg_u32 bound;
+    lua_Integer offset;
+
+    lua_pcg_pcg32_parse_bounds(L, 2, 1, &bound, &offset);
+    n = lua_pcg32_boundedrand_r(rng, bound);
+    lua_pushinteger(L, ((lua_Integer)n));
+    return 1;
+}
+
+/* gets the next lua_pcg_u32 value from the pcg32 rng in [a, b) */
+static int lua_pcg_pcg32_next2(lua_State *L, lua_pcg32_random_t *rng)
+{
+    lua_pcg_u32 n;
+    lua_pcg_u32 bound;
+    lua_Integer offset;
+
+    lua_pcg_pcg32_parse_bounds(L, 2, 2, &bound, &offset);
+    n = lua_pcg32_boundedrand_r(rng, bound);
+    lua_pushinteger(L, offset + ((lua_Integer)n));
+    return 1;
+}
+
+/*
+** gets the next lua_pcg_u32 value from the pcg32 rng,
+** dispatching on the number of arguments
+** 
+** Note: this function is registered as a C closure
+** holding the pcg32 metatable as its first upvalue.
+*/
+static int lua_pcg_pcg32_next(lua_State *L)
+{
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng_upvalue(L, 1);
+
+    switch (nargs)
+    {
+        case 1:
+        {
+            return lua_pcg_pcg32_next0(L, rng);
+        }
+        case 2:
+        {
+            return lua_pcg_pcg32_next1(L, rng);
+        }
+        case 3:
+        {
+            return lua_pcg_pcg32_next2(L, rng);
+        }
+        default:
+        {
+            return luaL_error(L, "Unknown number of arguments to generate a next number from pcg32");
+        }
+    }
+}
+
+/*
+** precomputed parameters of a bounded sampler
+** created by the method 'sampler' of pcg32
+*/
+typedef struct
+{
+    lua_pcg_u32 bound;
+    lua_pcg_u32 threshold;
+    lua_Integer offset;
+} lua_pcg_pcg32_sampler_t;
+
+/*
+** draws values in [a, b) from the pcg32 rng
+** of a sampler, either one at a time (no args)
+** or n at once stored on a new table.
+** 
+** Note: this function is registered as a C closure
+** holding the pcg32 userdata as its first upvalue
+** and the lua_pcg_pcg32_sampler_t as its second upvalue.
+*/
+static int lua_pcg_pcg32_sampler_call(lua_State *L)
+{
+    lua_Integer k, n;
+    lua_pcg_table_index key;
+    lua_pcg32_random_t_wrapper *wrapper = (lua_pcg32_random_t_wrapper *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pcg_pcg32_sampler_t *sampler = (lua_pcg_pcg32_sampler_t *)lua_touserdata(L, lua_upvalueindex(2));
+    lua_pcg32_random_t *rng = wrapper->rng;
+
+    if (rng == NULL)
+    {
+        return luaL_error(L, "pcg32 random was closed previously");
+    }
+
+    if (lua_gettop(L) == 0)
+    {
+        lua_pushinteger(L, sampler->offset + ((lua_Integer)lua_pcg32_thresholdrand_r(rng, sampler->bound, sampler->threshold)));
+        return 1;
+    }
+
+    n = luaL_checkinteger(L, 1);
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 1, "n is out of range");
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    for (k = 0, key = 0; k < n; k++)
+    {
+        lua_pushinteger(L, sampler->offset + ((lua_Integer)lua_pcg32_thresholdrand_r(rng, sampler->bound, sampler->threshold)));
+        lua_rawseti(L, -2, ++key);
+    }
+    return 1;
+}
+
+/*
+** creates a sampler drawing values in [a, b)
+** from the pcg32 rng, whose bound and threshold
+** are validated and computed only once
+*/
+static int lua_pcg_pcg32_sampler(lua_State *L)
+{
+    lua_pcg_u32 bound;
+    lua_Integer offset;
+    lua_pcg_pcg32_sampler_t *sampler;
+    int nargs = lua_gettop(L);
+
+    lua_pcg_pcg32_check_rng(L, 1);
+    luaL_argcheck(L, nargs == 2 || nargs == 3, 2, "expected a bound, or the integers a and b");
+    lua_pcg_pcg32_parse_bounds(L, 2, nargs - 1, &bound, &offset);
+
+    lua_settop(L, 1);
+    sampler = (lua_pcg_pcg32_sampler_t *)lua_newuserdata(L, sizeof(lua_pcg_pcg32_sampler_t));
+    if (sampler == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32 sampler");
+    }
+    sampler->bound = bound;
+    sampler->threshold = lua_pcg32_threshold(bound);
+    sampler->offset = offset;
+
+    lua_pushcclosure(L, lua_pcg_pcg32_sampler_call, 2);
+    return 1;
+}
+
+/*
+** parameters of an iterator created
+** by the method 'iter' of pcg32
+*/
+typedef struct
+{
+    lua_Integer count;
+    int has_bounds;
+    lua_pcg_pcg32_sampler_t sampler;
+} lua_pcg_pcg32_iter_t;
+
+/*
+** the iterator function of a generic for
+** created by the method 'iter' of pcg32,
+** which receives the previous index as the
+** control variable and returns the next index
+** and the next value from the pcg32 rng.
+** 
+** Note: this function is registered as a C closure
+** holding the pcg32 userdata as its first upvalue
+** and the lua_pcg_pcg32_iter_t as its second upvalue.
+*/
+static int lua_pcg_pcg32_iter_call(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = (lua_pcg32_random_t_wrapper *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pcg_pcg32_iter_t *iter = (lua_pcg_pcg32_iter_t *)lua_touserdata(L, lua_upvalueindex(2));
+    lua_pcg32_random_t *rng = wrapper->rng;
+    lua_Integer i = lua_tointeger(L, 2);
+
+    if (rng == NULL)
+    {
+        return luaL_error(L, "pcg32 random was closed previously");
+    }
+
+    if (i >= iter->count)
+    {
+        return 0;
+    }
+
+    lua_pushinteger(L, i + 1);
+    if (iter->has_bounds)
+    {
+        lua_pushinteger(L, iter->sampler.offset + ((lua_Integer)lua_pcg32_thresholdrand_r(rng, iter->sampler.bound, iter->sampler.threshold)));
+    }
+    else
+    {
+        lua_pushinteger(L, (lua_Integer)lua_pcg32_random_r(rng));
+    }
+    return 2;
+}
+
+/*
+** creates an iterator for a generic for
+** yielding the index and n values from the pcg32 rng
+*/
+static int lua_pcg_pcg32_iter(lua_State *L)
+{
+    lua_pcg_u32 bound = 0U;
+    lua_Integer offset = 0;
+    int has_bounds;
+    lua_pcg_pcg32_iter_t *iter;
+    int nargs = lua_gettop(L);
+    lua_Integer n;
+
+    lua_pcg_pcg32_check_rng(L, 1);
+    n = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, 0 <= n, 2, "n must be a non-negative integer");
+    has_bounds = lua_pcg_pcg32_parse_bounds(L, 3, nargs - 2, &bound, &offset);
+
+    lua_settop(L, 1);
+    iter = (lua_pcg_pcg32_iter_t *)lua_newuserdata(L, sizeof(lua_pcg_pcg32_iter_t));
+    if (iter == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32 iterator");
+    }
+    iter->count = n;
+    iter->has_bounds = has_bounds;
+    iter->sampler.bound = bound;
+    iter->sampler.threshold = has_bounds ? lua_pcg32_threshold(bound) : bound;
+    iter->sampler.offset = offset;
+
+    lua_pushcclosure(L, lua_pcg_pcg32_iter_call, 2);
+    lua_pushnil(L);
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+/*
+** takes k (1 <= k <= 32) bits from the bit cache
+** of the pcg32 wrapper, from the lowest to the highest one.
+** A new value is drawn from the rng only when the cache
+** runs out of bits, such that the remaining cached bits
+** become the lowest bits of the result.
+*/
+static lua_pcg_u32 lua_pcg_pcg32_takebits(lua_pcg32_random_t_wrapper *wrapper, unsigned int k)
+{
+    lua_pcg_u32 value, fresh;
+    unsigned int missing;
+
+    if (k <= wrapper->nbits)
+    {
+        if (k == 32U)
+        {
+            value = wrapper->bits;
+            wrapper->bits = 0U;
+        }
+        else
+        {
+            value = wrapper->bits & ((((lua_pcg_u32)1U) << k) - 1U);
+            wrapper->bits >>= k;
+        }
+        wrapper->nbits -= k;
+        return lua_pcg_u32_cast(value);
+    }
+
+    missing = k - wrapper->nbits;
+    fresh = lua_pcg32_random_r(wrapper->rng);
+
+    if (missing == 32U)
+    {
+        value = fresh;
+        wrapper->bits = 0U;
+    }
+    else
+    {
+        value = wrapper->bits | lua_pcg_u32_cast((fresh & ((((lua_pcg_u32)1U) << missing) - 1U)) << wrapper->nbits);
+        wrapper->bits = fresh >> missing;
+    }
+    wrapper->nbits = 32U - missing;
+    return lua_pcg_u32_cast(value);
+}
+
+/* gets k bits from the pcg32 rng as an integer in [0, 2^k) */
+static int lua_pcg_pcg32_bits(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check_open_upvalue(L, 1);
+    lua_Integer k = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 1 <= k && k <= 32, 2, "k is out of [1, 32] range");
+    lua_pushinteger(L, (lua_Integer)lua_pcg_pcg32_takebits(wrapper, (unsigned int)k));
+    return 1;
+}
+
+/* gets a single bit from the pcg32 rng as a boolean */
+static int lua_pcg_pcg32_bool(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check_open_upvalue(L, 1);
+    lua_pushboolean(L, lua_pcg_pcg32_takebits(wrapper, 1U) != 0U);
+    return 1;
+}
+
+/*
+** gets n bytes from the pcg32 rng as a string,
+** following the same byte order of 'nextbytes'
+*/
+static int lua_pcg_pcg32_bytes(lua_State *L)
+{
+    size_t k, chunk, remaining;
+    char *p;
+    luaL_Buffer buffer;
+    unsigned int available = 0U;
+    lua_pcg_u32 n = 0U;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Integer count = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= count, 2, "n must be a non-negative integer");
+    luaL_argcheck(L, ((lua_Integer)((size_t)count)) == count, 2, "n is out of range");
+
+    remaining = (size_t)count;
+    luaL_buffinit(L, &buffer);
+
+    while (remaining > 0U)
+    {
+        p = luaL_prepbuffer(&buffer);
+        chunk = remaining < ((size_t)LUAL_BUFFERSIZE) ? remaining : ((size_t)LUAL_BUFFERSIZE);
+
+        for (k = 0U; k < chunk; k++)
+        {
+            if (available == 0U)
+            {
+                n = lua_pcg32_random_r(rng);
+                available = 4U;
+            }
+
+            p[k] = (char)lua_pcg_u8_cast(n);
+            n >>= 8U;
+            available--;
+        }
+
+        luaL_addsize(&buffer, chunk);
+        remaining -= chunk;
+    }
+
+    luaL_pushresult(&buffer);
+    return 1;
+}
+
+/* creates a table holding n values from the pcg32 rng */
+static int lua_pcg_pcg32_fill(lua_State *L)
+{
+    lua_pcg_u32 bound = 0U;
+    lua_Integer offset = 0;
+    int has_bounds;
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+    has_bounds = lua_pcg_pcg32_parse_bounds(L, 3, nargs - 2, &bound, &offset);
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    lua_pcg_pcg32_fill_table(L, rng, lua_gettop(L), 1, n, has_bounds, bound, offset);
+    return 1;
+}
+
+/*
+** fills a buffer owned by the caller with
+** count elements of elemsize bytes from the pcg32 rng
+*/
+static int lua_pcg_pcg32_fillbuffer(lua_State *L)
+{
+    size_t k, count, elemsize;
+    lua_pcg_u32 low, high;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    unsigned char *dst = lua_pcg_check_buffer(L, 2);
+
+    count = lua_pcg_check_buffer_count(L, 3, 4U, &elemsize);
+
+    if (elemsize == 4U)
+    {
+        for (k = 0U; k < count; k++, dst += 4)
+        {
+            lua_pcg_store_u32(dst, lua_pcg32_random_r(rng));
+        }
+    }
+    else
+    {
+        /* each 64-bit element is made of two consecutive 32-bit values (low, high) */
+        for (k = 0U; k < count; k++, dst += 8)
+        {
+            low = lua_pcg32_random_r(rng);
+            high = lua_pcg32_random_r(rng);
+            lua_pcg_store_u64(dst, lua_pcg_u64_lh(low, high));
+        }
+    }
+
+    return 0;
+}
+
+/*
+** Generates a floating-point number in the range [0, 1)
+** with 53 random bits from two consecutive
+** values (27 bits + 26 bits) of the pcg32 rng
+*/
+static double lua_pcg_pcg32_nextdouble_r(lua_pcg32_random_t *rng)
+{
+    lua_pcg_u32 high = lua_pcg32_random_r(rng) >> 5U;
+    lua_pcg_u32 low = lua_pcg32_random_r(rng) >> 6U;
+    return (((double)high) * 67108864.0 + ((double)low)) * LUA_PCG_DOUBLE_SCALE;
+}
+
+/*
+** Generates a floating-point number in the range [0, 1)
+** with 24 random bits from the pcg32 rng
+*/
+static double lua_pcg_pcg32_nextfloat_r(lua_pcg32_random_t *rng)
+{
+    return ((double)(lua_pcg32_random_r(rng) >> 8U)) * LUA_PCG_FLOAT_SCALE;
+}
+
+/*
+** Generates 'count' floating-point numbers
+** from the pcg32 rng in the range [offset, offset + scale),
+** storing them on the table located at stack
+** position 'index', starting at key 1.
+*/
+static void lua_pcg_pcg32_fill_real_table(lua_State *L, lua_pcg32_random_t *rng, int index, lua_Integer count, int is_double, lua_Number offset, lua_Number scale)
+{
+    lua_Integer k;
+    lua_pcg_table_index key = 0;
+
+    if (is_double)
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg32_nextdouble_r(rng)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+    else
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg32_nextfloat_r(rng)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+}
+
+/* creates a table holding n floating-point numbers from the pcg32 rng */
+static int lua_pcg_pcg32_fill_real(lua_State *L, int is_double)
+{
+    lua_Number offset, scale;
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+    lua_pcg_parse_real_bounds(L, 3, nargs - 2, "pcg32", &offset, &scale);
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    lua_pcg_pcg32_fill_real_table(L, rng, lua_gettop(L), n, is_double, offset, scale);
+    return 1;
+}
+
+/* creates a table holding n double-precision numbers from the pcg32 rng */
+static int lua_pcg_pcg32_filldouble(lua_State *L)
+{
+    return lua_pcg_pcg32_fill_real(L, 1);
+}
+
+/* creates a table holding n single-precision numbers from the pcg32 rng */
+static int lua_pcg_pcg32_fillfloat(lua_State *L)
+{
+    return lua_pcg_pcg32_fill_real(L, 0);
+}
+
+/* fills the positions [i, j] of a table with values from the pcg32 rng */
+static int lua_pcg_pcg32_fillinto(lua_State *L)
+{
+    lua_pcg_u32 bound = 0U;
+    lua_Integer offset = 0;
+    lua_Integer i, j;
+    int has_bounds;
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+    i = luaL_checkinteger(L, 3);
+    j = luaL_checkinteger(L, 4);
+    luaL_argcheck(L, 1 <= i, 3, "i must be a positive integer");
+    luaL_argcheck(L, j <= LUA_PCG_TABLE_INDEX_MAX, 4, "j is out of range");
+    has_bounds = lua_pcg_pcg32_parse_bounds(L, 5, nargs - 4, &bound, &offset);
+
+    if (i <= j)
+    {
+        lua_pcg_pcg32_fill_table(L, rng, 2, (lua_pcg_table_index)i, j - i + 1, has_bounds, bound, offset);
+    }
+
+    lua_pushvalue(L, 2);
+    return 1;
+}
+
+/*
+** shuffles the positions i to j of a table in place
+** through the Fisher-Yates algorithm: each position k,
+** from j down to i + 1, swaps its value with the value
+** of a position drawn uniformly from [i, k] by the pcg32 rng.
+*/
+static int lua_pcg_pcg32_shuffle(lua_State *L)
+{
+    lua_Integer i, j;
+    lua_pcg_table_index k, r;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+    i = luaL_optinteger(L, 3, 1);
+    j = lua_isnoneornil(L, 4) ? ((lua_Integer)lua_pcg_table_length(L, 2)) : luaL_checkinteger(L, 4);
+    luaL_argcheck(L, 1 <= i, 3, "i must be a positive integer");
+    luaL_argcheck(L, j <= LUA_PCG_TABLE_INDEX_MAX, 4, "j is out of range");
+    luaL_argcheck(L, j < i || j - i < 0xFFFFFFFF, 4, "the number of positions (j - i + 1) is out of [1, 4294967295] range");
+
+    /* j < i is an empty range; i < j also keeps i within lua_pcg_table_index */
+    if (i < j)
+    {
+        for (k = (lua_pcg_table_index)j; k > (lua_pcg_table_index)i; k--)
+        {
+            r = (lua_pcg_table_index)(i + ((lua_Integer)lua_pcg32_boundedrand_r(rng, lua_pcg_u32_cast(k - i + 1))));
+            if (r != k)
+            {
+                lua_rawgeti(L, 2, k);
+                lua_rawgeti(L, 2, r);
+                lua_rawseti(L, 2, k);
+                lua_rawseti(L, 2, r);
+            }
+        }
+    }
+
+    lua_pushvalue(L, 2);
+    return 1;
+}
+
+/*
+** creates a table holding a random permutation of 1 to n
+** through the inside-out Fisher-Yates algorithm: for each k
+** from 1 to n, a position r is drawn from [1, k], the value
+** at r is moved to k and k is placed at r.
+*/
+static int lua_pcg_pcg32_permutation(lua_State *L)
+{
+    lua_pcg_table_index k, r;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+    luaL_argcheck(L, n <= 0xFFFFFFFF, 2, "n is out of [0, 4294967295] range");
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    for (k = 0; k < (lua_pcg_table_index)n;)
+    {
+        k++;
+        r = 1 + (lua_pcg_table_index)lua_pcg32_boundedrand_r(rng, lua_pcg_u32_cast(k));
+        if (r != k)
+        {
+            lua_rawgeti(L, -1, r);
+            lua_rawseti(L, -2, k);
+        }
+        lua_pushinteger(L, (lua_Integer)k);
+        lua_rawseti(L, -2, r);
+    }
+    return 1;
+}
+
+/*
+** fills a buffer owned by the caller with a random
+** permutation of 0 to (count - 1) of elemsize bytes each,
+** drawing the same positions of 'permutation'
+*/
+static int lua_pcg_pcg32_permutationbuffer(lua_State *L)
+{
+    size_t k, r, count, elemsize;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    unsigned char *dst = lua_pcg_check_buffer(L, 2);
+
+    count = lua_pcg_check_buffer_count(L, 3, 4U, &elemsize);
+    luaL_argcheck(L, count <= 0xFFFFFFFF, 3, "count is out of [0, 4294967295] range");
+
+    for (k = 0U; k < count; k++)
+    {
+        r = (size_t)lua_pcg32_boundedrand_r(rng, lua_pcg_u32_cast(k + 1U));
+        if (r != k)
+        {
+            memcpy((void *)(dst + k * elemsize), (const void *)(dst + r * elemsize), elemsize);
+        }
+        lua_pcg_permutation_store(dst + r * elemsize, elemsize, k);
+    }
+
+    return 0;
+}
+
+/*
+** creates a table holding k distinct integers
+** drawn uniformly from 1 to n by the pcg32 rng.
+** 
+** When k is at most n / 2, Floyd's algorithm runs
+** on a set of O(k) slots: for each j from n - k + 1
+** to n, a value t is drawn from [1, j], and j is taken
+** in place of t when t was taken before. Otherwise,
+** a partial Fisher-Yates shuffle runs on the
+** n <= 2k integers 1 to n, stopping after k swaps.
+*/
+static int lua_pcg_pcg32_sample(lua_State *L)
+{
+    lua_Integer j, t;
+    lua_pcg_table_index key;
+    lua_Integer *values;
+    lua_pcg_intset set;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+    lua_Integer k = luaL_checkinteger(L, 3);
+
+    luaL_argcheck(L, 0 <= n, 2, "n must be a non-negative integer");
+    luaL_argcheck(L, n <= 0xFFFFFFFF, 2, "n is out of [0, 4294967295] range");
+    luaL_argcheck(L, 0 <= k && k <= n, 3, "k is out of [0, n] range");
+    luaL_argcheck(L, k <= LUA_PCG_TABLE_INDEX_MAX && ((size_t)k) <= (((size_t)(~(size_t)0)) / (2U * sizeof(lua_Integer))), 3, "k is out of range");
+
+    lua_settop(L, 3);
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 0);
+
+    if (k <= n / 2)
+    {
+        lua_pcg_intset_push(L, &set, (size_t)k);
+        for (j = n - k, key = 0; j < n;)
+        {
+            j++;
+            t = 1 + ((lua_Integer)lua_pcg32_boundedrand_r(rng, lua_pcg_u32_cast(j)));
+            if (!lua_pcg_intset_insert(&set, t))
+            {
+                lua_pcg_intset_insert(&set, j);
+                t = j;
+            }
+            lua_pushinteger(L, t);
+            lua_rawseti(L, 4, ++key);
+        }
+    }
+    else
+    {
+        values = (lua_Integer *)lua_newuserdata(L, ((size_t)n) * sizeof(lua_Integer));
+        if (values == NULL)
+        {
+            return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32 sample");
+        }
+        for (j = 0; j < n; j++)
+        {
+            values[j] = j + 1;
+        }
+        for (j = 0, key = 0; j < k; j++)
+        {
+            t = j + ((lua_Integer)lua_pcg32_boundedrand_r(rng, lua_pcg_u32_cast(n - j)));
+            lua_pushinteger(L, values[t]);
+            lua_rawseti(L, 4, ++key);
+            values[t] = values[j];
+        }
+    }
+
+    lua_settop(L, 4);
+    return 1;
+}
+
+/* generates a floating-point number in the range (0, 1] from the pcg32 rng */
+static double lua_pcg_pcg32_uniform(void *rng)
+{
+    return 1.0 - lua_pcg_pcg32_nextdouble_r((lua_pcg32_random_t *)rng);
+}
+
+/*
+** parses n and k of the sorted samples of pcg32,
+** which must hold 0 <= k <= n <= 2^53, such that
+** every index is exactly representable as a double
+*/
+static void lua_pcg_pcg32_parse_sorted(lua_State *L, lua_Integer *n, lua_Integer *k)
+{
+    *n = luaL_checkinteger(L, 2);
+    *k = luaL_checkinteger(L, 3);
+    luaL_argcheck(L, 0 <= *n && ((double)(*n)) <= 9007199254740992.0, 2, "n is out of [0, 2^53] range");
+    luaL_argcheck(L, 0 <= *k && *k <= *n, 3, "k is out of [0, n] range");
+}
+
+/*
+** creates a table holding k distinct integers
+** drawn uniformly from 1 to n by the pcg32 rng,
+** in increasing order, through Vitter's sequential
+** random sampling (see lua_pcg_vitter_t)
+*/
+static int lua_pcg_pcg32_samplesorted(lua_State *L)
+{
+    lua_Integer n, k, position;
+    lua_pcg_table_index key;
+    lua_pcg_vitter_t v;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+
+    lua_pcg_pcg32_parse_sorted(L, &n, &k);
+    luaL_argcheck(L, k <= LUA_PCG_TABLE_INDEX_MAX, 3, "k is out of range");
+
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 0);
+    lua_pcg_vitter_init(&v, (double)n, (double)k, lua_pcg_pcg32_uniform, (void *)rng);
+    for (key = 0, position = 0; key < (lua_pcg_table_index)k;)
+    {
+        key++;
+        position += ((lua_Integer)lua_pcg_vitter_skip(&v, lua_pcg_pcg32_uniform, (void *)rng)) + 1;
+        lua_pushinteger(L, position);
+        lua_rawseti(L, -2, key);
+    }
+    return 1;
+}
+
+/*
+** state of an iterator created
+** by the method 'itersorted' of pcg32
+*/
+typedef struct
+{
+    lua_pcg_vitter_t v;
+    lua_Integer position;
+} lua_pcg_pcg32_itersorted_t;
+
+/*
+** the iterator function of a generic for
+** created by the method 'itersorted' of pcg32,
+** which returns the next index and the next
+** selected integer in increasing order.
+** 
+** Note: this function is registered as a C closure
+** holding the pcg32 userdata as its first upvalue
+** and the lua_pcg_pcg32_itersorted_t as its second upvalue.
+*/
+static int lua_pcg_pcg32_itersorted_call(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = (lua_pcg32_random_t_wrapper *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pcg_pcg32_itersorted_t *iter = (lua_pcg_pcg32_itersorted_t *)lua_touserdata(L, lua_upvalueindex(2));
+    lua_pcg32_random_t *rng = wrapper->rng;
+    lua_Integer i = lua_tointeger(L, 2);
+
+    if (rng == NULL)
+    {
+        return luaL_error(L, "pcg32 random was closed previously");
+    }
+
+    if (iter->v.n < 1.0)
+    {
+        return 0;
+    }
+
+    iter->position += ((lua_Integer)lua_pcg_vitter_skip(&(iter->v), lua_pcg_pcg32_uniform, (void *)rng)) + 1;
+    lua_pushinteger(L, i + 1);
+    lua_pushinteger(L, iter->position);
+    return 2;
+}
+
+/*
+** creates an iterator for a generic for yielding
+** the index and k distinct integers drawn uniformly
+** from 1 to n by the pcg32 rng, in increasing order
+*/
+static int lua_pcg_pcg32_itersorted(lua_State *L)
+{
+    lua_Integer n, k;
+    lua_pcg_pcg32_itersorted_t *iter;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+
+    lua_pcg_pcg32_parse_sorted(L, &n, &k);
+
+    lua_settop(L, 1);
+    iter = (lua_pcg_pcg32_itersorted_t *)lua_newuserdata(L, sizeof(lua_pcg_pcg32_itersorted_t));
+    if (iter == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32 iterator");
+    }
+    lua_pcg_vitter_init(&(iter->v), (double)n, (double)k, lua_pcg_pcg32_uniform, (void *)rng);
+    iter->position = 0;
+
+    lua_pushcclosure(L, lua_pcg_pcg32_itersorted_call, 2);
+    lua_pushnil(L);
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+/* gets the 64 bits of two values from the pcg32 rng (see lua_pcg_ziggurat_draw) */
+static void lua_pcg_pcg32_words(void *rng, lua_pcg_u32 *high, lua_pcg_u32 *low)
+{
+    *high = lua_pcg32_random_r((lua_pcg32_random_t *)rng);
+    *low = lua_pcg32_random_r((lua_pcg32_random_t *)rng);
+}
+
+/*
+** gets a normal number of mean mu and standard deviation
+** sigma from the pcg32 rng (see lua_pcg_ziggurat_normal),
+** or creates a table holding n such numbers
+*/
+static int lua_pcg_pcg32_normal(lua_State *L)
+{
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Number mu = luaL_optnumber(L, 2, 0.0);
+    lua_Number sigma = luaL_optnumber(L, 3, 1.0);
+
+    luaL_argcheck(L, mu - mu == 0.0, 2, "mu must be a finite number");
+    luaL_argcheck(L, sigma >= 0.0 && sigma - sigma == 0.0, 3, "sigma must be a finite non-negative number");
+    return lua_pcg_ziggurat_push(L, 4, 1, lua_pcg_pcg32_words, lua_pcg_pcg32_uniform, (void *)rng, mu, sigma);
+}
+
+/*
+** gets an exponential number of rate lambda from the pcg32 rng
+** (see lua_pcg_ziggurat_exponential), or creates a table holding n such numbers
+*/
+static int lua_pcg_pcg32_exponential(lua_State *L)
+{
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_Number lambda = luaL_optnumber(L, 2, 1.0);
+
+    luaL_argcheck(L, lambda > 0.0 && lambda - lambda == 0.0, 2, "lambda must be a finite positive number");
+    return lua_pcg_ziggurat_push(L, 3, 0, lua_pcg_pcg32_words, lua_pcg_pcg32_uniform, (void *)rng, 0.0, 1.0 / lambda);
+}
+
+/* gets the bytes from the next lua_pcg_u32 value provided by the pcg32 rng */
+static int lua_pcg_pcg32_nextbytes(lua_State *L)
+{
+    int i;
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    lua_pcg_u32 n = lua_pcg32_random_r(rng);
+
+    lua_createtable(L, 0, 0);
+
+    for (i = 0; i < 4; i++, n >>= 8U)
+    {
+        lua_pushinteger(L, i + 1);
+        lua_pushinteger(L, lua_pcg_u8_cast(n));
+        lua_settable(L, -3);
+    }
+
+    return 1;
+}
+
+/* gets the next double-precision number from the pcg32 rng */
+static int lua_pcg_pcg32_nextdouble(lua_State *L)
+{
+    lua_Number offset, scale;
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+
+    lua_pcg_parse_real_bounds(L, 2, nargs - 1, "pcg32", &offset, &scale);
+    lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg32_nextdouble_r(rng)));
+    return 1;
+}
+
+/* gets the next single-precision number from the pcg32 rng */
+static int lua_pcg_pcg32_nextfloat(lua_State *L)
+{
+    lua_Number offset, scale;
+    int nargs = lua_gettop(L);
+    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+
+    lua_pcg_parse_real_bounds(L, 2, nargs - 1, "pcg32", &offset, &scale);
+    lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg32_nextfloat_r(rng)));
+    return 1;
+}
+
+/* sets the pcg32 object instance as read-only */
+static int lua_pcg_pcg32_newindex(lua_State *L)
+{
+    return luaL_error(L, "Read-only object");
+}
+
+/* invalidates the pcg32 random instance */
+static int lua_pcg_pcg32_close(lua_State *L)
+{
+    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check(L, 1);
+    wrapper->rng = NULL;
+    return 0;
+}
+
+static const luaL_Reg lua_pcg_pcg32_funcs[] = {
+    {"advance", lua_pcg_pcg32_advance},
+    {"bytes", lua_pcg_pcg32_bytes},
+    {"close", lua_pcg_pcg32_close},
+    {"exponential", lua_pcg_pcg32_exponential},
+    {"fill", lua_pcg_pcg32_fill},
+    {"fillbuffer", lua_pcg_pcg32_fillbuffer},
+    {"filldouble", lua_pcg_pcg32_filldouble},
+    {"fillfloat", lua_pcg_pcg32_fillfloat},
+    {"fillinto", lua_pcg_pcg32_fillinto},
+    {"fromstate", lua_pcg_pcg32_fromstate},
+    {"getstate", lua_pcg_pcg32_getstate},
+    {"iter", lua_pcg_pcg32_iter},
+    {"itersorted", lua_pcg_pcg32_itersorted},
+    {"new", lua_pcg_pcg32_new},
+    {"nextbytes", lua_pcg_pcg32_nextbytes},
+    {"nextdouble", lua_pcg_pcg32_nextdouble},
+    {"nextfloat", lua_pcg_pcg32_nextfloat},
+    {"normal", lua_pcg_pcg32_normal},
+    {"permutation", lua_pcg_pcg32_permutation},
+    {"permutationbuffer", lua_pcg_pcg32_permutationbuffer},
+    {"sample", lua_pcg_pcg32_sample},
+    {"samplesorted", lua_pcg_pcg32_samplesorted},
+    {"sampler", lua_pcg_pcg32_sampler},
+    {"seed", lua_pcg_pcg32_seed},
+    {"setstate", lua_pcg_pcg32_setstate},
+    {"shuffle", lua_pcg_pcg32_shuffle},
+    {"split", lua_pcg_pcg32_split},
+    {NULL, NULL}
+};
+
+/*
+** functions registered as C closures
+** holding the pcg32 metatable as upvalue
+*/
+static const luaL_Reg lua_pcg_pcg32_upvalue_funcs[] = {
+    {"bits", lua_pcg_pcg32_bits},
+    {"bool", lua_pcg_pcg32_bool},
+    {"next", lua_pcg_pcg32_next},
+    {NULL, NULL}
+};
+/* end of pcg32 implementation */
+
+/* 
+** *********************************************
+** *********************************************
+** 
+** Now that pcg64 methods were implemented,
+** we are going to bridge it to Lua.
+** 
+** *********************************************
+** *********************************************
+*/
+
+/*
+** Structure to wrap a lua_pcg64_random_t
+** 
+** The rng is stored inline, on the same userdata
+** right after the wrapper, on an address aligned
+** by lua_pcg_newuserdata_aligned. Thus, creating
+** a pcg64 instance takes a single allocation and
+** no finalizer. 'rng' is set to NULL by 'close'.
+** 
+** 'bits' caches the 'nbits' output bits of the rng
+** not consumed yet by the methods 'bits' and 'bool'.
+*/
+typedef struct
+{
+    lua_pcg64_random_t *rng;
+    lua_pcg_u64 bits;
+    unsigned int nbits;
+} lua_pcg64_random_t_wrapper;
+
+static lua_pcg64_random_t_wrapper *lua_pcg_pcg64_check(lua_State *L, int index)
+{
+    void *ud = luaL_checkudata(L, index, LUA_PCG_PCG64_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "pcg64 random expected");
+    return (lua_pcg64_random_t_wrapper *)ud;
+}
+
+static lua_pcg64_random_t_wrapper *lua_pcg_pcg64_check_open(lua_State *L, int index)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check(L, index);
+    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg64 random was closed previously");
+    return wrapper;
+}
+
+static lua_pcg64_random_t *lua_pcg_pcg64_check_rng(lua_State *L, int index)
+{
+    return lua_pcg_pcg64_check_open(L, index)->rng;
+}
+
+/*
+** pushes a new pcg64 userdata on the stack,
+** holding the lua_pcg64_random_t (rng) that it wraps.
+** The state of the rng is left uninitialized.
+*/
+static lua_pcg64_random_t_wrapper *lua_pcg_pcg64_push(lua_State *L)
+{
+    void *block;
+    lua_pcg64_random_t_wrapper *wrapper;
+    void *ud = lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg64_random_t_wrapper), sizeof(lua_pcg64_random_t), &block);
+    if (ud == NULL)
+    {
+        luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64 random");
+        return NULL;
+    }
+    wrapper = (lua_pcg64_random_t_wrapper *)ud;
+    wrapper->rng = (lua_pcg64_random_t *)block;
+    wrapper->bits = lua_pcg_u64_lh(0U, 0U);
+    wrapper->nbits = 0U;
+    luaL_getmetatable(L, LUA_PCG_PCG64_METATABLE);
+    lua_setmetatable(L, -2);
+    return wrapper;
+}
+
+/* creates a lua_pcg64_random_t (rng) */
+static int lua_pcg_pcg64_new(lua_State *L)
+{
+    lua_pcg_u128 initstate;
+    lua_pcg_u128 initseq;
+    lua_pcg64_random_t_wrapper *wrapper;
+    lua_pcg64_random_t *rng;
+    void *ud;
+    int nargs;
+
+    nargs = lua_gettop(L);
+    wrapper = lua_pcg_pcg64_push(L);
+    ud = (void *)wrapper;
+    rng = wrapper->rng;
+
+    switch (nargs)
+    {
+        case 0: /* no args? generate both initstate and initseq */
+        {
+            lua_pcg_fill_with_random_bytes(ud, &initstate, &initseq);
+            break;
+        }
+        case 1: /* only initstate was provided? then generate initseq */
+        {
+            initstate = lua_pcg_parse_u128_arg(L, 1);
+            lua_pcg_fill_with_random_bytes(ud, NULL, &initseq);
+            break;
+        }
+        case 2: /* both initstate and initseq were provided */
+        {
+            initstate = lua_pcg_parse_u128_arg(L, 1);
+            initseq = lua_pcg_parse_u128_arg(L, 2);
+            break;
+        }
+        default:
+        {
+            return luaL_error(L, "Unknown number of arguments to create a pcg64 instance.");
+        }
+    }
+
+    lua_pcg64_srandom_r(rng, initstate, initseq);
+
+    return 1;
+}
+
+/* advances a lua_pcg64_random_t (rng) by delta */
+static int lua_pcg_pcg64_advance(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check_open(L, 1);
+    lua_pcg_u128 delta = lua_pcg_parse_u128_arg(L, 2);
+    lua_pcg64_advance_r(wrapper->rng, delta);
+    wrapper->bits = lua_pcg_u64_lh(0U, 0U);
+    wrapper->nbits = 0U;
+    return 0;
+}
+
+/* seed the pcg64 rng */
+static int lua_pcg_pcg64_seed(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check_open(L, 1);
+    lua_pcg_u128 initstate = lua_pcg_parse_u128_arg(L, 2);
+    lua_pcg_u128 initseq = lua_pcg_parse_u128_arg(L, 3);
+    lua_pcg64_srandom_r(wrapper->rng, initstate, initseq);
+    wrapper->bits = lua_pcg_u64_lh(0U, 0U);
+    wrapper->nbits = 0U;
+    return 0;
+}
+
+/*
+** The state of the pcg64 rng is serialized as a binary string
+** of 41 bytes: the 128-bit state, the 128-bit increment (inc)
+** and the 64-bit cache of the methods 'bits' and 'bool',
+** all of them in little-endian byte order, followed by
+** a byte holding the number of cached bits.
+** Thus, the same string is produced on native and emulated builds.
+*/
+#define LUA_PCG_PCG64_STATE_SIZE 41
+
+/* parses the binary state at stack position 'index' into the rng and its bit cache */
+static void lua_pcg_pcg64_parse_state(lua_State *L, int index, lua_pcg64_random_t *rng, lua_pcg_u64 *bits, unsigned int *nbits)
+{
+    size_t len;
+    lua_pcg_u64 cached;
+    lua_pcg_u64 rest;
+    lua_pcg_u64 zero = lua_pcg_u64_lh(0U, 0U);
+    unsigned int ncached;
+    const unsigned char *s = (const unsigned char *)luaL_checklstring(L, index, &len);
+
+    luaL_argcheck(L, len == LUA_PCG_PCG64_STATE_SIZE, index, "state must be a string holding 41 bytes");
+    luaL_argcheck(L, (s[16] & 1U) != 0, index, "state holds an even increment");
+
+    cached = lua_pcg_unpack_u64(s + 32);
+    ncached = (unsigned int)s[40];
+    luaL_argcheck(L, ncached < 64U, index, "state holds an invalid bit cache");
+    rest = lua_pcg_u64_rsh(cached, ncached);
+    luaL_argcheck(L, lua_pcg_u64_eq(rest, zero), index, "state holds an invalid bit cache");
+
+    rng->state = lua_pcg_unpack_u128(s);
+    rng->inc = lua_pcg_unpack_u128(s + 16);
+    *bits = cached;
+    *nbits = ncached;
+}
+
+/* gets the current state of the pcg64 rng as a binary string */
+static int lua_pcg_pcg64_getstate(lua_State *L)
+{
+    unsigned char buffer[LUA_PCG_PCG64_STATE_SIZE];
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check_open(L, 1);
+
+    lua_pcg_pack_u128(buffer, wrapper->rng->state);
+    lua_pcg_pack_u128(buffer + 16, wrapper->rng->inc);
+    lua_pcg_pack_u64(buffer + 32, wrapper->bits);
+    buffer[40] = (unsigned char)wrapper->nbits;
+    lua_pushlstring(L, (const char *)buffer, LUA_PCG_PCG64_STATE_SIZE);
+    return 1;
+}
+
+/* restores the state of the pcg64 rng from a binary string */
+static int lua_pcg_pcg64_setstate(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check_open(L, 1);
+    lua_pcg_pcg64_parse_state(L, 2, wrapper->rng, &(wrapper->bits), &(wrapper->nbits));
+    return 0;
+}
+
+/* creates a lua_pcg64_random_t (rng) from a binary string */
+static int lua_pcg_pcg64_fromstate(lua_State *L)
+{
+    lua_pcg64_random_t state;
+    lua_pcg_u64 bits;
+    unsigned int nbits;
+    lua_pcg64_random_t_wrapper *wrapper;
+
+    lua_pcg_pcg64_parse_state(L, 1, &state, &bits, &nbits);
+    wrapper = lua_pcg_pcg64_push(L);
+    *(wrapper->rng) = state;
+    wrapper->bits = bits;
+    wrapper->nbits = nbits;
+    return 1;
+}
+
+/*
+** splits the pcg64 rng into a table of k new generators
+** (see lua_pcg_pcg32_split)
+*/
+static int lua_pcg_pcg64_split(lua_State *L)
+{
+    lua_pcg_u64 low;
+    lua_pcg_u64 high;
+    lua_pcg_u128 base;
+    lua_pcg_u128 delta;
+    lua_pcg_u128 initstate;
+    lua_Integer i;
+    lua_pcg64_random_t *child;
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Integer k = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 1 <= k && k <= LUA_PCG_TABLE_INDEX_MAX, 2, "k is out of range");
+    luaL_argcheck(L, nargs <= 3, 4, "too many arguments");
+
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 0);
+    if (nargs == 3)
+    {
+        delta = lua_pcg_parse_u128_arg(L, 3);
+        for (i = 0; i < k; i++)
+        {
+            child = lua_pcg_pcg64_push(L)->rng;
+            *child = *rng;
+            lua_rawseti(L, -2, (lua_pcg_table_index)(i + 1));
+            lua_pcg64_advance_r(rng, delta);
+        }
+    }
+    else
+    {
+        low = lua_pcg64_random_r(rng);
+        high = lua_pcg64_random_r(rng);
+        base = lua_pcg_u128_lh(low, high);
+        for (i = 0; i < k; i++)
+        {
+            low = lua_pcg64_random_r(rng);
+            high = lua_pcg64_random_r(rng);
+            initstate = lua_pcg_u128_lh(low, high);
+            child = lua_pcg_pcg64_push(L)->rng;
+            lua_pcg64_srandom_r(child, initstate, base);
+            lua_rawseti(L, -2, (lua_pcg_table_index)(i + 1));
+
+            /* base = base + 1 */
+            base = lua_pcg_u128_sum(base, lua_pcg_u128_lh(lua_pcg_u64_lh(1U, 0U), lua_pcg_u64_lh(0U, 0U)));
+        }
+    }
+    return 1;
+}
+
+/*
+** Casts a lua_pcg_u64 to lua_Integer
+** 
+** Note: the value is truncated when
+**       lua_Integer is shorter than 64-bits.
+*/
+static lua_Integer lua_pcg_u64_to_lua_Integer(lua_pcg_u64 n)
+{
+#ifdef LUA_PCG_U64_EMULATED
+    if (lua_pcg_lua_Integer_has_64bit()) /* assume lua_Integer can hold 64-bit values */
+    {
+        return (((lua_Integer)n.low) | (((((lua_Integer)n.high) << 15) << 15) << 2));
+    }
+    else
+    {
+        return (lua_Integer)(lua_pcg_u64_cast_to_u32(n));
+    }
+#else
+    return (lua_Integer)n;
+#endif
+}
+
+/* Casts a non-negative lua_Integer to lua_pcg_u64 */
+static lua_pcg_u64 lua_pcg_lua_Integer_to_u64(lua_Integer n)
+{
+    if (n <= 0xFFFFFFFF)
+    {
+        return lua_pcg_u64_lh(n, 0);
+    }
+    return lua_pcg_u64_lh(lua_pcg_u32_cast(n), lua_pcg_u32_cast((((n >> 15) >> 15) >> 2)));
+}
+
+/*
+** Parses the optional arguments (a [, b])
+** of the pcg64 rng starting at stack position 'index',
+** where 'nargs' is the number of arguments provided.
+** 
+** When a single argument is given, it is the bound,
+** and offset is set to 0. When two arguments
+** are given, bound is set to (b - a) and offset to a.
+** 
+** return value:
+**    0: no arguments were provided
+**    1: bound and offset were filled
+*/
+static int lua_pcg_pcg64_parse_bounds(lua_State *L, int index, int nargs, lua_pcg_u64 *bound, lua_Integer *offset)
+{
+    int res = 0;
+    lua_Integer a, b, c;
+
+    switch (nargs)
+    {
+        case 0: /* no args? */
+        {
+            break;
+        }
+        case 1: /* bound is given */
+        {
+            a = luaL_checkinteger(L, index);
+            luaL_argcheck(L, 0 < a, index, "bound must be a positive integer");
+            *bound = lua_pcg_lua_Integer_to_u64(a);
+            *offset = 0;
+            res = 1;
+            break;
+        }
+        case 2: /* a, b were provided */
+        {
+            a = luaL_checkinteger(L, index);
+            b = luaL_checkinteger(L, index + 1);
+            luaL_argcheck(L, a < b, index, "a cannot be greater than or equal to b");
+
+            c = b - a;
+            *bound = lua_pcg_lua_Integer_to_u64(c);
+            *offset = a;
+            res = 1;
+            break;
+        }
+        default:
+        {
+            luaL_error(L, "Unknown number of arguments to generate a next number from pcg64");
+            break;
+        }
+    }
+
+    return res;
+}
+
+/*
+** Generates 'count' values from the pcg64 rng,
+** storing them on the table located at stack
+** position 'index', starting at key 'first'.
+*/
+static void lua_pcg_pcg64_fill_table(lua_State *L, lua_pcg64_random_t *rng, int index, lua_pcg_table_index first, lua_Integer count, int has_bounds, lua_pcg_u64 bound, lua_Integer offset)
+{
+    lua_Integer k;
+    lua_pcg_table_index key = first - 1;
+
+    if (has_bounds)
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushinteger(L, offset + lua_pcg_u64_to_lua_Integer(lua_pcg64_boundedrand_r(rng, bound)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+    else
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(lua_pcg64_random_r(rng)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+}
+
+/*
+** checks whether the value at stack position 'index'
+** is a pcg64 random, comparing its metatable against
+** the metatable cached as the first upvalue
+** of the running C function, which avoids looking up
+** the metatable by name on the registry.
+*/
+static lua_pcg64_random_t_wrapper *lua_pcg_pcg64_check_open_upvalue(lua_State *L, int index)
+{
+    lua_pcg64_random_t_wrapper *wrapper = (lua_pcg64_random_t_wrapper *)lua_touserdata(L, index);
+
+    if (wrapper == NULL || !lua_getmetatable(L, index) || !lua_rawequal(L, -1, lua_upvalueindex(1)))
+    {
+        /* raises the usual error */
+        return lua_pcg_pcg64_check_open(L, index);
+    }
+    lua_pop(L, 1);
+
+    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg64 random was closed previously");
+    return wrapper;
+}
+
+static lua_pcg64_random_t *lua_pcg_pcg64_check_rng_upvalue(lua_State *L, int index)
+{
+    return lua_pcg_pcg64_check_open_upvalue(L, index)->rng;
+}
+
+/* gets the next lua_pcg_u64 value from the pcg64 rng */
+static int lua_pcg_pcg64_next0(lua_State *L, lua_pcg64_random_t *rng)
+{
+    lua_pcg_u64 n = lua_pcg64_random_r(rng);
+    lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(n));
+    return 1;
+}
+
+/* gets the next lua_pcg_u64 value from the pcg64 rng in [0, bound) */
+static int lua_pcg_pcg64_next1(lua_State *L, lua_pcg64_random_t *rng)
+{
+    lua_pcg_u64 n;
+    lua_pcg_u64 bound;
+    lua_Integer offset;
+
+    lua_pcg_pcg64_parse_bounds(L, 2, 1, &bound, &offset);
+    n = lua_pcg64_boundedrand_r(rng, bound);
+    lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(n));
+    return 1;
+}
+
+/* gets the next lua_pcg_u64 value from the pcg64 rng in [a, b) */
+static int lua_pcg_pcg64_next2(lua_State *L, lua_pcg64_random_t *rng)
+{
+    lua_pcg_u64 n;
+    lua_pcg_u64 bound;
+    lua_Integer offset;
+
+    lua_pcg_pcg64_parse_bounds(L, 2, 2, &bound, &offset);
+    n = lua_pcg64_boundedrand_r(rng, bound);
+    lua_pushinteger(L, offset + lua_pcg_u64_to_lua_Integer(n));
+    return 1;
+}
+
+/*
+** gets the next lua_pcg_u64 value from the pcg64 rng,
+** dispatching on the number of arguments
+** 
+** Note: this function is registered as a C closure
+** holding the pcg64 metatable as its first upvalue.
+*/
+static int lua_pcg_pcg64_next(lua_State *L)
+{
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng_upvalue(L, 1);
+
+    switch (nargs)
+    {
+        case 1:
+        {
+            return lua_pcg_pcg64_next0(L, rng);
+        }
+        case 2:
+        {
+            return lua_pcg_pcg64_next1(L, rng);
+        }
+        case 3:
+        {
+            return lua_pcg_pcg64_next2(L, rng);
+        }
+        default:
+        {
+            return luaL_error(L, "Unknown number of arguments to generate a next number from pcg64");
+        }
+    }
+}
+
+/*
+** precomputed parameters of a bounded sampler
+** created by the method 'sampler' of pcg64
+*/
+typedef struct
+{
+    lua_pcg_u64 bound;
+    lua_pcg_u64 threshold;
+    lua_Integer offset;
+} lua_pcg_pcg64_sampler_t;
+
+/*
+** draws values in [a, b) from the pcg64 rng
+** of a sampler, either one at a time (no args)
+** or n at once stored on a new table.
+** 
+** Note: this function is registered as a C closure
+** holding the pcg64 userdata as its first upvalue
+** and the lua_pcg_pcg64_sampler_t as its second upvalue.
+*/
+static int lua_pcg_pcg64_sampler_call(lua_State *L)
+{
+    lua_Integer k, n;
+    lua_pcg_table_index key;
+    lua_pcg64_random_t_wrapper *wrapper = (lua_pcg64_random_t_wrapper *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pcg_pcg64_sampler_t *sampler = (lua_pcg_pcg64_sampler_t *)lua_touserdata(L, lua_upvalueindex(2));
+    lua_pcg64_random_t *rng = wrapper->rng;
+
+    if (rng == NULL)
+    {
+        return luaL_error(L, "pcg64 random was closed previously");
+    }
+
+    if (lua_gettop(L) == 0)
+    {
+        lua_pushinteger(L, sampler->offset + lua_pcg_u64_to_lua_Integer(lua_pcg64_thresholdrand_r(rng, sampler->bound, sampler->threshold)));
+        return 1;
+    }
+
+    n = luaL_checkinteger(L, 1);
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 1, "n is out of range");
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    for (k = 0, key = 0; k < n; k++)
+    {
+        lua_pushinteger(L, sampler->offset + lua_pcg_u64_to_lua_Integer(lua_pcg64_thresholdrand_r(rng, sampler->bound, sampler->threshold)));
+        lua_rawseti(L, -2, ++key);
+    }
+    return 1;
+}
+
+/*
+** creates a sampler drawing values in [a, b)
+** from the pcg64 rng, whose bound and threshold
+** are validated and computed only once
+*/
+static int lua_pcg_pcg64_sampler(lua_State *L)
+{
+    lua_pcg_u64 bound;
+    lua_Integer offset;
+    lua_pcg_pcg64_sampler_t *sampler;
+    int nargs = lua_gettop(L);
+
+    lua_pcg_pcg64_check_rng(L, 1);
+    luaL_argcheck(L, nargs == 2 || nargs == 3, 2, "expected a bound, or the integers a and b");
+    lua_pcg_pcg64_parse_bounds(L, 2, nargs - 1, &bound, &offset);
+
+    lua_settop(L, 1);
+    sampler = (lua_pcg_pcg64_sampler_t *)lua_newuserdata(L, sizeof(lua_pcg_pcg64_sampler_t));
+    if (sampler == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64 sampler");
+    }
+    sampler->bound = bound;
+    sampler->threshold = lua_pcg64_threshold(bound);
+    sampler->offset = offset;
+
+    lua_pushcclosure(L, lua_pcg_pcg64_sampler_call, 2);
+    return 1;
+}
+
+/*
+** parameters of an iterator created
+** by the method 'iter' of pcg64
+*/
+typedef struct
+{
+    lua_Integer count;
+    int has_bounds;
+    lua_pcg_pcg64_sampler_t sampler;
+} lua_pcg_pcg64_iter_t;
+
+/*
+** the iterator function of a generic for
+** created by the method 'iter' of pcg64,
+** which receives the previous index as the
+** control variable and returns the next index
+** and the next value from the pcg64 rng.
+** 
+** Note: this function is registered as a C closure
+** holding the pcg64 userdata as its first upvalue
+** and the lua_pcg_pcg64_iter_t as its second upvalue.
+*/
+static int lua_pcg_pcg64_iter_call(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = (lua_pcg64_random_t_wrapper *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pcg_pcg64_iter_t *iter = (lua_pcg_pcg64_iter_t *)lua_touserdata(L, lua_upvalueindex(2));
+    lua_pcg64_random_t *rng = wrapper->rng;
+    lua_Integer i = lua_tointeger(L, 2);
+
+    if (rng == NULL)
+    {
+        return luaL_error(L, "pcg64 random was closed previously");
+    }
+
+    if (i >= iter->count)
+    {
+        return 0;
+    }
+
+    lua_pushinteger(L, i + 1);
+    if (iter->has_bounds)
+    {
+        lua_pushinteger(L, iter->sampler.offset + lua_pcg_u64_to_lua_Integer(lua_pcg64_thresholdrand_r(rng, iter->sampler.bound, iter->sampler.threshold)));
+    }
+    else
+    {
+        lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(lua_pcg64_random_r(rng)));
+    }
+    return 2;
+}
+
+/*
+** creates an iterator for a generic for
+** yielding the index and n values from the pcg64 rng
+*/
+static int lua_pcg_pcg64_iter(lua_State *L)
+{
+    lua_pcg_u64 bound = lua_pcg_u64_lh(0U, 0U);
+    lua_Integer offset = 0;
+    int has_bounds;
+    lua_pcg_pcg64_iter_t *iter;
+    int nargs = lua_gettop(L);
+    lua_Integer n;
+
+    lua_pcg_pcg64_check_rng(L, 1);
+    n = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, 0 <= n, 2, "n must be a non-negative integer");
+    has_bounds = lua_pcg_pcg64_parse_bounds(L, 3, nargs - 2, &bound, &offset);
+
+    lua_settop(L, 1);
+    iter = (lua_pcg_pcg64_iter_t *)lua_newuserdata(L, sizeof(lua_pcg_pcg64_iter_t));
+    if (iter == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64 iterator");
+    }
+    iter->count = n;
+    iter->has_bounds = has_bounds;
+    iter->sampler.bound = bound;
+    iter->sampler.threshold = has_bounds ? lua_pcg64_threshold(bound) : bound;
+    iter->sampler.offset = offset;
+
+    lua_pushcclosure(L, lua_pcg_pcg64_iter_call, 2);
+    lua_pushnil(L);
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+/*
+** the lowest k (1 <= k <= 64) bits set,
+** avoiding the shift of a 64-bit integer by 64 bits
+*/
+static lua_pcg_u64 lua_pcg_u64_lowmask(unsigned int k)
+{
+    if (k >= 64U)
+    {
+        return lua_pcg_u64_lh(0xFFFFFFFF, 0xFFFFFFFF);
+    }
+    return lua_pcg_u64_subtraction(lua_pcg_u64_lsh(lua_pcg_u64_lh(1U, 0U), k), lua_pcg_u64_lh(1U, 0U));
+}
+
+/*
+** takes k (1 <= k <= 64) bits from the bit cache
+** of the pcg64 wrapper (see lua_pcg_pcg32_takebits)
+*/
+static lua_pcg_u64 lua_pcg_pcg64_takebits(lua_pcg64_random_t_wrapper *wrapper, unsigned int k)
+{
+    lua_pcg_u64 value, fresh;
+    unsigned int missing;
+
+    if (k <= wrapper->nbits)
+    {
+        if (k == 64U)
+        {
+            value = wrapper->bits;
+            wrapper->bits = lua_pcg_u64_lh(0U, 0U);
+        }
+        else
+        {
+            value = lua_pcg_u64_band(wrapper->bits, lua_pcg_u64_lowmask(k));
+            wrapper->bits = lua_pcg_u64_rsh(wrapper->bits, k);
+        }
+        wrapper->nbits -= k;
+        return value;
+    }
+
+    missing = k - wrapper->nbits;
+    fresh = lua_pcg64_random_r(wrapper->rng);
+
+    if (missing == 64U)
+    {
+        value = fresh;
+        wrapper->bits = lua_pcg_u64_lh(0U, 0U);
+    }
+    else
+    {
+        value = lua_pcg_u64_bor(wrapper->bits, lua_pcg_u64_lsh(lua_pcg_u64_band(fresh, lua_pcg_u64_lowmask(missing)), wrapper->nbits));
+        wrapper->bits = lua_pcg_u64_rsh(fresh, missing);
+    }
+    wrapper->nbits = 64U - missing;
+    return value;
+}
+
+/* gets k bits from the pcg64 rng as an integer in [0, 2^k) */
+static int lua_pcg_pcg64_bits(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check_open_upvalue(L, 1);
+    lua_Integer k = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 1 <= k && k <= 64, 2, "k is out of [1, 64] range");
+    lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(lua_pcg_pcg64_takebits(wrapper, (unsigned int)k)));
+    return 1;
+}
+
+/* gets a single bit from the pcg64 rng as a boolean */
+static int lua_pcg_pcg64_bool(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check_open_upvalue(L, 1);
+    lua_pcg_u64 bit = lua_pcg_pcg64_takebits(wrapper, 1U);
+    lua_pushboolean(L, !lua_pcg_u64_eq(bit, lua_pcg_u64_lh(0U, 0U)));
+    return 1;
+}
+
+/*
+** gets n bytes from the pcg64 rng as a string,
+** following the same byte order of 'nextbytes'
+*/
+static int lua_pcg_pcg64_bytes(lua_State *L)
+{
+    size_t k, chunk, remaining;
+    char *p;
+    luaL_Buffer buffer;
+    unsigned int available = 0U;
+    lua_pcg_u64 n = lua_pcg_u64_lh(0U, 0U);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Integer count = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= count, 2, "n must be a non-negative integer");
+    luaL_argcheck(L, ((lua_Integer)((size_t)count)) == count, 2, "n is out of range");
+
+    remaining = (size_t)count;
+    luaL_buffinit(L, &buffer);
+
+    while (remaining > 0U)
+    {
+        p = luaL_prepbuffer(&buffer);
+        chunk = remaining < ((size_t)LUAL_BUFFERSIZE) ? remaining : ((size_t)LUAL_BUFFERSIZE);
+
+        for (k = 0U; k < chunk; k++)
+        {
+            if (available == 0U)
+            {
+                n = lua_pcg64_random_r(rng);
+                available = 8U;
+            }
+
+            p[k] = (char)lua_pcg_u64_cast_to_u8(n);
+            n = lua_pcg_u64_rsh(n, 8U);
+            available--;
+        }
+
+        luaL_addsize(&buffer, chunk);
+        remaining -= chunk;
+    }
+
+    luaL_pushresult(&buffer);
+    return 1;
+}
+
+/* creates a table holding n values from the pcg64 rng */
+static int lua_pcg_pcg64_fill(lua_State *L)
+{
+    lua_pcg_u64 bound = lua_pcg_u64_lh(0U, 0U);
+    lua_Integer offset = 0;
+    int has_bounds;
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+    has_bounds = lua_pcg_pcg64_parse_bounds(L, 3, nargs - 2, &bound, &offset);
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    lua_pcg_pcg64_fill_table(L, rng, lua_gettop(L), 1, n, has_bounds, bound, offset);
+    return 1;
+}
+
+/*
+** fills a buffer owned by the caller with
+** count elements of elemsize bytes from the pcg64 rng
+*/
+static int lua_pcg_pcg64_fillbuffer(lua_State *L)
+{
+    size_t k, count, elemsize;
+    lua_pcg_u64 n;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    unsigned char *dst = lua_pcg_check_buffer(L, 2);
+
+    count = lua_pcg_check_buffer_count(L, 3, 8U, &elemsize);
+
+    if (elemsize == 8U)
+    {
+        for (k = 0U; k < count; k++, dst += 8)
+        {
+            lua_pcg_store_u64(dst, lua_pcg64_random_r(rng));
+        }
+    }
+    else
+    {
+        /* each 64-bit value is split on two consecutive 32-bit elements (low, high) */
+        for (k = 0U; k + 1U < count; k += 2U, dst += 8)
+        {
+            n = lua_pcg64_random_r(rng);
+            lua_pcg_store_u32(dst, lua_pcg_u64_cast_to_u32(n));
+            lua_pcg_store_u32(dst + 4, lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(n, 32U)));
+        }
+
+        if (k < count)
+        {
+            n = lua_pcg64_random_r(rng);
+            lua_pcg_store_u32(dst, lua_pcg_u64_cast_to_u32(n));
+        }
+    }
+
+    return 0;
+}
+
+/*
+** Generates a floating-point number in the range [0, 1)
+** with the upper 53 bits of a value from the pcg64 rng
+*/
+static double lua_pcg_pcg64_nextdouble_r(lua_pcg64_random_t *rng)
+{
+    lua_pcg_u64 n = lua_pcg64_random_r(rng);
+    lua_pcg_u32 high = lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(n, 32U));
+    lua_pcg_u32 low = lua_pcg_u64_cast_to_u32(n) >> 11U;
+    return (((double)high) * 2097152.0 + ((double)low)) * LUA_PCG_DOUBLE_SCALE;
+}
+
+/*
+** Generates a floating-point number in the range [0, 1)
+** with the upper 24 bits of a value from the pcg64 rng
+*/
+static double lua_pcg_pcg64_nextfloat_r(lua_pcg64_random_t *rng)
+{
+    lua_pcg_u32 high = lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(lua_pcg64_random_r(rng), 32U));
+    return ((double)(high >> 8U)) * LUA_PCG_FLOAT_SCALE;
+}
+
+/*
+** Generates 'count' floating-point numbers
+** from the pcg64 rng in the range [offset, offset + scale),
+** storing them on the table located at stack
+** position 'index', starting at key 1.
+*/
+static void lua_pcg_pcg64_fill_real_table(lua_State *L, lua_pcg64_random_t *rng, int index, lua_Integer count, int is_double, lua_Number offset, lua_Number scale)
+{
+    lua_Integer k;
+    lua_pcg_table_index key = 0;
+
+    if (is_double)
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg64_nextdouble_r(rng)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+    else
+    {
+        for (k = 0; k < count; k++)
+        {
+            lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg64_nextfloat_r(rng)));
+            lua_rawseti(L, index, ++key);
+        }
+    }
+}
+
+/* creates a table holding n floating-point numbers from the pcg64 rng */
+static int lua_pcg_pcg64_fill_real(lua_State *L, int is_double)
+{
+    lua_Number offset, scale;
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+    lua_pcg_parse_real_bounds(L, 3, nargs - 2, "pcg64", &offset, &scale);
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    lua_pcg_pcg64_fill_real_table(L, rng, lua_gettop(L), n, is_double, offset, scale);
+    return 1;
+}
+
+/* creates a table holding n double-precision numbers from the pcg64 rng */
+static int lua_pcg_pcg64_filldouble(lua_State *L)
+{
+    return lua_pcg_pcg64_fill_real(L, 1);
+}
+
+/* creates a table holding n single-precision numbers from the pcg64 rng */
+static int lua_pcg_pcg64_fillfloat(lua_State *L)
+{
+    return lua_pcg_pcg64_fill_real(L, 0);
+}
+
+/* fills the positions [i, j] of a table with values from the pcg64 rng */
+static int lua_pcg_pcg64_fillinto(lua_State *L)
+{
+    lua_pcg_u64 bound = lua_pcg_u64_lh(0U, 0U);
+    lua_Integer offset = 0;
+    lua_Integer i, j;
+    int has_bounds;
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+    i = luaL_checkinteger(L, 3);
+    j = luaL_checkinteger(L, 4);
+    luaL_argcheck(L, 1 <= i, 3, "i must be a positive integer");
+    luaL_argcheck(L, j <= LUA_PCG_TABLE_INDEX_MAX, 4, "j is out of range");
+    has_bounds = lua_pcg_pcg64_parse_bounds(L, 5, nargs - 4, &bound, &offset);
+
+    if (i <= j)
+    {
+        lua_pcg_pcg64_fill_table(L, rng, 2, (lua_pcg_table_index)i, j - i + 1, has_bounds, bound, offset);
+    }
+
+    lua_pushvalue(L, 2);
+    return 1;
+}
+
+/*
+** shuffles the positions i to j of a table in place
+** through the Fisher-Yates algorithm: each position k,
+** from j down to i + 1, swaps its value with the value
+** of a position drawn uniformly from [i, k] by the pcg64 rng.
+*/
+static int lua_pcg_pcg64_shuffle(lua_State *L)
+{
+    lua_Integer i, j;
+    lua_pcg_table_index k, r;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+    i = luaL_optinteger(L, 3, 1);
+    j = lua_isnoneornil(L, 4) ? ((lua_Integer)lua_pcg_table_length(L, 2)) : luaL_checkinteger(L, 4);
+    luaL_argcheck(L, 1 <= i, 3, "i must be a positive integer");
+    luaL_argcheck(L, j <= LUA_PCG_TABLE_INDEX_MAX, 4, "j is out of range");
+
+    /* j < i is an empty range; i < j also keeps i within lua_pcg_table_index */
+    if (i < j)
+    {
+        for (k = (lua_pcg_table_index)j; k > (lua_pcg_table_index)i; k--)
+        {
+            r = (lua_pcg_table_index)(i + lua_pcg_u64_to_lua_Integer(lua_pcg64_boundedrand_r(rng, lua_pcg_lua_Integer_to_u64(k - i + 1))));
+            if (r != k)
+            {
+                lua_rawgeti(L, 2, k);
+                lua_rawgeti(L, 2, r);
+                lua_rawseti(L, 2, k);
+                lua_rawseti(L, 2, r);
+            }
+        }
+    }
+
+    lua_pushvalue(L, 2);
+    return 1;
+}
+
+/*
+** draws an index in [0, bound) for the permutations
+** and samples of pcg64, taking the cheaper
+** 32-bit path while bound fits on 32 bits
+*/
+static lua_Integer lua_pcg_pcg64_draw_index(lua_pcg64_random_t *rng, lua_Integer bound)
+{
+    if (bound <= 0xFFFFFFFF)
+    {
+        return (lua_Integer)lua_pcg64_boundedrand32_r(rng, lua_pcg_u32_cast(bound));
+    }
+    return lua_pcg_u64_to_lua_Integer(lua_pcg64_boundedrand_r(rng, lua_pcg_lua_Integer_to_u64(bound)));
+}
+
+/*
+** creates a table holding a random permutation of 1 to n
+** (see lua_pcg_pcg32_permutation)
+*/
+static int lua_pcg_pcg64_permutation(lua_State *L)
+{
+    lua_pcg_table_index k, r;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+    for (k = 0; k < (lua_pcg_table_index)n;)
+    {
+        k++;
+        r = 1 + (lua_pcg_table_index)lua_pcg_pcg64_draw_index(rng, (lua_Integer)k);
+        if (r != k)
+        {
+            lua_rawgeti(L, -1, r);
+            lua_rawseti(L, -2, k);
+        }
+        lua_pushinteger(L, (lua_Integer)k);
+        lua_rawseti(L, -2, r);
+    }
+    return 1;
+}
+
+/*
+** fills a buffer owned by the caller with a random
+** permutation of 0 to (count - 1) of elemsize bytes each,
+** drawing the same positions of 'permutation'
+*/
+static int lua_pcg_pcg64_permutationbuffer(lua_State *L)
+{
+    size_t k, r, count, elemsize;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    unsigned char *dst = lua_pcg_check_buffer(L, 2);
+
+    count = lua_pcg_check_buffer_count(L, 3, 4U, &elemsize);
+    luaL_argcheck(L, elemsize == 8U || count <= 0xFFFFFFFF, 3, "count is out of [0, 4294967295] range for elements of 4 bytes");
+
+    for (k = 0U; k < count; k++)
+    {
+        r = (size_t)lua_pcg_pcg64_draw_index(rng, (lua_Integer)(k + 1U));
+        if (r != k)
+        {
+            memcpy((void *)(dst + k * elemsize), (const void *)(dst + r * elemsize), elemsize);
+        }
+        lua_pcg_permutation_store(dst + r * elemsize, elemsize, k);
+    }
+
+    return 0;
+}
+
+/*
+** creates a table holding k distinct integers
+** drawn uniformly from 1 to n by the pcg64 rng.
+** 
+** When k is at most n / 2, Floyd's algorithm runs
+** on a set of O(k) slots: for each j from n - k + 1
+** to n, a value t is drawn from [1, j], and j is taken
+** in place of t when t was taken before. Otherwise,
+** a partial Fisher-Yates shuffle runs on the
+** n <= 2k integers 1 to n, stopping after k swaps.
+*/
+static int lua_pcg_pcg64_sample(lua_State *L)
+{
+    lua_Integer j, t;
+    lua_pcg_table_index key;
+    lua_Integer *values;
+    lua_pcg_intset set;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+    lua_Integer k = luaL_checkinteger(L, 3);
+
+    luaL_argcheck(L, 0 <= n, 2, "n must be a non-negative integer");
+    luaL_argcheck(L, 0 <= k && k <= n, 3, "k is out of [0, n] range");
+    luaL_argcheck(L, k <= 0x80000000, 3, "k is out of [0, 2147483648] range");
+    luaL_argcheck(L, k <= LUA_PCG_TABLE_INDEX_MAX && ((size_t)k) <= (((size_t)(~(size_t)0)) / (2U * sizeof(lua_Integer))), 3, "k is out of range");
+
+    lua_settop(L, 3);
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 0);
+
+    if (k <= n / 2)
+    {
+        lua_pcg_intset_push(L, &set, (size_t)k);
+        for (j = n - k, key = 0; j < n;)
+        {
+            j++;
+            t = 1 + lua_pcg_pcg64_draw_index(rng, j);
+            if (!lua_pcg_intset_insert(&set, t))
+            {
+                lua_pcg_intset_insert(&set, j);
+                t = j;
+            }
+            lua_pushinteger(L, t);
+            lua_rawseti(L, 4, ++key);
+        }
+    }
+    else
+    {
+        values = (lua_Integer *)lua_newuserdata(L, ((size_t)n) * sizeof(lua_Integer));
+        if (values == NULL)
+        {
+            return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64 sample");
+        }
+        for (j = 0; j < n; j++)
+        {
+            values[j] = j + 1;
+        }
+        for (j = 0, key = 0; j < k; j++)
+        {
+            t = j + lua_pcg_pcg64_draw_index(rng, n - j);
+            lua_pushinteger(L, values[t]);
+            lua_rawseti(L, 4, ++key);
+            values[t] = values[j];
+        }
+    }
+
+    lua_settop(L, 4);
+    return 1;
+}
+
+/* generates a floating-point number in the range (0, 1] from the pcg64 rng */
+static double lua_pcg_pcg64_uniform(void *rng)
+{
+    return 1.0 - lua_pcg_pcg64_nextdouble_r((lua_pcg64_random_t *)rng);
+}
+
+/*
+** parses n and k of the sorted samples of pcg64,
+** which must hold 0 <= k <= n <= 2^53, such that
+** every index is exactly representable as a double
+*/
+static void lua_pcg_pcg64_parse_sorted(lua_State *L, lua_Integer *n, lua_Integer *k)
+{
+    *n = luaL_checkinteger(L, 2);
+    *k = luaL_checkinteger(L, 3);
+    luaL_argcheck(L, 0 <= *n && ((double)(*n)) <= 9007199254740992.0, 2, "n is out of [0, 2^53] range");
+    luaL_argcheck(L, 0 <= *k && *k <= *n, 3, "k is out of [0, n] range");
+}
+
+/*
+** creates a table holding k distinct integers
+** drawn uniformly from 1 to n by the pcg64 rng,
+** in increasing order, through Vitter's sequential
+** random sampling (see lua_pcg_vitter_t)
+*/
+static int lua_pcg_pcg64_samplesorted(lua_State *L)
+{
+    lua_Integer n, k, position;
+    lua_pcg_table_index key;
+    lua_pcg_vitter_t v;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+
+    lua_pcg_pcg64_parse_sorted(L, &n, &k);
+    luaL_argcheck(L, k <= LUA_PCG_TABLE_INDEX_MAX, 3, "k is out of range");
+
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 0);
+    lua_pcg_vitter_init(&v, (double)n, (double)k, lua_pcg_pcg64_uniform, (void *)rng);
+    for (key = 0, position = 0; key < (lua_pcg_table_index)k;)
+    {
+        key++;
+        position += ((lua_Integer)lua_pcg_vitter_skip(&v, lua_pcg_pcg64_uniform, (void *)rng)) + 1;
+        lua_pushinteger(L, position);
+        lua_rawseti(L, -2, key);
+    }
+    return 1;
+}
+
+/*
+** state of an iterator created
+** by the method 'itersorted' of pcg64
+*/
+typedef struct
+{
+    lua_pcg_vitter_t v;
+    lua_Integer position;
+} lua_pcg_pcg64_itersorted_t;
+
+/*
+** the iterator function of a generic for
+** created by the method 'itersorted' of pcg64,
+** which returns the next index and the next
+** selected integer in increasing order.
+** 
+** Note: this function is registered as a C closure
+** holding the pcg64 userdata as its first upvalue
+** and the lua_pcg_pcg64_itersorted_t as its second upvalue.
+*/
+static int lua_pcg_pcg64_itersorted_call(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = (lua_pcg64_random_t_wrapper *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pcg_pcg64_itersorted_t *iter = (lua_pcg_pcg64_itersorted_t *)lua_touserdata(L, lua_upvalueindex(2));
+    lua_pcg64_random_t *rng = wrapper->rng;
+    lua_Integer i = lua_tointeger(L, 2);
+
+    if (rng == NULL)
+    {
+        return luaL_error(L, "pcg64 random was closed previously");
+    }
+
+    if (iter->v.n < 1.0)
+    {
+        return 0;
+    }
+
+    iter->position += ((lua_Integer)lua_pcg_vitter_skip(&(iter->v), lua_pcg_pcg64_uniform, (void *)rng)) + 1;
+    lua_pushinteger(L, i + 1);
+    lua_pushinteger(L, iter->position);
+    return 2;
+}
+
+/*
+** creates an iterator for a generic for yielding
+** the index and k distinct integers drawn uniformly
+** from 1 to n by the pcg64 rng, in increasing order
+*/
+static int lua_pcg_pcg64_itersorted(lua_State *L)
+{
+    lua_Integer n, k;
+    lua_pcg_pcg64_itersorted_t *iter;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+
+    lua_pcg_pcg64_parse_sorted(L, &n, &k);
+
+    lua_settop(L, 1);
+    iter = (lua_pcg_pcg64_itersorted_t *)lua_newuserdata(L, sizeof(lua_pcg_pcg64_itersorted_t));
+    if (iter == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64 iterator");
+    }
+    lua_pcg_vitter_init(&(iter->v), (double)n, (double)k, lua_pcg_pcg64_uniform, (void *)rng);
+    iter->position = 0;
+
+    lua_pushcclosure(L, lua_pcg_pcg64_itersorted_call, 2);
+    lua_pushnil(L);
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+/* gets the 64 bits of a value from the pcg64 rng (see lua_pcg_ziggurat_draw) */
+static void lua_pcg_pcg64_words(void *rng, lua_pcg_u32 *high, lua_pcg_u32 *low)
+{
+    lua_pcg_u64 n = lua_pcg64_random_r((lua_pcg64_random_t *)rng);
+    *high = lua_pcg_u64_cast_to_u32(lua_pcg_u64_rsh(n, 32U));
+    *low = lua_pcg_u64_cast_to_u32(n);
+}
+
+/*
+** gets a normal number of mean mu and standard deviation
+** sigma from the pcg64 rng (see lua_pcg_ziggurat_normal),
+** or creates a table holding n such numbers
+*/
+static int lua_pcg_pcg64_normal(lua_State *L)
+{
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Number mu = luaL_optnumber(L, 2, 0.0);
+    lua_Number sigma = luaL_optnumber(L, 3, 1.0);
+
+    luaL_argcheck(L, mu - mu == 0.0, 2, "mu must be a finite number");
+    luaL_argcheck(L, sigma >= 0.0 && sigma - sigma == 0.0, 3, "sigma must be a finite non-negative number");
+    return lua_pcg_ziggurat_push(L, 4, 1, lua_pcg_pcg64_words, lua_pcg_pcg64_uniform, (void *)rng, mu, sigma);
+}
+
+/*
+** gets an exponential number of rate lambda from the pcg64 rng
+** (see lua_pcg_ziggurat_exponential), or creates a table holding n such numbers
+*/
+static int lua_pcg_pcg64_exponential(lua_State *L)
+{
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_Number lambda = luaL_optnumber(L, 2, 1.0);
+
+    luaL_argcheck(L, lambda > 0.0 && lambda - lambda == 0.0, 2, "lambda must be a finite positive number");
+    return lua_pcg_ziggurat_push(L, 3, 0, lua_pcg_pcg64_words, lua_pcg_pcg64_uniform, (void *)rng, 0.0, 1.0 / lambda);
+}
+
+/* gets the bytes from the next lua_pcg_u64 value provided by the pcg64 rng */
+static int lua_pcg_pcg64_nextbytes(lua_State *L)
+{
+    lua_Integer i;
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    lua_pcg_u64 n = lua_pcg64_random_r(rng);
+
+    lua_createtable(L, 0, 0);
+
+    for (i = 1; i <= 8; i++, n = lua_pcg_u64_rsh(n, 8U))
+    {
+        lua_pushinteger(L, i);
+        lua_pushinteger(L, lua_pcg_u64_cast_to_u8(n));
+        lua_settable(L, -3);
+    }
+
+    return 1;
+}
+
+/* gets the next double-precision number from the pcg64 rng */
+static int lua_pcg_pcg64_nextdouble(lua_State *L)
+{
+    lua_Number offset, scale;
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+
+    lua_pcg_parse_real_bounds(L, 2, nargs - 1, "pcg64", &offset, &scale);
+    lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg64_nextdouble_r(rng)));
+    return 1;
+}
+
+/* gets the next single-precision number from the pcg64 rng */
+static int lua_pcg_pcg64_nextfloat(lua_State *L)
+{
+    lua_Number offset, scale;
+    int nargs = lua_gettop(L);
+    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+
+    lua_pcg_parse_real_bounds(L, 2, nargs - 1, "pcg64", &offset, &scale);
+    lua_pushnumber(L, offset + scale * ((lua_Number)lua_pcg_pcg64_nextfloat_r(rng)));
+    return 1;
+}
+
+/* sets the pcg64 object instance as read-only */
+static int lua_pcg_pcg64_newindex(lua_State *L)
+{
+    return luaL_error(L, "Read-only object");
+}
+
+/* invalidates the pcg64 random instance */
+static int lua_pcg_pcg64_close(lua_State *L)
+{
+    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check(L, 1);
+    wrapper->rng = NULL;
+    return 0;
+}
+
+static const luaL_Reg lua_pcg_pcg64_funcs[] = {
+    {"advance", lua_pcg_pcg64_advance},
+    {"bytes", lua_pcg_pcg64_bytes},
+    {"close", lua_pcg_pcg64_close},
+    {"exponential", lua_pcg_pcg64_exponential},
+    {"fill", lua_pcg_pcg64_fill},
+    {"fillbuffer", lua_pcg_pcg64_fillbuffer},
+    {"filldouble", lua_pcg_pcg64_filldouble},
+    {"fillfloat", lua_pcg_pcg64_fillfloat},
+    {"fillinto", lua_pcg_pcg64_fillinto},
+    {"fromstate", lua_pcg_pcg64_fromstate},
+    {"getstate", lua_pcg_pcg64_getstate},
+    {"iter", lua_pcg_pcg64_iter},
+    {"itersorted", lua_pcg_pcg64_itersorted},
+    {"new", lua_pcg_pcg64_new},
+    {"nextbytes", lua_pcg_pcg64_nextbytes},
+    {"nextdouble", lua_pcg_pcg64_nextdouble},
+    {"nextfloat", lua_pcg_pcg64_nextfloat},
+    {"normal", lua_pcg_pcg64_normal},
+    {"permutation", lua_pcg_pcg64_permutation},
+    {"permutationbuffer", lua_pcg_pcg64_permutationbuffer},
+    {"sample", lua_pcg_pcg64_sample},
+    {"samplesorted", lua_pcg_pcg64_samplesorted},
+    {"sampler", lua_pcg_pcg64_sampler},
+    {"seed", lua_pcg_pcg64_seed},
+    {"setstate", lua_pcg_pcg64_setstate},
+    {"shuffle", lua_pcg_pcg64_shuffle},
+    {"split", lua_pcg_pcg64_split},
+    {NULL, NULL}
+};
+
+/*
+** functions registered as C closures
+** holding the pcg64 metatable as upvalue
+*/
+static const luaL_Reg lua_pcg_pcg64_upvalue_funcs[] = {
+    {"bits", lua_pcg_pcg64_bits},
+    {"bool", lua_pcg_pcg64_bool},
+    {"next", lua_pcg_pcg64_next},
+    {NULL, NULL}
+};
+/* end of pcg64 implementation */
+
+/* 
+** *********************************************
+** *********************************************
+** 
+** Multi-lane generators: pcg32x8 and pcg64x4
+** hold several independent pcg32 (pcg64) states
+** in a struct-of-arrays layout, such that all the
+** lanes can be stepped at once. Each lane reproduces
+** exactly the sequence of a pcg32 (pcg64) rng seeded
+** with the same (initstate, initseq).
+** 
+** *********************************************
+** *********************************************
+*/
+
+#define LUA_PCG_PCG32X8_LANES 8
+#define LUA_PCG_PCG64X4_LANES 4
+
+/*
+** number of rounds (one value per lane)
+** generated at once by bulk methods
+*/
+#define LUA_PCG_LANES_CHUNK_ROUNDS 16
+
+typedef struct
+{
+    lua_pcg_u64 state[LUA_PCG_PCG32X8_LANES];
+    lua_pcg_u64 inc[LUA_PCG_PCG32X8_LANES];
+} lua_pcg32x8_random_t;
+
+typedef struct
+{
+    lua_pcg_u128 state[LUA_PCG_PCG64X4_LANES];
+    lua_pcg_u128 inc[LUA_PCG_PCG64X4_LANES];
+} lua_pcg64x4_random_t;
+
+/*
+** A kernel generates 'rounds' rounds of
+** values from every lane of the pcg32x8 rng,
+** such that out[k * LUA_PCG_PCG32X8_LANES + lane]
+** holds the k-th value of the lane.
+*/
+typedef void (*lua_pcg_pcg32x8_kernel_t)(lua_pcg32x8_random_t *rng, lua_pcg_u32 *out, size_t rounds);
+
+/* portable kernel: steps each lane through lua_pcg32_random_r */
+static void lua_pcg_pcg32x8_scalar_kernel(lua_pcg32x8_random_t *rng, lua_pcg_u32 *out, size_t rounds)
+{
+    int lane;
+    size_t k;
+    lua_pcg32_random_t lane_rng;
+
+    for (lane = 0; lane < LUA_PCG_PCG32X8_LANES; lane++)
+    {
+        lane_rng.state = rng->state[lane];
+        lane_rng.inc = rng->inc[lane];
+
+        for (k = 0U; k < rounds; k++)
+        {
+            out[k * LUA_PCG_PCG32X8_LANES + lane] = lua_pcg32_random_r(&lane_rng);
+        }
+
+        rng->state[lane] = lane_rng.state;
+    }
+}
+
+/*
+** The AVX2 kernel is available on x86
+** through GCC (4.9 or newer) and clang,
+** whose function attribute target("avx2")
+** allows it to be compiled without enabling
+** AVX2 on the whole library. The kernel is
+** selected at runtime only when the CPU supports AVX2.
+*/
+#if ((!defined(LUA_PCG_NO_SIMD)) && (!defined(LUA_PCG_U64_EMULATED)) && (UINT_MAX == 0xFFFFFFFF) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))))))
+#define LUA_PCG_PCG32X8_AVX2
+#endif
+
+#ifdef LUA_PCG_PCG32X8_AVX2
+#include <immintrin.h>
+
+/*
+** Output function of 4 lanes at once:
+** lua_pcg_rotr_32((((s >> 18U) ^ s) >> 27U), (s >> 59U)),
+** where each result is placed on the lower 32-bits of a 64-bit lane.
+*/
+__attribute__((target("avx2")))
+static __m256i lua_pcg_pcg32x8_avx2_output(__m256i s)
+{
+    __m256i mask32 = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i x = _mm256_and_si256(_mm256_srli_epi64(_mm256_xor_si256(_mm256_srli_epi64(s, 18), s), 27), mask32);
+    __m256i rot = _mm256_srli_epi64(s, 59);
+    __m256i left = _mm256_sllv_epi64(x, _mm256_sub_epi64(_mm256_set1_epi64x(32), rot));
+    return _mm256_and_si256(_mm256_or_si256(_mm256_srlv_epi64(x, rot), left), mask32);
+}
+
+/*
+** Step function of 4 lanes at once: s * mult + inc,
+** where mult is given by its lower and upper 32-bits.
+** The 64-bit multiplication is built from
+** 32x32->64 multiplications, because AVX2
+** lacks a 64-bit multiplication.
+*/
+__attribute__((target("avx2")))
+static __m256i lua_pcg_pcg32x8_avx2_step(__m256i s, __m256i mult_low, __m256i mult_high, __m256i inc)
+{
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(s, 32), mult_low), _mm256_mul_epu32(s, mult_high));
+    return _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(s, mult_low), _mm256_slli_epi64(cross, 32)), inc);
+}
+
+/* stores the 8 outputs of a round sorted by lane */
+__attribute__((target("avx2")))
+static void lua_pcg_pcg32x8_avx2_store(lua_pcg_u32 *out, __m256i out0, __m256i out1)
+{
+    __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    __m256i res = _mm256_blend_epi32(out0, _mm256_slli_epi64(out1, 32), 0xAA);
+    _mm256_storeu_si256((__m256i *)out, _mm256_permutevar8x32_epi32(res, pack));
+}
+
+/*
+** Each 256-bit register holds the states of 4 lanes.
+** 
+** A single LCG step is a serial dependency chain
+** bounded by the latency of the multiplication.
+** So, to keep more independent chains in flight,
+** the kernel tracks the states of two consecutive
+** rounds (state and ahead), jumping both by
+** two steps at once through the multiplier
+** mult2 = (mult * mult) and the increment inc2 = inc * (mult + 1).
+*/
+__attribute__((target("avx2")))
+static void lua_pcg_pcg32x8_avx2_kernel(lua_pcg32x8_random_t *rng, lua_pcg_u32 *out, size_t rounds)
+{
+    int lane;
+    size_t k;
+    lua_pcg_u64 inc2[LUA_PCG_PCG32X8_LANES];
+    lua_pcg_u64 mult = LUA_PCG_DEFAULT_MULTIPLIER_64;
+    lua_pcg_u64 mult2 = lua_pcg_u64_mul(mult, mult);
+    __m256i mult_low = _mm256_set1_epi64x(lua_pcg_u64_cast_to_u32(mult));
+    __m256i mult_high = _mm256_set1_epi64x(lua_pcg_u64_cast_to_u32(mult >> 32U));
+    __m256i mult2_low = _mm256_set1_epi64x(lua_pcg_u64_cast_to_u32(mult2));
+    __m256i mult2_high = _mm256_set1_epi64x(lua_pcg_u64_cast_to_u32(mult2 >> 32U));
+    __m256i state0 = _mm256_loadu_si256((const __m256i *)(rng->state));
+    __m256i state1 = _mm256_loadu_si256((const __m256i *)(rng->state + 4));
+    __m256i inc0 = _mm256_loadu_si256((const __m256i *)(rng->inc));
+    __m256i inc1 = _mm256_loadu_si256((const __m256i *)(rng->inc + 4));
+    __m256i ahead0, ahead1, inc2_0, inc2_1;
+
+    if (rounds >= 2U)
+    {
+        for (lane = 0; lane < LUA_PCG_PCG32X8_LANES; lane++)
+        {
+            inc2[lane] = lua_pcg_u64_mul(rng->inc[lane], lua_pcg_u64_sum(mult, 1U));
+        }
+
+        inc2_0 = _mm256_loadu_si256((const __m256i *)inc2);
+        inc2_1 = _mm256_loadu_si256((const __m256i *)(inc2 + 4));
+        ahead0 = lua_pcg_pcg32x8_avx2_step(state0, mult_low, mult_high, inc0);
+        ahead1 = lua_pcg_pcg32x8_avx2_step(state1, mult_low, mult_high, inc1);
+
+        for (k = 0U; k + 2U <= rounds; k += 2U)
+        {
+            lua_pcg_pcg32x8_avx2_store(out + k * LUA_PCG_PCG32X8_LANES, lua_pcg_pcg32x8_avx2_output(state0), lua_pcg_pcg32x8_avx2_output(state1));
+            lua_pcg_pcg32x8_avx2_store(out + (k + 1U) * LUA_PCG_PCG32X8_LANES, lua_pcg_pcg32x8_avx2_output(ahead0), lua_pcg_pcg32x8_avx2_output(ahead1));
+            state0 = lua_pcg_pcg32x8_avx2_step(state0, mult2_low, mult2_high, inc2_0);
+            state1 = lua_pcg_pcg32x8_avx2_step(state1, mult2_low, mult2_high, inc2_1);
+            ahead0 = lua_pcg_pcg32x8_avx2_step(ahead0, mult2_low, mult2_high, inc2_0);
+            ahead1 = lua_pcg_pcg32x8_avx2_step(ahead1, mult2_low, mult2_high, inc2_1);
+        }
+    }
+    else
+    {
+        k = 0U;
+    }
+
+    if (k < rounds) /* odd number of rounds */
+    {
+        lua_pcg_pcg32x8_avx2_store(out + k * LUA_PCG_PCG32X8_LANES, lua_pcg_pcg32x8_avx2_output(state0), lua_pcg_pcg32x8_avx2_output(state1));
+        state0 = lua_pcg_pcg32x8_avx2_step(state0, mult_low, mult_high, inc0);
+        state1 = lua_pcg_pcg32x8_avx2_step(state1, mult_low, mult_high, inc1);
+    }
+
+    _mm256_storeu_si256((__m256i *)(rng->state), state0);
+    _mm256_storeu_si256((__m256i *)(rng->state + 4), state1);
+}
+#endif
+
+/*
+** selects the fastest kernel supported by the CPU
+** 
+** Note: the selection is not cached on static storage,
+** such that Lua states on different threads never race
+** on it. Instead, each pcg32x8 rng stores the kernel
+** selected once on its creation (see lua_pcg_pcg32x8_new).
+*/
+static lua_pcg_pcg32x8_kernel_t lua_pcg_pcg32x8_select_kernel(void)
+{
+#ifdef LUA_PCG_PCG32X8_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return lua_pcg_pcg32x8_avx2_kernel;
+    }
+#endif
+    return lua_pcg_pcg32x8_scalar_kernel;
+}
+
+/* seeds every lane, where lane i uses the stream (initseq + i) */
+static void lua_pcg_pcg32x8_srandom_r(lua_pcg32x8_random_t *rng, lua_pcg_u64 initstate, lua_pcg_u64 initseq)
+{
+    int lane;
+    lua_pcg32_random_t lane_rng;
+
+    for (lane = 0; lane < LUA_PCG_PCG32X8_LANES; lane++)
+    {
+        lua_pcg32_srandom_r(&lane_rng, initstate, lua_pcg_u64_sum(initseq, lua_pcg_u64_lh(lane, 0U)));
+        rng->state[lane] = lane_rng.state;
+        rng->inc[lane] = lane_rng.inc;
+    }
+}
+
+/*
+** Generates 'count' values from the pcg32x8 rng
+** interleaving the lanes, such that out[i] comes
+** from the lane (i % LUA_PCG_PCG32X8_LANES).
+** 
+** Note: when count is not a multiple of the
+**       number of lanes, only the first
+**       (count % LUA_PCG_PCG32X8_LANES) lanes
+**       are stepped on the last round.
+*/
+static void lua_pcg_pcg32x8_generate(lua_pcg_pcg32x8_kernel_t kernel, lua_pcg32x8_random_t *rng, lua_pcg_u32 *out, size_t count)
+{
+    size_t k;
+    size_t rounds = count / LUA_PCG_PCG32X8_LANES;
+    lua_pcg32_random_t lane_rng;
+
+    if (rounds > 0U)
+    {
+        kernel(rng, out, rounds);
+    }
+
+    for (k = rounds * LUA_PCG_PCG32X8_LANES; k < count; k++)
+    {
+        lane_rng.state = rng->state[k % LUA_PCG_PCG32X8_LANES];
+        lane_rng.inc = rng->inc[k % LUA_PCG_PCG32X8_LANES];
+        out[k] = lua_pcg32_random_r(&lane_rng);
+        rng->state[k % LUA_PCG_PCG32X8_LANES] = lane_rng.state;
+    }
+}
+
+/*
+** Structure to wrap a lua_pcg32x8_random_t
+** (see lua_pcg32_random_t_wrapper) along
+** with the kernel selected on its creation
+*/
+typedef struct
+{
+    lua_pcg32x8_random_t *rng;
+    lua_pcg_pcg32x8_kernel_t kernel;
+} lua_pcg32x8_random_t_wrapper;
+
+static lua_pcg32x8_random_t_wrapper *lua_pcg_pcg32x8_check(lua_State *L, int index)
+{
+    void *ud = luaL_checkudata(L, index, LUA_PCG_PCG32X8_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "pcg32x8 random expected");
+    return (lua_pcg32x8_random_t_wrapper *)ud;
+}
+
+static lua_pcg32x8_random_t_wrapper *lua_pcg_pcg32x8_check_open(lua_State *L, int index)
+{
+    lua_pcg32x8_random_t_wrapper *wrapper = lua_pcg_pcg32x8_check(L, index);
+    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg32x8 random was closed previously");
+    return wrapper;
+}
+
+static lua_pcg32x8_random_t *lua_pcg_pcg32x8_check_rng(lua_State *L, int index)
+{
+    return lua_pcg_pcg32x8_check_open(L, index)->rng;
+}
+
+/* creates a lua_pcg32x8_random_t (rng) */
+static int lua_pcg_pcg32x8_new(lua_State *L)
+{
+    lua_pcg_u128 v1;
+    lua_pcg_u128 v2;
+    lua_pcg_u64 initstate;
+    lua_pcg_u64 initseq;
+    lua_pcg32x8_random_t_wrapper *wrapper;
+    void *block;
+    void *ud;
+    int nargs;
+
+    nargs = lua_gettop(L);
+    ud = lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg32x8_random_t_wrapper), sizeof(lua_pcg32x8_random_t), &block);
+    if (ud == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg32x8 random");
+    }
+    luaL_getmetatable(L, LUA_PCG_PCG32X8_METATABLE);
+    lua_setmetatable(L, -2);
+
+    wrapper = (lua_pcg32x8_random_t_wrapper *)ud;
+    wrapper->rng = (lua_pcg32x8_random_t *)block;
+    wrapper->kernel = lua_pcg_pcg32x8_select_kernel();
+
+    switch (nargs)
+    {
+        case 0: /* no args? generate both initstate and initseq */
+        {
+            lua_pcg_fill_with_random_bytes(ud, &v1, &v2);
+            initstate = lua_pcg_u128_cast_to_u64(v1);
+            initseq = lua_pcg_u128_cast_to_u64(v2);
+            break;
+        }
+        case 1: /* only initstate was provided? then generate initseq */
+        {
+            initstate = lua_pcg_parse_u64_arg(L, 1);
+            lua_pcg_fill_with_random_bytes(ud, NULL, &v2);
+            initseq = lua_pcg_u128_cast_to_u64(v2);
+            break;
+        }
+        case 2: /* both initstate and initseq were provided */
+        {
+            initstate = lua_pcg_parse_u64_arg(L, 1);
+            initseq = lua_pcg_parse_u64_arg(L, 2);
+            break;
+        }
+        default:
+        {
+            return luaL_error(L, "Unknown number of arguments to create a pcg32x8 instance");
+        }
+    }
+
+    lua_pcg_pcg32x8_srandom_r(wrapper->rng, initstate, initseq);
+    return 1;
+}
+
+/* advances every lane of a lua_pcg32x8_random_t (rng) by delta */
+static int lua_pcg_pcg32x8_advance(lua_State *L)
+{
+    int lane;
+    lua_pcg32_random_t lane_rng;
+    lua_pcg32x8_random_t *rng = lua_pcg_pcg32x8_check_rng(L, 1);
+    lua_pcg_u64 delta = lua_pcg_parse_u64_arg(L, 2);
+
+    for (lane = 0; lane < LUA_PCG_PCG32X8_LANES; lane++)
+    {
+        lane_rng.state = rng->state[lane];
+        lane_rng.inc = rng->inc[lane];
+        lua_pcg32_advance_r(&lane_rng, delta);
+        rng->state[lane] = lane_rng.state;
+    }
+
+    return 0;
+}
+
+/*
+** seed the pcg32x8 rng: every lane
+** when lane is not provided, or a single lane
+*/
+static int lua_pcg_pcg32x8_seed(lua_State *L)
+{
+    lua_Integer lane;
+    lua_pcg32_random_t lane_rng;
+    lua_pcg32x8_random_t *rng = lua_pcg_pcg32x8_check_rng(L, 1);
+    lua_pcg_u64 initstate = lua_pcg_parse_u64_arg(L, 2);
+    lua_pcg_u64 initseq = lua_pcg_parse_u64_arg(L, 3);
+
+    if (lua_isnoneornil(L, 4))
+    {
+        lua_pcg_pcg32x8_srandom_r(rng, initstate, initseq);
+    }
+    else
+    {
+        lane = luaL_checkinteger(L, 4);
+        luaL_argcheck(L, 1 <= lane && lane <= LUA_PCG_PCG32X8_LANES, 4, "lane is out of [1, 8] range");
+
+        lua_pcg32_srandom_r(&lane_rng, initstate, initseq);
+        rng->state[lane - 1] = lane_rng.state;
+        rng->inc[lane - 1] = lane_rng.inc;
+    }
+
+    return 0;
+}
+
+/* gets the next lua_pcg_u32 value from each lane of the pcg32x8 rng */
+static int lua_pcg_pcg32x8_next(lua_State *L)
+{
+    int lane;
+    lua_pcg_u32 values[LUA_PCG_PCG32X8_LANES];
+    lua_pcg32x8_random_t_wrapper *wrapper = lua_pcg_pcg32x8_check_open(L, 1);
+
+    wrapper->kernel(wrapper->rng, values, 1U);
+    luaL_checkstack(L, LUA_PCG_PCG32X8_LANES, NULL);
+
+    for (lane = 0; lane < LUA_PCG_PCG32X8_LANES; lane++)
+    {
+        lua_pushinteger(L, (lua_Integer)values[lane]);
+    }
+
+    return LUA_PCG_PCG32X8_LANES;
+}
+
+/* creates a table holding n interleaved values from the lanes of the pcg32x8 rng */
+static int lua_pcg_pcg32x8_fill(lua_State *L)
+{
+    size_t k, chunk;
+    lua_Integer remaining;
+    lua_pcg_table_index key = 0;
+    lua_pcg_u32 values[LUA_PCG_PCG32X8_LANES * LUA_PCG_LANES_CHUNK_ROUNDS];
+    lua_pcg32x8_random_t_wrapper *wrapper = lua_pcg_pcg32x8_check_open(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+
+    for (remaining = n; remaining > 0; remaining -= (lua_Integer)chunk)
+    {
+        chunk = remaining < ((lua_Integer)(sizeof(values) / sizeof(values[0]))) ? ((size_t)remaining) : (sizeof(values) / sizeof(values[0]));
+        lua_pcg_pcg32x8_generate(wrapper->kernel, wrapper->rng, values, chunk);
+
+        for (k = 0U; k < chunk; k++)
+        {
+            lua_pushinteger(L, (lua_Integer)values[k]);
+            lua_rawseti(L, -2, ++key);
+        }
+    }
+
+    return 1;
+}
+
+/*
+** fills a buffer owned by the caller with count
+** 32-bit interleaved values from the lanes of the pcg32x8 rng
+*/
+static int lua_pcg_pcg32x8_fillbuffer(lua_State *L)
+{
+    size_t k, chunk, remaining, elemsize;
+    lua_pcg_u32 values[LUA_PCG_PCG32X8_LANES * LUA_PCG_LANES_CHUNK_ROUNDS];
+    lua_pcg32x8_random_t_wrapper *wrapper = lua_pcg_pcg32x8_check_open(L, 1);
+    unsigned char *dst = lua_pcg_check_buffer(L, 2);
+
+    remaining = lua_pcg_check_buffer_count(L, 3, 4U, &elemsize);
+    luaL_argcheck(L, elemsize == 4U, 4, "elemsize must be 4");
+
+    for (; remaining > 0U; remaining -= chunk)
+    {
+        chunk = remaining < (sizeof(values) / sizeof(values[0])) ? remaining : (sizeof(values) / sizeof(values[0]));
+        lua_pcg_pcg32x8_generate(wrapper->kernel, wrapper->rng, values, chunk);
+
+        for (k = 0U; k < chunk; k++, dst += 4)
+        {
+            lua_pcg_store_u32(dst, values[k]);
+        }
+    }
+
+    return 0;
+}
+
+/* sets the pcg32x8 object instance as read-only */
+static int lua_pcg_pcg32x8_newindex(lua_State *L)
+{
+    return luaL_error(L, "Read-only object");
+}
+
+/* invalidates the pcg32x8 random instance */
+static int lua_pcg_pcg32x8_close(lua_State *L)
+{
+    lua_pcg32x8_random_t_wrapper *wrapper = lua_pcg_pcg32x8_check(L, 1);
+    wrapper->rng = NULL;
+    return 0;
+}
+
+static const luaL_Reg lua_pcg_pcg32x8_funcs[] = {
+    {"advance", lua_pcg_pcg32x8_advance},
+    {"close", lua_pcg_pcg32x8_close},
+    {"fill", lua_pcg_pcg32x8_fill},
+    {"fillbuffer", lua_pcg_pcg32x8_fillbuffer},
+    {"new", lua_pcg_pcg32x8_new},
+    {"next", lua_pcg_pcg32x8_next},
+    {"seed", lua_pcg_pcg32x8_seed},
+    {NULL, NULL}
+};
+/* end of pcg32x8 implementation */
+
+/*
+** pcg64x4 steps its lanes through a portable loop,
+** because neither SSE2 nor AVX2 provide the 64x64->128
+** multiplication required by the 128-bit LCG.
+*/
+
+/* generates one round of values from the lanes of the pcg64x4 rng */
+static void lua_pcg_pcg64x4_round(lua_pcg64x4_random_t *rng, lua_pcg_u64 *out)
+{
+    int lane;
+    lua_pcg64_random_t lane_rng;
+
+    for (lane = 0; lane < LUA_PCG_PCG64X4_LANES; lane++)
+    {
+        lane_rng.state = rng->state[lane];
+        lane_rng.inc = rng->inc[lane];
+        out[lane] = lua_pcg64_random_r(&lane_rng);
+        rng->state[lane] = lane_rng.state;
+    }
+}
+
+/* seeds every lane, where lane i uses the stream (initseq + i) */
+static void lua_pcg_pcg64x4_srandom_r(lua_pcg64x4_random_t *rng, lua_pcg_u128 initstate, lua_pcg_u128 initseq)
+{
+    int lane;
+    lua_pcg64_random_t lane_rng;
+
+    for (lane = 0; lane < LUA_PCG_PCG64X4_LANES; lane++)
+    {
+        lua_pcg64_srandom_r(&lane_rng, initstate, lua_pcg_u128_sum(initseq, lua_pcg_u128_lh(lua_pcg_u64_lh(lane, 0U), lua_pcg_u64_lh(0U, 0U))));
+        rng->state[lane] = lane_rng.state;
+        rng->inc[lane] = lane_rng.inc;
+    }
+}
+
+/*
+** Generates 'count' values from the pcg64x4 rng
+** interleaving the lanes (see lua_pcg_pcg32x8_generate)
+*/
+static void lua_pcg_pcg64x4_generate(lua_pcg64x4_random_t *rng, lua_pcg_u64 *out, size_t count)
+{
+    size_t k;
+    lua_pcg64_random_t lane_rng;
+
+    for (k = 0U; k + LUA_PCG_PCG64X4_LANES <= count; k += LUA_PCG_PCG64X4_LANES)
+    {
+        lua_pcg_pcg64x4_round(rng, out + k);
+    }
+
+    for (; k < count; k++)
+    {
+        lane_rng.state = rng->state[k % LUA_PCG_PCG64X4_LANES];
+        lane_rng.inc = rng->inc[k % LUA_PCG_PCG64X4_LANES];
+        out[k] = lua_pcg64_random_r(&lane_rng);
+        rng->state[k % LUA_PCG_PCG64X4_LANES] = lane_rng.state;
+    }
+}
+
+/*
+** Structure to wrap a lua_pcg64x4_random_t
+** (see lua_pcg64_random_t_wrapper)
+*/
+typedef struct
+{
+    lua_pcg64x4_random_t *rng;
+} lua_pcg64x4_random_t_wrapper;
+
+static lua_pcg64x4_random_t_wrapper *lua_pcg_pcg64x4_check(lua_State *L, int index)
+{
+    void *ud = luaL_checkudata(L, index, LUA_PCG_PCG64X4_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "pcg64x4 random expected");
+    return (lua_pcg64x4_random_t_wrapper *)ud;
+}
+
+static lua_pcg64x4_random_t *lua_pcg_pcg64x4_check_rng(lua_State *L, int index)
+{
+    lua_pcg64x4_random_t_wrapper *wrapper = lua_pcg_pcg64x4_check(L, index);
+    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg64x4 random was closed previously");
+    return wrapper->rng;
+}
+
+/* creates a lua_pcg64x4_random_t (rng) */
+static int lua_pcg_pcg64x4_new(lua_State *L)
+{
+    lua_pcg_u128 initstate;
+    lua_pcg_u128 initseq;
+    lua_pcg64x4_random_t_wrapper *wrapper;
+    void *block;
+    void *ud;
+    int nargs;
+
+    nargs = lua_gettop(L);
+    ud = lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg64x4_random_t_wrapper), sizeof(lua_pcg64x4_random_t), &block);
+    if (ud == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64x4 random");
+    }
+    luaL_getmetatable(L, LUA_PCG_PCG64X4_METATABLE);
+    lua_setmetatable(L, -2);
+
+    wrapper = (lua_pcg64x4_random_t_wrapper *)ud;
+    wrapper->rng = (lua_pcg64x4_random_t *)block;
+
+    switch (nargs)
+    {
+        case 0: /* no args? generate both initstate and initseq */
+        {
+            lua_pcg_fill_with_random_bytes(ud, &initstate, &initseq);
+            break;
+        }
+        case 1: /* only initstate was provided? then generate initseq */
+        {
+            initstate = lua_pcg_parse_u128_arg(L, 1);
+            lua_pcg_fill_with_random_bytes(ud, NULL, &initseq);
+            break;
         }
         case 2: /* both initstate and initseq were provided */
         {
-            initstate = lua_pcg_parse_u64_arg(L, 1);
-            initseq = lua_pcg_parse_u64_arg(L, 2);
+            initstate = lua_pcg_parse_u128_arg(L, 1);
+            initseq = lua_pcg_parse_u128_arg(L, 2);
+            break;
+        }
+        default:
+        {
+            return luaL_error(L, "Unknown number of arguments to create a pcg64x4 instance");
+        }
+    }
+
+    lua_pcg_pcg64x4_srandom_r(wrapper->rng, initstate, initseq);
+    return 1;
+}
+
+/* advances every lane of a lua_pcg64x4_random_t (rng) by delta */
+static int lua_pcg_pcg64x4_advance(lua_State *L)
+{
+    int lane;
+    lua_pcg64_random_t lane_rng;
+    lua_pcg64x4_random_t *rng = lua_pcg_pcg64x4_check_rng(L, 1);
+    lua_pcg_u128 delta = lua_pcg_parse_u128_arg(L, 2);
+
+    for (lane = 0; lane < LUA_PCG_PCG64X4_LANES; lane++)
+    {
+        lane_rng.state = rng->state[lane];
+        lane_rng.inc = rng->inc[lane];
+        lua_pcg64_advance_r(&lane_rng, delta);
+        rng->state[lane] = lane_rng.state;
+    }
+
+    return 0;
+}
+
+/*
+** seed the pcg64x4 rng: every lane
+** when lane is not provided, or a single lane
+*/
+static int lua_pcg_pcg64x4_seed(lua_State *L)
+{
+    lua_Integer lane;
+    lua_pcg64_random_t lane_rng;
+    lua_pcg64x4_random_t *rng = lua_pcg_pcg64x4_check_rng(L, 1);
+    lua_pcg_u128 initstate = lua_pcg_parse_u128_arg(L, 2);
+    lua_pcg_u128 initseq = lua_pcg_parse_u128_arg(L, 3);
+
+    if (lua_isnoneornil(L, 4))
+    {
+        lua_pcg_pcg64x4_srandom_r(rng, initstate, initseq);
+    }
+    else
+    {
+        lane = luaL_checkinteger(L, 4);
+        luaL_argcheck(L, 1 <= lane && lane <= LUA_PCG_PCG64X4_LANES, 4, "lane is out of [1, 4] range");
+
+        lua_pcg64_srandom_r(&lane_rng, initstate, initseq);
+        rng->state[lane - 1] = lane_rng.state;
+        rng->inc[lane - 1] = lane_rng.inc;
+    }
+
+    return 0;
+}
+
+/* gets the next lua_pcg_u64 value from each lane of the pcg64x4 rng */
+static int lua_pcg_pcg64x4_next(lua_State *L)
+{
+    int lane;
+    lua_pcg_u64 values[LUA_PCG_PCG64X4_LANES];
+    lua_pcg64x4_random_t *rng = lua_pcg_pcg64x4_check_rng(L, 1);
+
+    lua_pcg_pcg64x4_round(rng, values);
+    luaL_checkstack(L, LUA_PCG_PCG64X4_LANES, NULL);
+
+    for (lane = 0; lane < LUA_PCG_PCG64X4_LANES; lane++)
+    {
+        lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(values[lane]));
+    }
+
+    return LUA_PCG_PCG64X4_LANES;
+}
+
+/* creates a table holding n interleaved values from the lanes of the pcg64x4 rng */
+static int lua_pcg_pcg64x4_fill(lua_State *L)
+{
+    size_t k, chunk;
+    lua_Integer remaining;
+    lua_pcg_table_index key = 0;
+    lua_pcg_u64 values[LUA_PCG_PCG64X4_LANES * LUA_PCG_LANES_CHUNK_ROUNDS];
+    lua_pcg64x4_random_t *rng = lua_pcg_pcg64x4_check_rng(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, 0 <= n && n <= LUA_PCG_TABLE_INDEX_MAX, 2, "n is out of range");
+
+    lua_createtable(L, n <= INT_MAX ? (int)n : 0, 0);
+
+    for (remaining = n; remaining > 0; remaining -= (lua_Integer)chunk)
+    {
+        chunk = remaining < ((lua_Integer)(sizeof(values) / sizeof(values[0]))) ? ((size_t)remaining) : (sizeof(values) / sizeof(values[0]));
+        lua_pcg_pcg64x4_generate(rng, values, chunk);
+
+        for (k = 0U; k < chunk; k++)
+        {
+            lua_pushinteger(L, lua_pcg_u64_to_lua_Integer(values[k]));
+            lua_rawseti(L, -2, ++key);
+        }
+    }
+
+    return 1;
+}
+
+/*
+** fills a buffer owned by the caller with count
+** 64-bit interleaved values from the lanes of the pcg64x4 rng
+*/
+static int lua_pcg_pcg64x4_fillbuffer(lua_State *L)
+{
+    size_t k, chunk, remaining, elemsize;
+    lua_pcg_u64 values[LUA_PCG_PCG64X4_LANES * LUA_PCG_LANES_CHUNK_ROUNDS];
+    lua_pcg64x4_random_t *rng = lua_pcg_pcg64x4_check_rng(L, 1);
+    unsigned char *dst = lua_pcg_check_buffer(L, 2);
+
+    remaining = lua_pcg_check_buffer_count(L, 3, 8U, &elemsize);
+    luaL_argcheck(L, elemsize == 8U, 4, "elemsize must be 8");
+
+    for (; remaining > 0U; remaining -= chunk)
+    {
+        chunk = remaining < (sizeof(values) / sizeof(values[0])) ? remaining : (sizeof(values) / sizeof(values[0]));
+        lua_pcg_pcg64x4_generate(rng, values, chunk);
+
+        for (k = 0U; k < chunk; k++, dst += 8)
+        {
+            lua_pcg_store_u64(dst, values[k]);
+        }
+    }
+
+    return 0;
+}
+
+/* sets the pcg64x4 object instance as read-only */
+static int lua_pcg_pcg64x4_newindex(lua_State *L)
+{
+    return luaL_error(L, "Read-only object");
+}
+
+/* invalidates the pcg64x4 random instance */
+static int lua_pcg_pcg64x4_close(lua_State *L)
+{
+    lua_pcg64x4_random_t_wrapper *wrapper = lua_pcg_pcg64x4_check(L, 1);
+    wrapper->rng = NULL;
+    return 0;
+}
+
+static const luaL_Reg lua_pcg_pcg64x4_funcs[] = {
+    {"advance", lua_pcg_pcg64x4_advance},
+    {"close", lua_pcg_pcg64x4_close},
+    {"fill", lua_pcg_pcg64x4_fill},
+    {"fillbuffer", lua_pcg_pcg64x4_fillbuffer},
+    {"new", lua_pcg_pcg64x4_new},
+    {"next", lua_pcg_pcg64x4_next},
+    {"seed", lua_pcg_pcg64x4_seed},
+    {NULL, NULL}
+};
+/* end of pcg64x4 implementation */
+
+/* 
+** *********************************************
+** *********************************************
+** 
+** Classes drawing random numbers from an
+** instance of pcg32 or pcg64 passed by the caller
+** 
+** *********************************************
+** *********************************************
+*/
+
+/*
+** Generic access to the rng of a pcg32 or pcg64 userdata
+** ('wrapper'), such that the classes below are able to call
+** the C implementation of either class without going back to Lua.
+** 
+** 'rng' returns the rng of the wrapper (NULL after 'close'),
+** 'uniform' draws a floating-point number in the range (0, 1],
+** and 'index' draws an integer in the range [0, bound)
+** for 1 <= bound <= 4294967295.
+*/
+typedef struct
+{
+    const char *name;
+    void *(*rng)(void *wrapper);
+    lua_pcg_uniform_fn uniform;
+    lua_Integer (*index)(void *rng, lua_Integer bound);
+} lua_pcg_source_t;
+
+static void *lua_pcg_pcg32_source_rng(void *wrapper)
+{
+    return (void *)(((lua_pcg32_random_t_wrapper *)wrapper)->rng);
+}
+
+static lua_Integer lua_pcg_pcg32_source_index(void *rng, lua_Integer bound)
+{
+    return (lua_Integer)lua_pcg32_boundedrand_r((lua_pcg32_random_t *)rng, lua_pcg_u32_cast(bound));
+}
+
+static void *lua_pcg_pcg64_source_rng(void *wrapper)
+{
+    return (void *)(((lua_pcg64_random_t_wrapper *)wrapper)->rng);
+}
+
+static lua_Integer lua_pcg_pcg64_source_index(void *rng, lua_Integer bound)
+{
+    return (lua_Integer)lua_pcg64_boundedrand32_r((lua_pcg64_random_t *)rng, lua_pcg_u32_cast(bound));
+}
+
+static const lua_pcg_source_t lua_pcg_pcg32_source = {
+    "pcg32",
+    lua_pcg_pcg32_source_rng,
+    lua_pcg_pcg32_uniform,
+    lua_pcg_pcg32_source_index
+};
+
+static const lua_pcg_source_t lua_pcg_pcg64_source = {
+    "pcg64",
+    lua_pcg_pcg64_source_rng,
+    lua_pcg_pcg64_uniform,
+    lua_pcg_pcg64_source_index
+};
+
+/*
+** checks whether the value at index is an instance
+** of pcg32 or pcg64 not closed yet, returning
+** its source and storing its userdata on 'wrapper'
+*/
+static const lua_pcg_source_t *lua_pcg_check_source(lua_State *L, int index, void **wrapper)
+{
+    const lua_pcg_source_t *source = NULL;
+    void *ud = lua_touserdata(L, index);
+
+    if (ud != NULL && lua_getmetatable(L, index))
+    {
+        luaL_getmetatable(L, LUA_PCG_PCG32_METATABLE);
+        if (lua_rawequal(L, -2, -1))
+        {
+            source = &lua_pcg_pcg32_source;
+        }
+        else
+        {
+            lua_pop(L, 1);
+            luaL_getmetatable(L, LUA_PCG_PCG64_METATABLE);
+            if (lua_rawequal(L, -2, -1))
+            {
+                source = &lua_pcg_pcg64_source;
+            }
+        }
+        lua_pop(L, 2);
+    }
+
+    luaL_argcheck(L, source != NULL, index, "pcg32 or pcg64 random expected");
+    if (source->rng(ud) == NULL)
+    {
+        luaL_argerror(L, index, lua_pushfstring(L, "%s random was closed previously", source->name));
+    }
+    *wrapper = ud;
+    return source;
+}
+
+/*
+** checks whether the value at index is an instance
+** of pcg32 or pcg64 not closed yet, comparing its metatable
+** against the metatables of pcg32 and pcg64 cached as the
+** second and third upvalues of the running C function
+** (see lua_pcg_setfuncs_source_upvalues)
+*/
+static const lua_pcg_source_t *lua_pcg_check_source_upvalue(lua_State *L, int index, void **wrapper)
+{
+    const lua_pcg_source_t *source = NULL;
+    void *ud = lua_touserdata(L, index);
+
+    if (ud != NULL && lua_getmetatable(L, index))
+    {
+        if (lua_rawequal(L, -1, lua_upvalueindex(2)))
+        {
+            source = &lua_pcg_pcg32_source;
+        }
+        else if (lua_rawequal(L, -1, lua_upvalueindex(3)))
+        {
+            source = &lua_pcg_pcg64_source;
+        }
+        lua_pop(L, 1);
+    }
+
+    if (source == NULL || source->rng(ud) == NULL)
+    {
+        /* raises the usual error */
+        return lua_pcg_check_source(L, index, wrapper);
+    }
+    *wrapper = ud;
+    return source;
+}
+
+/*
+** registers the functions of 'funcs' on the table at the
+** top of the stack as C closures holding that table,
+** the metatable of pcg32 and the metatable of pcg64 as upvalues
+*/
+static void lua_pcg_setfuncs_source_upvalues(lua_State *L, const luaL_Reg *funcs)
+{
+    for (; funcs->name != NULL; funcs++)
+    {
+        lua_pushstring(L, funcs->name);
+        lua_pushvalue(L, -2);
+        luaL_getmetatable(L, LUA_PCG_PCG32_METATABLE);
+        luaL_getmetatable(L, LUA_PCG_PCG64_METATABLE);
+        lua_pushcclosure(L, funcs->func, 3);
+        lua_settable(L, -3);
+    }
+}
+
+/*
+** compatibility layer to store a table
+** on a userdata (its environment on Lua 5.1)
+*/
+#if LUA_VERSION_NUM < 502
+#define lua_pcg_getuservalue(L, idx) lua_getfenv(L, idx)
+#define lua_pcg_setuservalue(L, idx) lua_setfenv(L, idx)
+#else
+#define lua_pcg_getuservalue(L, idx) lua_getuservalue(L, idx)
+#define lua_pcg_setuservalue(L, idx) lua_setuservalue(L, idx)
+#endif
+
+/* start of reservoir implementation */
+
+/*
+** node of the min-heap of a weighted reservoir,
+** holding the key (in log scale) of the item
+** stored at the position 'slot' of the reservoir
+*/
+typedef struct
+{
+    double key;
+    lua_pcg_table_index slot;
+} lua_pcg_reservoir_node_t;
+
+/*
+** Streaming reservoir sampling of k items
+** 
+** The items are stored on the positions 1 to k
+** of a table set as the user value of the reservoir,
+** which also holds the rng userdata on the field 'rng'
+** to keep it alive. 'count' is the number of items pushed
+** so far, and 'size' the number of items stored.
+** 
+** Once the reservoir is full, the number of items
+** to be skipped is drawn at once, such that most
+** pushes do not draw any random number:
+** 
+** 1. Unweighted (Algorithm L): 'w' holds the largest
+**    of the k uniform keys, and 'skip' the number of
+**    items to be discarded before the next one is stored.
+**    See K.-H. Li, "Reservoir-sampling algorithms of
+**    time complexity O(n(1 + log(N/n)))",
+**    ACM Trans. Math. Softw. 20(4), 1994.
+** 
+** 2. Weighted (A-ExpJ): 'heap' is a min-heap of the
+**    keys log(u) / w of the stored items, and 'skip' the
+**    sum of weights to be discarded before the next item
+**    replaces the one holding the smallest key.
+**    See P. S. Efraimidis and P. G. Spirakis, "Weighted
+**    random sampling with a reservoir",
+**    Inf. Process. Lett. 97(5), 2006.
+*/
+typedef struct
+{
+    const lua_pcg_source_t *source;
+    void *wrapper;
+    lua_pcg_reservoir_node_t *heap;
+    lua_Integer k;
+    lua_Integer size;
+    lua_Integer count;
+    double w;
+    double skip;
+    int weighted;
+} lua_pcg_reservoir_t;
+
+static lua_pcg_reservoir_t *lua_pcg_reservoir_check(lua_State *L, int index)
+{
+    void *ud = luaL_checkudata(L, index, LUA_PCG_RESERVOIR_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "reservoir expected");
+    return (lua_pcg_reservoir_t *)ud;
+}
+
+/*
+** checks whether the value at stack position 'index'
+** is a reservoir against the metatable cached as upvalue
+** (see lua_pcg_pcg32_check_open_upvalue)
+*/
+static lua_pcg_reservoir_t *lua_pcg_reservoir_check_upvalue(lua_State *L, int index)
+{
+    lua_pcg_reservoir_t *reservoir = (lua_pcg_reservoir_t *)lua_touserdata(L, index);
+
+    if (reservoir == NULL || !lua_getmetatable(L, index) || !lua_rawequal(L, -1, lua_upvalueindex(1)))
+    {
+        /* raises the usual error */
+        return lua_pcg_reservoir_check(L, index);
+    }
+    lua_pop(L, 1);
+    return reservoir;
+}
+
+/* moves the node i of the heap up while its key is smaller than the key of its parent */
+static void lua_pcg_reservoir_siftup(lua_pcg_reservoir_node_t *heap, lua_Integer i)
+{
+    lua_Integer parent;
+    lua_pcg_reservoir_node_t node = heap[i];
+
+    for (; i > 0; i = parent)
+    {
+        parent = (i - 1) / 2;
+        if (heap[parent].key <= node.key)
+        {
             break;
         }
-        default:
+        heap[i] = heap[parent];
+    }
+    heap[i] = node;
+}
+
+/* moves the root of the heap of n nodes down while its key is larger than the key of a child */
+static void lua_pcg_reservoir_siftdown(lua_pcg_reservoir_node_t *heap, lua_Integer n)
+{
+    lua_Integer child;
+    lua_Integer i = 0;
+    lua_pcg_reservoir_node_t node = heap[0];
+
+    for (; (child = 2 * i + 1) < n; i = child)
+    {
+        if (child + 1 < n && heap[child + 1].key < heap[child].key)
         {
-            return luaL_error(L, "Unknown number of arguments to create a pcg32 instance");
+            child++;
+        }
+        if (node.key <= heap[child].key)
+        {
+            break;
         }
+        heap[i] = heap[child];
     }
+    heap[i] = node;
+}
 
-    lua_pcg32_srandom_r(rng, initstate, initseq);
-    return 1;
+/*
+** draws the number of items to be skipped by an
+** unweighted reservoir after w was updated
+*/
+static double lua_pcg_reservoir_skip(lua_pcg_reservoir_t *reservoir, void *rng)
+{
+    return floor(log(reservoir->source->uniform(rng)) / log(1.0 - reservoir->w));
 }
 
-/* advances a lua_pcg32_random_t (rng) by delta */
-static int lua_pcg_pcg32_advance(lua_State *L)
+/*
+** draws the sum of weights to be skipped by a weighted
+** reservoir after the smallest key of the heap was updated
+*/
+static double lua_pcg_reservoir_skip_weighted(lua_pcg_reservoir_t *reservoir, void *rng)
 {
-    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
-    lua_pcg_u64 delta = lua_pcg_parse_u64_arg(L, 2);
-    lua_pcg32_advance_r(rng, delta);
-    return 0;
+    double key = reservoir->heap[0].key;
+    double u = reservoir->source->uniform(rng);
+    return key < 0.0 ? log(u) / key : HUGE_VAL;
 }
 
-/* seed the pcg32 rng */
-static int lua_pcg_pcg32_seed(lua_State *L)
+/*
+** creates a reservoir that keeps k items pushed on it,
+** drawing from the rng instance of pcg32 or pcg64
+*/
+static int lua_pcg_reservoir_new(lua_State *L)
 {
-    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
-    lua_pcg_u64 initstate = lua_pcg_parse_u64_arg(L, 2);
-    lua_pcg_u64 initseq = lua_pcg_parse_u64_arg(L, 3);
-    lua_pcg32_srandom_r(rng, initstate, initseq);
-    return 0;
+    void *block;
+    void *wrapper;
+    lua_pcg_reservoir_t *reservoir;
+    const lua_pcg_source_t *source = lua_pcg_check_source(L, 1, &wrapper);
+    lua_Integer k = luaL_checkinteger(L, 2);
+    int weighted = lua_toboolean(L, 3);
+
+    luaL_argcheck(L, 1 <= k && k <= LUA_PCG_TABLE_INDEX_MAX && k <= 0xFFFFFFFF, 2, "k is out of [1, 4294967295] range");
+    luaL_argcheck(L, !weighted || ((size_t)k) <= (((size_t)(~(size_t)0)) / (2U * sizeof(lua_pcg_reservoir_node_t))), 2, "k is out of range");
+
+    lua_settop(L, 2);
+    reservoir = (lua_pcg_reservoir_t *)lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg_reservoir_t), weighted ? ((size_t)k) * sizeof(lua_pcg_reservoir_node_t) : 0U, &block);
+    if (reservoir == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for reservoir");
+    }
+    reservoir->source = source;
+    reservoir->wrapper = wrapper;
+    reservoir->heap = weighted ? (lua_pcg_reservoir_node_t *)block : NULL;
+    reservoir->k = k;
+    reservoir->size = 0;
+    reservoir->count = 0;
+    reservoir->w = 0.0;
+    reservoir->skip = 0.0;
+    reservoir->weighted = weighted;
+    luaL_getmetatable(L, LUA_PCG_RESERVOIR_METATABLE);
+    lua_setmetatable(L, -2);
+
+    lua_createtable(L, k <= INT_MAX ? (int)k : 0, 1);
+    lua_pushstring(L, "rng");
+    lua_pushvalue(L, 1);
+    lua_rawset(L, -3);
+    lua_pcg_setuservalue(L, -2);
+    return 1;
 }
 
-/* gets the next lua_pcg_u32 value from the pcg32 rng */
-static int lua_pcg_pcg32_next(lua_State *L)
+/*
+** pushes an item on the reservoir, which is stored
+** when it is selected, replacing a previous one.
+** 
+** Note: this function is registered as a C closure
+** holding the metatable of reservoir as upvalue.
+*/
+static int lua_pcg_reservoir_push(lua_State *L)
 {
-    lua_pcg_u32 n;
-    lua_pcg_u32 bound;
-    lua_Integer a, b, c;
-    int nargs = lua_gettop(L);
-    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
+    double weight = 1.0;
+    double u, t;
+    lua_pcg_table_index slot;
+    lua_pcg_reservoir_t *reservoir = lua_pcg_reservoir_check_upvalue(L, 1);
+    void *rng = reservoir->source->rng(reservoir->wrapper);
+
+    luaL_argcheck(L, !lua_isnoneornil(L, 2), 2, "item expected");
+    if (reservoir->weighted)
+    {
+        weight = luaL_optnumber(L, 3, 1.0);
+        luaL_argcheck(L, weight >= 0.0 && weight - weight == 0.0, 3, "weight must be a finite non-negative number");
+    }
+    else
+    {
+        luaL_argcheck(L, lua_isnoneornil(L, 3), 3, "weight is only accepted by weighted reservoirs");
+    }
 
-    nargs--;
+    if (rng == NULL)
+    {
+        return luaL_error(L, "%s random was closed previously", reservoir->source->name);
+    }
 
-    switch (nargs)
+    reservoir->count++;
+
+    if (reservoir->weighted)
     {
-        case 0: /* no args? */
+        /* items holding zero weight are never selected */
+        if (weight == 0.0)
         {
-            n = lua_pcg32_random_r(rng);
-            lua_pushinteger(L, (lua_Integer)n);
-            break;
+            return 0;
         }
-        case 1: /* bound is given */
-        {
-            a = luaL_checkinteger(L, 2);
-            luaL_argcheck(L, 0 < a && a <= 0xFFFFFFFF, 2, "bound is out of [1, 4294967295] range");
-            bound = lua_pcg_u32_cast(a);
 
-            n = lua_pcg32_boundedrand_r(rng, bound);
-            lua_pushinteger(L, (lua_Integer)n);
-            break;
+        if (reservoir->size < reservoir->k)
+        {
+            slot = (lua_pcg_table_index)(++(reservoir->size));
+            reservoir->heap[slot - 1].key = log(reservoir->source->uniform(rng)) / weight;
+            reservoir->heap[slot - 1].slot = slot;
+            lua_pcg_reservoir_siftup(reservoir->heap, reservoir->size - 1);
+            if (reservoir->size == reservoir->k)
+            {
+                reservoir->skip = lua_pcg_reservoir_skip_weighted(reservoir, rng);
+            }
         }
-        case 2: /* a, b were provided */
+        else
         {
-            a = luaL_checkinteger(L, 2);
-            b = luaL_checkinteger(L, 3);
-            luaL_argcheck(L, a < b, 2, "a cannot be greater than or equal to b");
-
-            c = b - a;
-            luaL_argcheck(L, c <= 0xFFFFFFFF, 2, "the integer (b - a) is out of [1, 4294967295] range");
-            bound = lua_pcg_u32_cast(c);
+            reservoir->skip -= weight;
+            if (reservoir->skip > 0.0)
+            {
+                return 0;
+            }
 
-            n = lua_pcg32_boundedrand_r(rng, bound);
-            lua_pushinteger(L, a + ((lua_Integer)n));
-            break;
+            /* the key of the new item is larger than the smallest key */
+            t = exp(weight * reservoir->heap[0].key);
+            u = t + (1.0 - t) * reservoir->source->uniform(rng);
+            slot = reservoir->heap[0].slot;
+            reservoir->heap[0].key = log(u) / weight;
+            lua_pcg_reservoir_siftdown(reservoir->heap, reservoir->size);
+            reservoir->skip = lua_pcg_reservoir_skip_weighted(reservoir, rng);
         }
-        default:
+    }
+    else
+    {
+        if (reservoir->size < reservoir->k)
         {
-            return luaL_error(L, "Unknown number of arguments to generate a next number from pcg32");
+            slot = (lua_pcg_table_index)(++(reservoir->size));
+            if (reservoir->size == reservoir->k)
+            {
+                reservoir->w = exp(log(reservoir->source->uniform(rng)) / ((double)reservoir->k));
+                reservoir->skip = lua_pcg_reservoir_skip(reservoir, rng);
+            }
+        }
+        else
+        {
+            if (reservoir->skip >= 1.0)
+            {
+                reservoir->skip -= 1.0;
+                return 0;
+            }
+
+            slot = 1 + (lua_pcg_table_index)reservoir->source->index(rng, reservoir->k);
+            reservoir->w *= exp(log(reservoir->source->uniform(rng)) / ((double)reservoir->k));
+            reservoir->skip = lua_pcg_reservoir_skip(reservoir, rng);
         }
     }
-    return 1;
+
+    lua_pcg_getuservalue(L, 1);
+    lua_pushvalue(L, 2);
+    lua_rawseti(L, -2, slot);
+    return 0;
 }
 
-/* gets the bytes from the next lua_pcg_u32 value provided by the pcg32 rng */
-static int lua_pcg_pcg32_nextbytes(lua_State *L)
+/* creates a table holding the items stored on the reservoir */
+static int lua_pcg_reservoir_result(lua_State *L)
 {
-    int i;
-    lua_pcg32_random_t *rng = lua_pcg_pcg32_check_rng(L, 1);
-    lua_pcg_u32 n = lua_pcg32_random_r(rng);
+    lua_pcg_table_index slot;
+    lua_pcg_reservoir_t *reservoir = lua_pcg_reservoir_check(L, 1);
 
-    lua_createtable(L, 0, 0);
-
-    for (i = 0; i < 4; i++, n >>= 8U)
+    lua_settop(L, 1);
+    lua_pcg_getuservalue(L, 1);
+    lua_createtable(L, reservoir->size <= INT_MAX ? (int)reservoir->size : 0, 0);
+    for (slot = 0; slot < (lua_pcg_table_index)reservoir->size;)
     {
-        lua_pushinteger(L, i + 1);
-        lua_pushinteger(L, lua_pcg_u8_cast(n));
-        lua_settable(L, -3);
+        slot++;
+        lua_rawgeti(L, 2, slot);
+        lua_rawseti(L, 3, slot);
     }
-
     return 1;
 }
 
-/* sets the pcg32 object instance as read-only */
-static int lua_pcg_pcg32_newindex(lua_State *L)
+/* gets the number of items pushed on the reservoir */
+static int lua_pcg_reservoir_count(lua_State *L)
 {
-    return luaL_error(L, "Read-only object");
+    lua_pcg_reservoir_t *reservoir = lua_pcg_reservoir_check(L, 1);
+    lua_pushinteger(L, reservoir->count);
+    return 1;
 }
 
-/* frees memory used by each pcg32 random instance */
-static int lua_pcg_pcg32_close(lua_State *L)
+/* sets the reservoir object instance as read-only */
+static int lua_pcg_reservoir_newindex(lua_State *L)
 {
-    lua_pcg32_random_t_wrapper *wrapper = lua_pcg_pcg32_check(L, 1);
-    if (wrapper->rng != NULL)
-    {
-        lua_pcg_free(L, wrapper->rng, sizeof(lua_pcg32_random_t));
-        wrapper->rng = NULL;
-    }
-    return 0;
+    return luaL_error(L, "Read-only object");
 }
 
-static const luaL_Reg lua_pcg_pcg32_funcs[] = {
-    {"__gc", lua_pcg_pcg32_close},
-    {"advance", lua_pcg_pcg32_advance},
-    {"close", lua_pcg_pcg32_close},
-    {"new", lua_pcg_pcg32_new},
-    {"next", lua_pcg_pcg32_next},
-    {"nextbytes", lua_pcg_pcg32_nextbytes},
-    {"seed", lua_pcg_pcg32_seed},
+static const luaL_Reg lua_pcg_reservoir_funcs[] = {
+    {"count", lua_pcg_reservoir_count},
+    {"new", lua_pcg_reservoir_new},
+    {"result", lua_pcg_reservoir_result},
     {NULL, NULL}
 };
-/* end of pcg32 implementation */
 
-/* 
-** *********************************************
-** *********************************************
-** 
-** Now that pcg64 methods were implemented,
-** we are going to bridge it to Lua.
-** 
-** *********************************************
-** *********************************************
-*/
+static const luaL_Reg lua_pcg_reservoir_upvalue_funcs[] = {
+    {"push", lua_pcg_reservoir_push},
+    {NULL, NULL}
+};
+/* end of reservoir implementation */
+
+/* start of alias implementation */
 
 /*
-** Structure to wrap a lua_pcg64_random_t
-** 
-** Note: it might be thought unnecessary
-**       to wrap the type 'lua_pcg64_random_t'
-**       in order to expose methods to Lua.
-**       However, 'lua_newuserdata' has
-**       some hard to spot alignment problems
-**       (see https://github.com/LuaJIT/LuaJIT/issues/1161 ).
+** Alias table of Walker built through Vose's method,
+** which draws an integer from 1 to n with probability
+** proportional to the weight of the position i in O(1):
+** a column i is drawn uniformly from [0, n), then i + 1
+** is taken when a uniform u <= prob[i], or alias[i] + 1
+** otherwise. Columns holding prob[i] = 1 skip the uniform.
 ** 
-**       Even with PUC-Lua interpreter, on Linux with GCC, I've ran
-**       into such alignment issues, especially
-**       in the 'advance' function on lua_pcg64_random_t
-**       below for the (native system's provided) __int128.
+** See M. D. Vose, "A linear algorithm for generating random
+** numbers with a given distribution", IEEE Trans. Softw. Eng.
+** 17(9), 1991.
 ** 
-**       Thus, to avoid any possibility to run into
-**       such alignment issues, we wrap the
-**       'lua_pcg64_random_t' and allocate it
-**       using 'malloc' which works well in all cases.
+** 'prob' and 'alias' are stored inline, on the same userdata
+** right after this structure (see lua_pcg_newuserdata_aligned).
 */
 typedef struct
 {
-    lua_pcg64_random_t *rng;
-} lua_pcg64_random_t_wrapper;
+    double *prob;
+    lua_pcg_u32 *alias;
+    lua_Integer n;
+} lua_pcg_alias_t;
 
-static lua_pcg64_random_t_wrapper *lua_pcg_pcg64_check(lua_State *L, int index)
+static lua_pcg_alias_t *lua_pcg_alias_check(lua_State *L, int index)
 {
-    void *ud = luaL_checkudata(L, index, LUA_PCG_PCG64_METATABLE);
-    luaL_argcheck(L, ud != NULL, index, "pcg64 random expected");
-    return (lua_pcg64_random_t_wrapper *)ud;
+    void *ud = luaL_checkudata(L, index, LUA_PCG_ALIAS_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "alias expected");
+    return (lua_pcg_alias_t *)ud;
 }
 
-static lua_pcg64_random_t *lua_pcg_pcg64_check_rng(lua_State *L, int index)
+/*
+** checks whether the value at stack position 'index'
+** is an alias against the metatable cached as upvalue
+** (see lua_pcg_pcg32_check_open_upvalue)
+*/
+static lua_pcg_alias_t *lua_pcg_alias_check_upvalue(lua_State *L, int index)
 {
-    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check(L, index);
-    luaL_argcheck(L, wrapper->rng != NULL, index, "pcg64 random was closed previously");
-    return wrapper->rng;
+    lua_pcg_alias_t *alias = (lua_pcg_alias_t *)lua_touserdata(L, index);
+
+    if (alias == NULL || !lua_getmetatable(L, index) || !lua_rawequal(L, -1, lua_upvalueindex(1)))
+    {
+        /* raises the usual error */
+        return lua_pcg_alias_check(L, index);
+    }
+    lua_pop(L, 1);
+    return alias;
 }
 
-/* creates a lua_pcg64_random_t (rng) */
-static int lua_pcg_pcg64_new(lua_State *L)
+/* draws an integer from 1 to n on the alias table */
+static lua_Integer lua_pcg_alias_draw(const lua_pcg_alias_t *alias, const lua_pcg_source_t *source, void *rng)
 {
-    lua_pcg_u128 initstate;
-    lua_pcg_u128 initseq;
-    lua_pcg64_random_t_wrapper *wrapper;
-    lua_pcg64_random_t *rng;
-    void *ud;
-    int nargs;
+    lua_Integer i = source->index(rng, alias->n);
+    double prob = alias->prob[i];
+    return 1 + ((prob >= 1.0 || source->uniform(rng) <= prob) ? i : ((lua_Integer)alias->alias[i]));
+}
 
-    nargs = lua_gettop(L);
-    ud = lua_newuserdata(L, sizeof(lua_pcg64_random_t_wrapper));
-    if (ud == NULL)
+/*
+** creates an alias table from a sequence
+** of non-negative weights on the positions 1 to n
+*/
+static int lua_pcg_alias_new(lua_State *L)
+{
+    void *block;
+    double w;
+    double sum = 0.0;
+    size_t i, s, l, n, nsmall, nlarge;
+    lua_pcg_u32 *worklist;
+    lua_pcg_alias_t *alias;
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+    n = lua_pcg_table_length(L, 1);
+    luaL_argcheck(L, 0U < n && n <= 0xFFFFFFFF, 1, "the number of weights is out of [1, 4294967295] range");
+    luaL_argcheck(L, n <= (((size_t)(~(size_t)0)) / (2U * (sizeof(double) + sizeof(lua_pcg_u32)))), 1, "the number of weights is out of range");
+
+    lua_settop(L, 1);
+    alias = (lua_pcg_alias_t *)lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg_alias_t), n * (sizeof(double) + sizeof(lua_pcg_u32)), &block);
+    if (alias == NULL)
     {
-        return luaL_error(L, "Memory allocation on Lua failed to create user data for pcg64 random");
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for alias");
     }
-    luaL_getmetatable(L, LUA_PCG_PCG64_METATABLE);
+    alias->prob = (double *)block;
+    alias->alias = (lua_pcg_u32 *)(alias->prob + n);
+    alias->n = (lua_Integer)n;
+    luaL_getmetatable(L, LUA_PCG_ALIAS_METATABLE);
     lua_setmetatable(L, -2);
 
-    wrapper = (lua_pcg64_random_t_wrapper *)ud;
-    wrapper->rng = (lua_pcg64_random_t *)(lua_pcg_alloc(L, sizeof(lua_pcg64_random_t)));
-    if (wrapper->rng == NULL)
+    for (i = 0U; i < n; i++)
     {
-        return luaL_error(L, "Memory allocation failed to initialize lua_pcg64_random_t");
+        lua_rawgeti(L, 1, (lua_pcg_table_index)(i + 1U));
+        w = lua_tonumber(L, -1);
+        if (lua_type(L, -1) != LUA_TNUMBER || !(w >= 0.0 && w - w == 0.0))
+        {
+            return luaL_error(L, "weight at table position [%d] must be a finite non-negative number", (int)(i + 1U));
+        }
+        lua_pop(L, 1);
+        alias->prob[i] = w;
+        alias->alias[i] = (lua_pcg_u32)i;
+        sum += w;
     }
-    rng = wrapper->rng;
+    luaL_argcheck(L, sum > 0.0 && sum - sum == 0.0, 1, "the sum of weights must be a finite positive number");
 
-    switch (nargs)
+    worklist = (lua_pcg_u32 *)lua_newuserdata(L, n * sizeof(lua_pcg_u32));
+    if (worklist == NULL)
     {
-        case 0: /* no args? generate both initstate and initseq */
-        {
-            lua_pcg_fill_with_random_bytes(ud, &initstate, &initseq);
-            break;
-        }
-        case 1: /* only initstate was provided? then generate initseq */
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for alias");
+    }
+
+    /*
+    ** the columns holding scaled weights smaller than 1
+    ** are stacked from the start of the worklist,
+    ** and the remaining ones from the end
+    */
+    for (i = 0U, nsmall = 0U, nlarge = 0U; i < n; i++)
+    {
+        alias->prob[i] = (alias->prob[i] / sum) * ((double)n);
+        if (alias->prob[i] < 1.0)
         {
-            initstate = lua_pcg_parse_u128_arg(L, 1);
-            lua_pcg_fill_with_random_bytes(ud, NULL, &initseq);
-            break;
+            worklist[nsmall++] = (lua_pcg_u32)i;
         }
-        case 2: /* both initstate and initseq were provided */
+        else
         {
-            initstate = lua_pcg_parse_u128_arg(L, 1);
-            initseq = lua_pcg_parse_u128_arg(L, 2);
-            break;
+            worklist[n - (++nlarge)] = (lua_pcg_u32)i;
         }
-        default:
+    }
+
+    /* each small column is filled up by a large one */
+    while (nsmall > 0U && nlarge > 0U)
+    {
+        s = (size_t)worklist[--nsmall];
+        l = (size_t)worklist[n - nlarge];
+        alias->alias[s] = (lua_pcg_u32)l;
+        alias->prob[l] = (alias->prob[l] + alias->prob[s]) - 1.0;
+        if (alias->prob[l] < 1.0)
         {
-            return luaL_error(L, "Unknown number of arguments to create a pcg64 instance.");
+            nlarge--;
+            worklist[nsmall++] = (lua_pcg_u32)l;
         }
     }
 
-    lua_pcg64_srandom_r(rng, initstate, initseq);
+    /* the columns left are full up to rounding errors */
+    while (nsmall > 0U)
+    {
+        alias->prob[worklist[--nsmall]] = 1.0;
+    }
+    while (nlarge > 0U)
+    {
+        alias->prob[worklist[n - (nlarge--)]] = 1.0;
+    }
+
+    lua_pop(L, 1);
+    return 1;
+}
+
+/*
+** draws an integer from 1 to n with probability proportional
+** to its weight through the rng instance of pcg32 or pcg64,
+** or creates a table holding count of such integers.
+** 
+** Note: this function is registered as a C closure
+** holding the metatable of alias, the metatable of pcg32
+** and the metatable of pcg64 as upvalues.
+*/
+static int lua_pcg_alias_sample(lua_State *L)
+{
+    void *wrapper;
+    void *rng;
+    lua_pcg_table_index key;
+    lua_Integer count;
+    lua_pcg_alias_t *alias = lua_pcg_alias_check_upvalue(L, 1);
+    const lua_pcg_source_t *source = lua_pcg_check_source_upvalue(L, 2, &wrapper);
 
+    rng = source->rng(wrapper);
+
+    if (lua_isnoneornil(L, 3))
+    {
+        lua_pushinteger(L, lua_pcg_alias_draw(alias, source, rng));
+        return 1;
+    }
+
+    count = luaL_checkinteger(L, 3);
+    luaL_argcheck(L, 0 <= count && count <= LUA_PCG_TABLE_INDEX_MAX, 3, "count is out of range");
+
+    lua_createtable(L, count <= INT_MAX ? (int)count : 0, 0);
+    for (key = 0; key < (lua_pcg_table_index)count;)
+    {
+        key++;
+        lua_pushinteger(L, lua_pcg_alias_draw(alias, source, rng));
+        lua_rawseti(L, -2, key);
+    }
+    return 1;
+}
+
+/* gets the number of weights of the alias table */
+static int lua_pcg_alias_size(lua_State *L)
+{
+    lua_pcg_alias_t *alias = lua_pcg_alias_check(L, 1);
+    lua_pushinteger(L, alias->n);
     return 1;
 }
 
-/* advances a lua_pcg64_random_t (rng) by delta */
-static int lua_pcg_pcg64_advance(lua_State *L)
+/* sets the alias object instance as read-only */
+static int lua_pcg_alias_newindex(lua_State *L)
+{
+    return luaL_error(L, "Read-only object");
+}
+
+static const luaL_Reg lua_pcg_alias_funcs[] = {
+    {"new", lua_pcg_alias_new},
+    {"size", lua_pcg_alias_size},
+    {NULL, NULL}
+};
+
+static const luaL_Reg lua_pcg_alias_source_upvalues_funcs[] = {
+    {"sample", lua_pcg_alias_sample},
+    {NULL, NULL}
+};
+/* end of alias implementation */
+
+/* start of weighted implementation */
+
+/*
+** Dynamic weighted sampler over the integers 1 to n,
+** backed by a sum tree: a complete binary tree stored
+** as an array (the root at 1, the children of j at 2j
+** and 2j + 1) whose leaves capacity to 2 * capacity - 1
+** hold the weights, and each inner node holds the sum
+** of its children. Thus, updating a weight and drawing
+** an integer with probability proportional to its weight
+** both take O(log n).
+** 
+** Inner nodes are recomputed from their children on
+** every update, such that no rounding error accumulates
+** over time (e.g.: the total returns to 0 exactly
+** after every weight is set back to 0).
+** 
+** 'tree' is stored inline, on the same userdata
+** right after this structure (see lua_pcg_newuserdata_aligned).
+*/
+typedef struct
+{
+    double *tree;
+    lua_Integer n;
+    size_t capacity;
+} lua_pcg_weighted_t;
+
+static lua_pcg_weighted_t *lua_pcg_weighted_check(lua_State *L, int index)
+{
+    void *ud = luaL_checkudata(L, index, LUA_PCG_WEIGHTED_METATABLE);
+    luaL_argcheck(L, ud != NULL, index, "weighted expected");
+    return (lua_pcg_weighted_t *)ud;
+}
+
+/*
+** checks whether the value at stack position 'index'
+** is a weighted against the metatable cached as upvalue
+** (see lua_pcg_pcg32_check_open_upvalue)
+*/
+static lua_pcg_weighted_t *lua_pcg_weighted_check_upvalue(lua_State *L, int index)
 {
-    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
-    lua_pcg_u128 delta = lua_pcg_parse_u128_arg(L, 2);
-    lua_pcg64_advance_r(rng, delta);
-    return 0;
+    lua_pcg_weighted_t *weighted = (lua_pcg_weighted_t *)lua_touserdata(L, index);
+
+    if (weighted == NULL || !lua_getmetatable(L, index) || !lua_rawequal(L, -1, lua_upvalueindex(1)))
+    {
+        /* raises the usual error */
+        return lua_pcg_weighted_check(L, index);
+    }
+    lua_pop(L, 1);
+    return weighted;
 }
 
-/* seed the pcg64 rng */
-static int lua_pcg_pcg64_seed(lua_State *L)
+/* checks the position i (1 to n) of a weight */
+static size_t lua_pcg_weighted_check_position(lua_State *L, lua_pcg_weighted_t *weighted, int index)
 {
-    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
-    lua_pcg_u128 initstate = lua_pcg_parse_u128_arg(L, 2);
-    lua_pcg_u128 initseq = lua_pcg_parse_u128_arg(L, 3);
-    lua_pcg64_srandom_r(rng, initstate, initseq);
-    return 0;
+    lua_Integer i = luaL_checkinteger(L, index);
+    luaL_argcheck(L, 1 <= i && i <= weighted->n, index, "i is out of [1, n] range");
+    return (size_t)(i - 1);
 }
 
-/* gets the next lua_pcg_u64 value from the pcg64 rng */
-static int lua_pcg_pcg64_next(lua_State *L)
+/* sets the leaf of the tree to w, recomputing its ancestors */
+static void lua_pcg_weighted_update(lua_pcg_weighted_t *weighted, size_t leaf, double w)
 {
-    lua_pcg_u64 n;
-    lua_pcg_u64 bound;
-    lua_Integer a, b, c;
-    int nargs = lua_gettop(L);
-    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
+    double *tree = weighted->tree;
 
-#ifdef LUA_PCG_U64_EMULATED
-    int lua_Integer_has_64bit = lua_pcg_lua_Integer_has_64bit();
-#endif
+    tree[leaf] = w;
+    for (leaf /= 2U; leaf > 0U; leaf /= 2U)
+    {
+        tree[leaf] = tree[2U * leaf] + tree[2U * leaf + 1U];
+    }
+}
 
-    nargs--;
+/*
+** draws an integer from 1 to n walking down the tree
+** from the root to a leaf, taking the left child when
+** u falls on its sum. The right child is only taken when
+** it holds a positive sum, such that rounding errors
+** never lead to a leaf holding zero weight.
+*/
+static lua_Integer lua_pcg_weighted_draw(const lua_pcg_weighted_t *weighted, const lua_pcg_source_t *source, void *rng)
+{
+    size_t j = 1U;
+    const double *tree = weighted->tree;
+    double u = (1.0 - source->uniform(rng)) * tree[1];
 
-    switch (nargs)
+    while (j < weighted->capacity)
     {
-        case 0: /* no args? */
+        j *= 2U;
+        if (u < tree[j] || tree[j + 1U] <= 0.0)
         {
-            n = lua_pcg64_random_r(rng);
-#ifdef LUA_PCG_U64_EMULATED
-            if (lua_Integer_has_64bit) /* assume lua_Integer can hold 64-bit values */
-            {
-                lua_pushinteger(L, (((lua_Integer)n.low) | (((((lua_Integer)n.high) << 15) << 15) << 2)));
-            }
-            else
-            {
-                lua_pushinteger(L, (lua_Integer)(lua_pcg_u64_cast_to_u32(n)));
-            }
-#else
-            lua_pushinteger(L, (lua_Integer)n);
-#endif
-            break;
+            continue;
         }
-        case 1: /* bound is given */
-        {
-            a = luaL_checkinteger(L, 2);
-            luaL_argcheck(L, 0 < a, 2, "bound must be a positive integer");
+        u -= tree[j];
+        j++;
+    }
+    return (lua_Integer)(j - weighted->capacity) + 1;
+}
 
-            if (a <= 0xFFFFFFFF)
-            {
-                bound = lua_pcg_u64_lh(a, 0);
-            }
-            else
-            {
-                bound = lua_pcg_u64_lh(lua_pcg_u32_cast(a), lua_pcg_u32_cast((((a >> 15) >> 15) >> 2)));
-            }
+/* creates a weighted sampler over n weights, initially 0 */
+static int lua_pcg_weighted_new(lua_State *L)
+{
+    void *block;
+    size_t i, capacity;
+    lua_pcg_weighted_t *weighted;
+    lua_Integer n = luaL_checkinteger(L, 1);
 
-            n = lua_pcg64_boundedrand_r(rng, bound);
-#ifdef LUA_PCG_U64_EMULATED
-            if (lua_Integer_has_64bit)
-            {
-                lua_pushinteger(L, (((lua_Integer)n.low) | (((((lua_Integer)n.high) << 15) << 15) << 2)));
-            }
-            else
-            {
-                lua_pushinteger(L, (lua_Integer)(lua_pcg_u64_cast_to_u32(n)));
-            }
-#else
-            lua_pushinteger(L, (lua_Integer)n);
-#endif
-            break;
-        }
-        case 2: /* a, b were provided */
-        {
-            a = luaL_checkinteger(L, 2);
-            b = luaL_checkinteger(L, 3);
-            luaL_argcheck(L, a < b, 2, "a cannot be greater than or equal to b");
+    luaL_argcheck(L, 1 <= n && n <= LUA_PCG_TABLE_INDEX_MAX && ((size_t)n) <= (((size_t)(~(size_t)0)) / (4U * sizeof(double))), 1, "n is out of range");
 
-            c = b - a;
-            if (c <= 0xFFFFFFFF)
-            {
-                bound = lua_pcg_u64_lh(c, 0);
-            }
-            else
-            {
-                bound = lua_pcg_u64_lh(lua_pcg_u32_cast(c), lua_pcg_u32_cast((((c >> 15) >> 15) >> 2)));
-            }
+    for (capacity = 1U; capacity < (size_t)n; capacity *= 2U)
+    {
+    }
 
-            n = lua_pcg64_boundedrand_r(rng, bound);
-#ifdef LUA_PCG_U64_EMULATED
-            if (lua_Integer_has_64bit)
-            {
-                lua_pushinteger(L, a + (((lua_Integer)n.low) | (((((lua_Integer)n.high) << 15) << 15) << 2)));
-            }
-            else
-            {
-                lua_pushinteger(L, a + (lua_Integer)(lua_pcg_u64_cast_to_u32(n)));
-            }
-#else
-            lua_pushinteger(L, a + ((lua_Integer)n));
-#endif
-            break;
-        }
-        default:
-        {
-            return luaL_error(L, "Unknown number of arguments to generate a next number from pcg64");
-        }
+    weighted = (lua_pcg_weighted_t *)lua_pcg_newuserdata_aligned(L, sizeof(lua_pcg_weighted_t), 2U * capacity * sizeof(double), &block);
+    if (weighted == NULL)
+    {
+        return luaL_error(L, "Memory allocation on Lua failed to create user data for weighted");
     }
+    weighted->tree = (double *)block;
+    weighted->n = n;
+    weighted->capacity = capacity;
+    for (i = 0U; i < 2U * capacity; i++)
+    {
+        weighted->tree[i] = 0.0;
+    }
+    luaL_getmetatable(L, LUA_PCG_WEIGHTED_METATABLE);
+    lua_setmetatable(L, -2);
     return 1;
 }
 
-/* gets the bytes from the next lua_pcg_u64 value provided by the pcg64 rng */
-static int lua_pcg_pcg64_nextbytes(lua_State *L)
+/*
+** sets the weight of the integer i.
+** 
+** Note: this function is registered as a C closure
+** holding the metatable of weighted as upvalue.
+*/
+static int lua_pcg_weighted_set(lua_State *L)
 {
-    lua_Integer i;
-    lua_pcg64_random_t *rng = lua_pcg_pcg64_check_rng(L, 1);
-    lua_pcg_u64 n = lua_pcg64_random_r(rng);
+    double previous;
+    lua_pcg_weighted_t *weighted = lua_pcg_weighted_check_upvalue(L, 1);
+    size_t leaf = weighted->capacity + lua_pcg_weighted_check_position(L, weighted, 2);
+    double w = luaL_checknumber(L, 3);
 
-    lua_createtable(L, 0, 0);
+    luaL_argcheck(L, w >= 0.0 && w - w == 0.0, 3, "weight must be a finite non-negative number");
 
-    for (i = 1; i <= 8; i++, n = lua_pcg_u64_rsh(n, 8U))
+    previous = weighted->tree[leaf];
+    lua_pcg_weighted_update(weighted, leaf, w);
+    if (!(weighted->tree[1] - weighted->tree[1] == 0.0))
     {
-        lua_pushinteger(L, i);
-        lua_pushinteger(L, lua_pcg_u64_cast_to_u8(n));
-        lua_settable(L, -3);
+        lua_pcg_weighted_update(weighted, leaf, previous);
+        return luaL_error(L, "the sum of weights must be finite");
     }
+    return 0;
+}
 
+/* gets the weight of the integer i */
+static int lua_pcg_weighted_get(lua_State *L)
+{
+    lua_pcg_weighted_t *weighted = lua_pcg_weighted_check(L, 1);
+    size_t leaf = weighted->capacity + lua_pcg_weighted_check_position(L, weighted, 2);
+    lua_pushnumber(L, weighted->tree[leaf]);
     return 1;
 }
 
-/* sets the pcg64 object instance as read-only */
-static int lua_pcg_pcg64_newindex(lua_State *L)
+/* gets the sum of the weights */
+static int lua_pcg_weighted_total(lua_State *L)
 {
-    return luaL_error(L, "Read-only object");
+    lua_pcg_weighted_t *weighted = lua_pcg_weighted_check(L, 1);
+    lua_pushnumber(L, weighted->tree[1]);
+    return 1;
 }
 
-/* frees memory used by each pcg64 random instance */
-static int lua_pcg_pcg64_close(lua_State *L)
+/* gets the number of weights */
+static int lua_pcg_weighted_size(lua_State *L)
 {
-    lua_pcg64_random_t_wrapper *wrapper = lua_pcg_pcg64_check(L, 1);
-    if (wrapper->rng != NULL)
+    lua_pcg_weighted_t *weighted = lua_pcg_weighted_check(L, 1);
+    lua_pushinteger(L, weighted->n);
+    return 1;
+}
+
+/*
+** draws an integer from 1 to n with probability proportional
+** to its weight through the rng instance of pcg32 or pcg64,
+** or creates a table holding count of such integers.
+** 
+** Note: this function is registered as a C closure
+** holding the metatable of weighted, the metatable of pcg32
+** and the metatable of pcg64 as upvalues.
+*/
+static int lua_pcg_weighted_sample(lua_State *L)
+{
+    void *wrapper;
+    void *rng;
+    lua_pcg_table_index key;
+    lua_Integer count;
+    lua_pcg_weighted_t *weighted = lua_pcg_weighted_check_upvalue(L, 1);
+    const lua_pcg_source_t *source = lua_pcg_check_source_upvalue(L, 2, &wrapper);
+
+    rng = source->rng(wrapper);
+
+    if (!(weighted->tree[1] > 0.0))
     {
-        lua_pcg_free(L, wrapper->rng, sizeof(lua_pcg64_random_t));
-        wrapper->rng = NULL;
+        return luaL_error(L, "the sum of weights must be positive to sample");
     }
-    return 0;
+
+    if (lua_isnoneornil(L, 3))
+    {
+        lua_pushinteger(L, lua_pcg_weighted_draw(weighted, source, rng));
+        return 1;
+    }
+
+    count = luaL_checkinteger(L, 3);
+    luaL_argcheck(L, 0 <= count && count <= LUA_PCG_TABLE_INDEX_MAX, 3, "count is out of range");
+
+    lua_createtable(L, count <= INT_MAX ? (int)count : 0, 0);
+    for (key = 0; key < (lua_pcg_table_index)count;)
+    {
+        key++;
+        lua_pushinteger(L, lua_pcg_weighted_draw(weighted, source, rng));
+        lua_rawseti(L, -2, key);
+    }
+    return 1;
 }
 
-static const luaL_Reg lua_pcg_pcg64_funcs[] = {
-    {"__gc", lua_pcg_pcg64_close},
-    {"advance", lua_pcg_pcg64_advance},
-    {"close", lua_pcg_pcg64_close},
-    {"new", lua_pcg_pcg64_new},
-    {"next", lua_pcg_pcg64_next},
-    {"nextbytes", lua_pcg_pcg64_nextbytes},
-    {"seed", lua_pcg_pcg64_seed},
+/* sets the weighted object instance as read-only */
+static int lua_pcg_weighted_newindex(lua_State *L)
+{
+    return luaL_error(L, "Read-only object");
+}
+
+static const luaL_Reg lua_pcg_weighted_funcs[] = {
+    {"get", lua_pcg_weighted_get},
+    {"new", lua_pcg_weighted_new},
+    {"size", lua_pcg_weighted_size},
+    {"total", lua_pcg_weighted_total},
     {NULL, NULL}
 };
-/* end of pcg64 implementation */
+
+static const luaL_Reg lua_pcg_weighted_upvalue_funcs[] = {
+    {"set", lua_pcg_weighted_set},
+    {NULL, NULL}
+};
+
+static const luaL_Reg lua_pcg_weighted_source_upvalues_funcs[] = {
+    {"sample", lua_pcg_weighted_sample},
+    {NULL, NULL}
+};
+/* end of weighted implementation */
 
 /* sets the pcg library as read-only */
 static int lua_pcg_newindex(lua_State *L)
@@ -2824,6 +8386,9 @@ LUA_PCG_EXPORT int luaopen_pcg(lua_State *L)
     luaL_setfuncs(L, lua_pcg_pcg32_funcs, 0);
 #endif
 
+    /* these hold the metatable as upvalue (see lua_pcg_pcg32_check_open_upvalue) */
+    lua_pcg_setfuncs_upvalue(L, lua_pcg_pcg32_upvalue_funcs);
+
     lua_pushstring(L, "__index");
     lua_pushvalue(L, -2);
     lua_settable(L, -3);
@@ -2850,6 +8415,9 @@ LUA_PCG_EXPORT int luaopen_pcg(lua_State *L)
     luaL_setfuncs(L, lua_pcg_pcg64_funcs, 0);
 #endif
 
+    /* these hold the metatable as upvalue (see lua_pcg_pcg64_check_open_upvalue) */
+    lua_pcg_setfuncs_upvalue(L, lua_pcg_pcg64_upvalue_funcs);
+
     lua_pushstring(L, "__index");
     lua_pushvalue(L, -2);
     lua_settable(L, -3);
@@ -2866,6 +8434,152 @@ LUA_PCG_EXPORT int luaopen_pcg(lua_State *L)
     lua_settable(L, -3);
     /* end of pcg64 */
 
+    /* start of pcg32x8 */
+    lua_pushstring(L, "pcg32x8");
+    lua_createtable(L, 0, 0);
+    luaL_newmetatable(L, LUA_PCG_PCG32X8_METATABLE);
+#if LUA_VERSION_NUM < 502
+    luaL_register(L, NULL, lua_pcg_pcg32x8_funcs);
+#else
+    luaL_setfuncs(L, lua_pcg_pcg32x8_funcs, 0);
+#endif
+
+    lua_pushstring(L, "__index");
+    lua_pushvalue(L, -2);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__newindex");
+    lua_pushcfunction(L, lua_pcg_pcg32x8_newindex);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__metatable");
+    lua_pushboolean(L, 0);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "kernel");
+    lua_pushstring(L, lua_pcg_pcg32x8_select_kernel() == lua_pcg_pcg32x8_scalar_kernel ? "scalar" : "avx2");
+    lua_settable(L, -3);
+
+    lua_setmetatable(L, -2);
+    lua_settable(L, -3);
+    /* end of pcg32x8 */
+
+    /* start of pcg64x4 */
+    lua_pushstring(L, "pcg64x4");
+    lua_createtable(L, 0, 0);
+    luaL_newmetatable(L, LUA_PCG_PCG64X4_METATABLE);
+#if LUA_VERSION_NUM < 502
+    luaL_register(L, NULL, lua_pcg_pcg64x4_funcs);
+#else
+    luaL_setfuncs(L, lua_pcg_pcg64x4_funcs, 0);
+#endif
+
+    lua_pushstring(L, "__index");
+    lua_pushvalue(L, -2);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__newindex");
+    lua_pushcfunction(L, lua_pcg_pcg64x4_newindex);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__metatable");
+    lua_pushboolean(L, 0);
+    lua_settable(L, -3);
+
+    lua_setmetatable(L, -2);
+    lua_settable(L, -3);
+    /* end of pcg64x4 */
+
+    /* start of reservoir */
+    lua_pushstring(L, "reservoir");
+    lua_createtable(L, 0, 0);
+    luaL_newmetatable(L, LUA_PCG_RESERVOIR_METATABLE);
+#if LUA_VERSION_NUM < 502
+    luaL_register(L, NULL, lua_pcg_reservoir_funcs);
+#else
+    luaL_setfuncs(L, lua_pcg_reservoir_funcs, 0);
+#endif
+
+    /* these hold the metatable as upvalue (see lua_pcg_reservoir_check_upvalue) */
+    lua_pcg_setfuncs_upvalue(L, lua_pcg_reservoir_upvalue_funcs);
+
+    lua_pushstring(L, "__index");
+    lua_pushvalue(L, -2);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__newindex");
+    lua_pushcfunction(L, lua_pcg_reservoir_newindex);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__metatable");
+    lua_pushboolean(L, 0);
+    lua_settable(L, -3);
+
+    lua_setmetatable(L, -2);
+    lua_settable(L, -3);
+    /* end of reservoir */
+
+    /* start of alias */
+    lua_pushstring(L, "alias");
+    lua_createtable(L, 0, 0);
+    luaL_newmetatable(L, LUA_PCG_ALIAS_METATABLE);
+#if LUA_VERSION_NUM < 502
+    luaL_register(L, NULL, lua_pcg_alias_funcs);
+#else
+    luaL_setfuncs(L, lua_pcg_alias_funcs, 0);
+#endif
+
+    /* these hold the metatables as upvalues (see lua_pcg_check_source_upvalue) */
+    lua_pcg_setfuncs_source_upvalues(L, lua_pcg_alias_source_upvalues_funcs);
+
+    lua_pushstring(L, "__index");
+    lua_pushvalue(L, -2);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__newindex");
+    lua_pushcfunction(L, lua_pcg_alias_newindex);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__metatable");
+    lua_pushboolean(L, 0);
+    lua_settable(L, -3);
+
+    lua_setmetatable(L, -2);
+    lua_settable(L, -3);
+    /* end of alias */
+
+    /* start of weighted */
+    lua_pushstring(L, "weighted");
+    lua_createtable(L, 0, 0);
+    luaL_newmetatable(L, LUA_PCG_WEIGHTED_METATABLE);
+#if LUA_VERSION_NUM < 502
+    luaL_register(L, NULL, lua_pcg_weighted_funcs);
+#else
+    luaL_setfuncs(L, lua_pcg_weighted_funcs, 0);
+#endif
+
+    /* these hold the metatable as upvalue (see lua_pcg_weighted_check_upvalue) */
+    lua_pcg_setfuncs_upvalue(L, lua_pcg_weighted_upvalue_funcs);
+
+    /* these hold the metatables as upvalues (see lua_pcg_check_source_upvalue) */
+    lua_pcg_setfuncs_source_upvalues(L, lua_pcg_weighted_source_upvalues_funcs);
+
+    lua_pushstring(L, "__index");
+    lua_pushvalue(L, -2);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__newindex");
+    lua_pushcfunction(L, lua_pcg_weighted_newindex);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__metatable");
+    lua_pushboolean(L, 0);
+    lua_settable(L, -3);
+
+    lua_setmetatable(L, -2);
+    lua_settable(L, -3);
+    /* end of weighted */
+
     lua_pushstring(L, "version");
     lua_pushstring(L, LUA_PCG_VERSION);
     lua_settable(L, -3);
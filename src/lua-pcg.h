@@ -48,21 +48,16 @@
 ** at LuaJIT building phase, even though
 ** there is no certainty.
 ** 
-** So, for these reasons,
-** the ability to use Lua's own
-** allocator was removed
-** as the standard behavior.
-** However, the chance to use
-** Lua's own allocator
-** is given through the
-** following macro:
-** 
-** #define LUA_PCG_USE_LUA_ALLOC
-** 
-** On the other hand,
-** if the library fails
-** randomly by activating this setting,
-** then you are on your own.
+** For these reasons, the state
+** of each random number generator
+** is stored inside its own userdata
+** on an address aligned manually
+** by this library, regardless of
+** the alignment provided by Lua's allocator.
+** Thus, no memory is allocated
+** outside of Lua, and the former
+** macro LUA_PCG_USE_LUA_ALLOC
+** has no effect anymore.
 */
 
 /*
@@ -95,6 +90,16 @@
 ** #define LUA_PCG_FORCE_U128_EMULATED
 */
 
+/*
+** Do you want to disable
+** the SIMD kernel (AVX2)
+** selected at runtime
+** to step the lanes of
+** the pcg32x8 class?
+** 
+** #define LUA_PCG_NO_SIMD
+*/
+
 #ifndef LUA_PCG_EXPORT
 #ifdef LUA_PCG_BUILD_STATIC
 #define LUA_PCG_EXPORT
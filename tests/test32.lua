@@ -268,6 +268,1231 @@ local function pcg32_assert_advance()
     print()
 end
 
+local function pcg32_assert_fill()
+    print()
+    print("[PCG32] assert fill and fillinto")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local values = rng:fill(1000)
+    if (#values ~= 1000) then
+        error("Unexpected number of values provided by pcg32.fill")
+    end
+    for i = 1, #values do
+        if (values[i] ~= twin:next()) then
+            error("Invalid pcg32.fill output at position " .. i)
+        end
+    end
+
+    values = rng:fill(1000, 30)
+    for i = 1, #values do
+        if (values[i] ~= twin:next(30)) then
+            error("Invalid pcg32.fill(n, bound) output at position " .. i)
+        end
+    end
+
+    values = rng:fill(1000, -50, 30)
+    for i = 1, #values do
+        if (values[i] ~= twin:next(-50, 30)) then
+            error("Invalid pcg32.fill(n, a, b) output at position " .. i)
+        end
+    end
+
+    if (#rng:fill(0) ~= 0) then
+        error("pcg32.fill(0) must return an empty table")
+    end
+
+    local t = {"first", "second"}
+    for k = 1, 3 do
+        if (rng:fillinto(t, 3, 502, 15, 40) ~= t) then
+            error("pcg32.fillinto must return the table provided")
+        end
+        if (t[1] ~= "first" or t[2] ~= "second" or #t ~= 502) then
+            error("pcg32.fillinto changed positions out of range")
+        end
+        for i = 3, #t do
+            if (t[i] ~= twin:next(15, 40)) then
+                error("Invalid pcg32.fillinto output at position " .. i)
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_bytes()
+    print()
+    print("[PCG32] assert bytes")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local lines = {}
+    local pcg_file = assert(io.open("tests/next32.txt", "r"), "Unable to open next32.txt file")
+    for line in pcg_file:lines() do
+        table.insert(lines, line)
+    end
+    pcg_file:close()
+
+    local data = rng:bytes(4 * #lines)
+    if (#data ~= 4 * #lines) then
+        error("Unexpected number of bytes provided by pcg32.bytes")
+    end
+
+    for i = 1, #lines do
+        local buffer = {("[%05i] 0x"):format(i)}
+        for j = 4 * i, 4 * (i - 1) + 1, -1 do
+            table.insert(buffer, ("%02X"):format(data:byte(j)))
+        end
+
+        if (lines[i] ~= table.concat(buffer)) then
+            error("Invalid pcg32.bytes output on line " .. i .. " from next32.txt")
+        end
+    end
+
+    rng:close()
+
+    rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    for n = 0, 2 * 4 + 1 do
+        data = rng:bytes(n)
+        if (#data ~= n) then
+            error("Unexpected number of bytes provided by pcg32.bytes(" .. n .. ")")
+        end
+
+        local expected = {}
+        while (#expected < n) do
+            for _, b in ipairs(twin:nextbytes()) do
+                table.insert(expected, b)
+            end
+        end
+
+        for j = 1, n do
+            if (data:byte(j) ~= expected[j]) then
+                error("Invalid pcg32.bytes(" .. n .. ") output at position " .. j)
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_fillbuffer()
+    print()
+    print("[PCG32] assert fillbuffer")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    if (pcall(rng.fillbuffer, rng, {}, 1)) then
+        error("pcg32.fillbuffer must reject arguments other than lightuserdata or cdata")
+    end
+
+    local has_ffi, ffi = pcall(require, "ffi")
+    if (has_ffi) then
+        local lines = {}
+        local pcg_file = assert(io.open("tests/next32.txt", "r"), "Unable to open next32.txt file")
+        for line in pcg_file:lines() do
+            table.insert(lines, line)
+        end
+        pcg_file:close()
+
+        local buf = ffi.new("uint32_t[?]", #lines)
+        rng:fillbuffer(buf, #lines)
+
+        for i = 1, #lines do
+            if (lines[i] ~= ("[%05i] 0x%08X"):format(i, tonumber(buf[i - 1]))) then
+                error("Invalid pcg32.fillbuffer output on line " .. i .. " from next32.txt")
+            end
+        end
+
+        -- 64-bit elements are made of two consecutive 32-bit values (low, high)
+        local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+        twin:fillbuffer(ffi.new("uint32_t[?]", #lines), #lines)
+
+        local buf64 = ffi.new("uint64_t[?]", 100)
+        rng:fillbuffer(buf64, 100, 8)
+        local words = ffi.new("uint32_t[?]", 200)
+        twin:fillbuffer(words, 200)
+        for i = 0, 99 do
+            local expected = ffi.cast("uint64_t", words[2 * i]) + ffi.cast("uint64_t", words[2 * i + 1]) * ffi.cast("uint64_t", 4294967296)
+            if (buf64[i] ~= expected) then
+                error("Invalid pcg32.fillbuffer output with 64-bit elements at position " .. i)
+            end
+        end
+
+        -- pointers are dereferenced rather than overwritten
+        local target = ffi.new("uint32_t[?]", 16)
+        local ptr = ffi.cast("uint32_t *", target)
+        local address = tonumber(ffi.cast("uintptr_t", ptr))
+        rng:fillbuffer(ptr, 16)
+        local expected_words = ffi.new("uint32_t[?]", 16)
+        twin:fillbuffer(expected_words, 16)
+        if (tonumber(ffi.cast("uintptr_t", ptr)) ~= address) then
+            error("pcg32.fillbuffer must not overwrite a pointer cdata")
+        end
+        for i = 0, 15 do
+            if (target[i] ~= expected_words[i]) then
+                error("Invalid pcg32.fillbuffer output through a pointer cdata at position " .. i)
+            end
+        end
+
+        -- integer addresses
+        rng:fillbuffer(ffi.cast("uintptr_t", ptr), 16)
+        twin:fillbuffer(expected_words, 16)
+        for i = 0, 15 do
+            if (target[i] ~= expected_words[i]) then
+                error("Invalid pcg32.fillbuffer output through an integer address at position " .. i)
+            end
+        end
+
+        if (pcall(rng.fillbuffer, rng, ffi.new("double", 1), 1)) then
+            error("pcg32.fillbuffer must reject cdata that cannot be converted to a pointer")
+        end
+
+        twin:close()
+    else
+        print("skipped: FFI is not available")
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_nextdouble_nextfloat()
+    print()
+    print("[PCG32] assert nextdouble and nextfloat")
+
+    local unpack_args = table.unpack or unpack
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local function next_words()
+        local b = twin:nextbytes()
+        return b[1] + 256 * (b[2] + 256 * (b[3] + 256 * b[4]))
+    end
+
+    -- expected values computed from the twin generator
+    local function expected_double()
+        local high = math.floor(next_words() / 32)
+        local low = math.floor(next_words() / 64)
+        return (high * 67108864 + low) / 9007199254740992
+    end
+
+    local function expected_float()
+        return math.floor(next_words() / 256) / 16777216
+    end
+
+    for i = 1, 1000 do
+        local x = rng:nextdouble()
+        if (x ~= expected_double() or x < 0 or x >= 1) then
+            error("Invalid pcg32.nextdouble output on iteration " .. i)
+        end
+
+        x = rng:nextfloat()
+        if (x ~= expected_float() or x < 0 or x >= 1) then
+            error("Invalid pcg32.nextfloat output on iteration " .. i)
+        end
+
+        x = rng:nextdouble(-2.5, 7.5)
+        if (x ~= -2.5 + 10 * expected_double() or x < -2.5 or x > 7.5) then
+            error("Invalid pcg32.nextdouble(a, b) output on iteration " .. i)
+        end
+
+        x = rng:nextfloat(3)
+        if (x ~= 3 * expected_float() or x < 0 or x > 3) then
+            error("Invalid pcg32.nextfloat(b) output on iteration " .. i)
+        end
+    end
+
+    local t = rng:filldouble(100, 10, 20)
+    if (#t ~= 100) then
+        error("Unexpected number of values provided by pcg32.filldouble")
+    end
+
+    for i = 1, #t do
+        if (t[i] ~= 10 + 10 * expected_double()) then
+            error("Invalid pcg32.filldouble output at position " .. i)
+        end
+    end
+
+    t = rng:fillfloat(100)
+    if (#t ~= 100) then
+        error("Unexpected number of values provided by pcg32.fillfloat")
+    end
+
+    for i = 1, #t do
+        if (t[i] ~= expected_float()) then
+            error("Invalid pcg32.fillfloat output at position " .. i)
+        end
+    end
+
+    if (#(rng:filldouble(0)) ~= 0 or #(rng:fillfloat(0, 1, 2)) ~= 0) then
+        error("pcg32.filldouble and pcg32.fillfloat must provide empty tables for n = 0")
+    end
+
+    local invalid_args = {
+        {0},
+        {-1},
+        {1, 1},
+        {2, 1},
+        {0, 1 / 0},
+        {1, 2, 3}
+    }
+
+    for _, args in ipairs(invalid_args) do
+        if (pcall(rng.nextdouble, rng, unpack_args(args)) or pcall(rng.nextfloat, rng, unpack_args(args))) then
+            error("pcg32.nextdouble and pcg32.nextfloat must reject invalid arguments")
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_bounded_next()
+    print()
+    print("[PCG32] assert bounded next")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    -- bounds below 2^21 keep every product exact on Lua 5.1 numbers
+    local bounds = {1, 2, 3, 5, 6, 7, 64, 100, 1000, 1024, 12345, 65536, 1048573}
+
+    local function next_word()
+        local b = twin:nextbytes()
+        return b[1] + 256 * (b[2] + 256 * (b[3] + 256 * b[4]))
+    end
+
+    -- reference implementation of Lemire's method with a power-of-two fast path
+    local function expected_bounded(bound)
+        if (1048576 % bound == 0) then
+            return next_word() % bound
+        end
+
+        local m = next_word() * bound
+        local low = m % 4294967296
+        if (low < bound) then
+            local threshold = (4294967296 - bound) % bound
+            while (low < threshold) do
+                m = next_word() * bound
+                low = m % 4294967296
+            end
+        end
+
+        return math.floor(m / 4294967296)
+    end
+
+    for _, bound in ipairs(bounds) do
+        for i = 1, 200 do
+            local n = rng:next(bound)
+            if (n ~= expected_bounded(bound)) then
+                error(("Invalid pcg32.next(%i) output on iteration %i"):format(bound, i))
+            end
+
+            n = rng:next(-7, bound - 7)
+            if (n ~= expected_bounded(bound) - 7) then
+                error(("Invalid pcg32.next(-7, %i) output on iteration %i"):format(bound - 7, i))
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_split()
+    print()
+    print("[PCG32] assert split")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local k = 10
+    local delta = 100
+    local values = twin:fill(k * delta + 1)
+
+    local children = rng:split(k, "0x64")
+    if (#children ~= k) then
+        error("Unexpected number of generators provided by pcg32.split(k, delta)")
+    end
+    for i = 1, k do
+        local block = children[i]:fill(delta)
+        for j = 1, delta do
+            if (block[j] ~= values[(i - 1) * delta + j]) then
+                error(("Invalid pcg32.split(k, delta) output on child %i at position %i"):format(i, j))
+            end
+        end
+        children[i]:close()
+    end
+    if (rng:next() ~= values[k * delta + 1]) then
+        error("pcg32.split(k, delta) must move the parent past the blocks of the children")
+    end
+
+    twin:seed(initstate_pcg32, initseq_pcg32)
+    rng:seed(initstate_pcg32, initseq_pcg32)
+    children = rng:split(k)
+    local twins = twin:split(k)
+    if (#children ~= k or #twins ~= k) then
+        error("Unexpected number of generators provided by pcg32.split(k)")
+    end
+    local seen = {}
+    for i = 1, k do
+        local v = children[i]:next()
+        if (v ~= twins[i]:next()) then
+            error("pcg32.split(k) must derive the children from the state of the parent")
+        end
+        if (seen[v]) then
+            error("pcg32.split(k) derived children that output the same value")
+        end
+        seen[v] = true
+        children[i]:close()
+        twins[i]:close()
+    end
+    if (rng:next() ~= twin:next()) then
+        error("pcg32.split(k) must advance the parent deterministically")
+    end
+
+    if (pcall(rng.split, rng, 0)) then
+        error("pcg32.split(0) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_getstate_setstate()
+    print()
+    print("[PCG32] assert getstate, setstate and fromstate")
+
+    local function tohex(s)
+        return (s:gsub(".", function(c) return ("%02x"):format(c:byte()) end))
+    end
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local state = rng:getstate()
+    if (#state ~= 21) then
+        error("Unexpected number of bytes provided by pcg32.getstate")
+    end
+    if (tohex(state) ~= "21ee291032841beab7b7722997737cb40000000000") then
+        error("Invalid pcg32.getstate output")
+    end
+
+    local values = rng:fill(100)
+    local clone = pcg32.fromstate(state)
+    rng:setstate(state)
+    for i = 1, #values do
+        if (rng:next() ~= values[i]) then
+            error("Invalid pcg32.next output after pcg32.setstate at position " .. i)
+        end
+        if (clone:next() ~= values[i]) then
+            error("Invalid pcg32.next output after pcg32.fromstate at position " .. i)
+        end
+    end
+    if (rng:getstate() ~= clone:getstate()) then
+        error("pcg32.getstate must match on generators at the same position")
+    end
+
+    if (pcall(rng.setstate, rng, state:sub(2))) then
+        error("pcg32.setstate must fail on a string with the wrong size")
+    end
+    local even = state:sub(1, 8) .. string.char(state:byte(9) - 1) .. state:sub(10)
+    if (pcall(pcg32.fromstate, even)) then
+        error("pcg32.fromstate must fail on an even increment")
+    end
+
+    -- the bit cache is part of the state, such that bits and bool are replayed
+    rng:bits(5)
+    local checkpoint = rng:getstate()
+    local bits = {}
+    for i = 1, 20 do
+        bits[i] = rng:bits(7)
+    end
+    local restored = pcg32.fromstate(checkpoint)
+    rng:setstate(checkpoint)
+    for i = 1, #bits do
+        if (rng:bits(7) ~= bits[i]) then
+            error("pcg32.setstate must restore the cached bits at position " .. i)
+        end
+        if (restored:bits(7) ~= bits[i]) then
+            error("pcg32.fromstate must restore the cached bits at position " .. i)
+        end
+    end
+    restored:close()
+
+    local too_many = checkpoint:sub(1, 20) .. string.char(32)
+    if (pcall(pcg32.fromstate, too_many)) then
+        error("pcg32.fromstate must fail on a cache holding 32 bits or more")
+    end
+    local stray = checkpoint:sub(1, 20 - 1) .. string.char(128) .. string.char(0)
+    if (pcall(rng.setstate, rng, stray)) then
+        error("pcg32.setstate must fail on cached bits beyond the number of cached bits")
+    end
+
+    rng:close()
+    clone:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_integer_and_binary_args()
+    print()
+    print("[PCG32] assert integer and binary string arguments")
+
+    local unpack = table.unpack or unpack
+
+    local rng = pcg32.new(42, 54)
+    local twin = pcg32.new("0x2a", "0x36")
+    for i = 1, 100 do
+        if (rng:next() ~= twin:next()) then
+            error("pcg32.new(42, 54) must match pcg32.new(\"0x2a\", \"0x36\") at position " .. i)
+        end
+    end
+
+    rng:advance(1000)
+    twin:advance("0x3e8")
+    if (rng:next() ~= twin:next()) then
+        error("pcg32.advance(1000) must match pcg32.advance(\"0x3e8\")")
+    end
+
+    local values = rng:fill(10)
+    rng:advance(-10)
+    for i = 1, #values do
+        if (rng:next() ~= values[i]) then
+            error("pcg32.advance(-10) must jump back 10 steps")
+        end
+    end
+
+    local binary_initstate = string.char(unpack(initstate_pcg32_bytearray))
+    local binary_initseq = string.char(unpack(initseq_pcg32_bytearray))
+    rng:seed({binary = binary_initstate}, {binary = binary_initseq})
+    twin:seed(initstate_pcg32, initseq_pcg32)
+    for i = 1, 100 do
+        if (rng:next() ~= twin:next()) then
+            error("pcg32.seed must accept little-endian binary strings at position " .. i)
+        end
+    end
+
+    -- strings are always hex, even when they hold exactly 8 bytes
+    local function binary(hex)
+        local bytes = {}
+        hex = hex:sub(3)
+        for i = 1, 8 do
+            local digits = hex:sub(-2 * i, -2 * i + 1)
+            if (i * 2 > #hex) then
+                digits = (i * 2 - 1 == #hex) and hex:sub(1, 1) or "0"
+            end
+            bytes[i] = tonumber(digits, 16)
+        end
+        return string.char(unpack(bytes))
+    end
+    for _, delta in ipairs({"0x7830", "0x3837363534", "0x30303030307830"}) do
+        rng:seed(initstate_pcg32, initseq_pcg32)
+        twin:seed(initstate_pcg32, initseq_pcg32)
+        rng:advance({binary = binary(delta)})
+        twin:advance(delta)
+        if (rng:next() ~= twin:next()) then
+            error("pcg32.advance({binary = s}) must match pcg32.advance(" .. delta .. ")")
+        end
+        if (pcall(rng.advance, rng, binary(delta))) then
+            error("pcg32.advance must not take a bare binary string as binary")
+        end
+    end
+    if (pcall(rng.advance, rng, {binary = binary("0x1"):sub(2)})) then
+        error("pcg32.advance must fail on a binary string with the wrong size")
+    end
+    if (pcall(rng.advance, rng, {binary = 1})) then
+        error("pcg32.advance must fail on a field 'binary' that is not a string")
+    end
+
+    if (pcall(rng.advance, rng, 1.5)) then
+        error("pcg32.advance(1.5) must fail")
+    end
+
+    -- malformed hex strings are never taken as binary
+    local malformed_hex = {
+        {{"deadbeef", "0x1"}, "Hex prefix not found"},
+        {{"0x12345g", "0x1"}, "is not a digit"},
+        {{"12345678", "0x1"}, "Hex prefix not found"},
+        {{"0x1", "0X12345G"}, "is not a digit"},
+    }
+    for _, case in ipairs(malformed_hex) do
+        local ok, err = pcall(pcg32.new, unpack(case[1]))
+        if (ok or not tostring(err):find(case[2], 1, true)) then
+            error("pcg32.new(\"" .. case[1][1] .. "\", \"" .. case[1][2] .. "\") must raise \"" .. case[2] .. "\"")
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_sampler()
+    print()
+    print("[PCG32] assert sampler")
+
+    local unpack = table.unpack or unpack
+
+    local cases = {{6}, {16}, {1}, {0xFFFFFFFF}, {15, 40}, {-100, 100}}
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    for _, bounds in ipairs(cases) do
+        local sampler = rng:sampler(unpack(bounds))
+        for i = 1, 100 do
+            if (sampler() ~= twin:next(unpack(bounds))) then
+                error("pcg32.sampler must match pcg32.next on iteration " .. i)
+            end
+        end
+
+        local values = sampler(100)
+        if (#values ~= 100) then
+            error("Unexpected number of values provided by a pcg32.sampler")
+        end
+        for i = 1, #values do
+            if (values[i] ~= twin:next(unpack(bounds))) then
+                error("pcg32.sampler(n) must match pcg32.next at position " .. i)
+            end
+        end
+    end
+
+    if (pcall(rng.sampler, rng)) then
+        error("pcg32.sampler() must fail")
+    end
+    if (pcall(rng.sampler, rng, 0)) then
+        error("pcg32.sampler(0) must fail")
+    end
+
+    local sampler = rng:sampler(6)
+    rng:close()
+    twin:close()
+
+    if (pcall(sampler)) then
+        error("a pcg32.sampler must fail after pcg32.close")
+    end
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_iter()
+    print()
+    print("[PCG32] assert iter")
+
+    local unpack = table.unpack or unpack
+
+    local cases = {{}, {6}, {16}, {15, 40}, {-100, 100}}
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    for _, bounds in ipairs(cases) do
+        local count = 0
+        for i, x in rng:iter(100, unpack(bounds)) do
+            count = count + 1
+            if (i ~= count) then
+                error("pcg32.iter must yield consecutive indices")
+            end
+            if (x ~= twin:next(unpack(bounds))) then
+                error("pcg32.iter must match pcg32.next on iteration " .. i)
+            end
+        end
+        if (count ~= 100) then
+            error("Unexpected number of iterations on pcg32.iter")
+        end
+    end
+
+    for _ in rng:iter(0) do
+        error("pcg32.iter(0) must not iterate")
+    end
+
+    if (pcall(rng.iter, rng, -1)) then
+        error("pcg32.iter(-1) must fail")
+    end
+
+    local iter, state, control = rng:iter(10)
+    rng:close()
+    twin:close()
+
+    if (pcall(iter, state, control)) then
+        error("a pcg32.iter must fail after pcg32.close")
+    end
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_bits_bool()
+    print()
+    print("[PCG32] assert bits and bool")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    -- 32 bits on an empty cache are a whole value
+    for i = 1, 10 do
+        if (rng:bits(32) ~= twin:next()) then
+            error("pcg32.bits(32) must match pcg32.next on iteration " .. i)
+        end
+    end
+
+    -- bits are taken from the lowest to the highest one
+    for i = 1, 10 do
+        local bytes = twin:nextbytes()
+        for j = 1, 4 do
+            if (rng:bits(8) ~= bytes[j]) then
+                error("pcg32.bits(8) must match the bytes of pcg32.nextbytes on iteration " .. i)
+            end
+        end
+    end
+
+    for i = 1, 10 do
+        local bytes = twin:nextbytes()
+        for j = 1, 4 do
+            local byte = bytes[j]
+            for _ = 1, 8 do
+                if (rng:bool() ~= (byte % 2 == 1)) then
+                    error("pcg32.bool must match the bits of pcg32.nextbytes on iteration " .. i)
+                end
+                byte = math.floor(byte / 2)
+            end
+        end
+    end
+
+    -- the cached bits become the lowest bits of a value crossing two draws
+    rng:bits(32 - 4)
+    local high = math.floor(twin:nextbytes()[4] / 16)
+    local low = twin:nextbytes()[1] % 16
+    if (rng:bits(8) ~= high + 16 * low) then
+        error("pcg32.bits must join the cached bits with the bits of a new draw")
+    end
+
+    -- seed, advance and setstate discard the cached bits
+    local state = twin:getstate()
+    rng:bool()
+    rng:setstate(state)
+    if (rng:bits(32) ~= twin:next()) then
+        error("pcg32.setstate must discard the cached bits")
+    end
+    rng:bool()
+    twin:next()
+    rng:advance(10)
+    twin:advance(10)
+    if (rng:bits(32) ~= twin:next()) then
+        error("pcg32.advance must discard the cached bits")
+    end
+    rng:bool()
+    rng:seed(initstate_pcg32, initseq_pcg32)
+    twin:seed(initstate_pcg32, initseq_pcg32)
+    if (rng:bits(32) ~= twin:next()) then
+        error("pcg32.seed must discard the cached bits")
+    end
+
+    -- the discarded bits never leak into the values drawn afterwards
+    rng:bits(3)
+    twin:next()
+    rng:advance(1)
+    twin:advance(1)
+    if (rng:bits(4) ~= twin:nextbytes()[1] % 16) then
+        error("pcg32.advance must clear the cached bits")
+    end
+    rng:bits(2)
+    rng:seed(initstate_pcg32, initseq_pcg32)
+    twin:seed(initstate_pcg32, initseq_pcg32)
+    if (rng:bool() ~= (twin:nextbytes()[1] % 2 == 1)) then
+        error("pcg32.seed must clear the cached bits")
+    end
+    state = twin:getstate()
+    rng:bits(2)
+    rng:setstate(state)
+    if (rng:bits(4) ~= twin:nextbytes()[1] % 16) then
+        error("pcg32.setstate must clear the cached bits")
+    end
+
+    if (pcall(rng.bits, rng, 0)) then
+        error("pcg32.bits(0) must fail")
+    end
+    if (pcall(rng.bits, rng, 32 + 1)) then
+        error("pcg32.bits(32 + 1) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_shuffle()
+    print()
+    print("[PCG32] assert shuffle")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    -- Fisher-Yates written in Lua
+    local function shuffle(t, i, j)
+        for k = j, i + 1, -1 do
+            local r = i + twin:next(k - i + 1)
+            t[k], t[r] = t[r], t[k]
+        end
+        return t
+    end
+
+    local n = 1000
+    local t, expected = {}, {}
+    for k = 1, n do
+        t[k] = k
+        expected[k] = k
+    end
+
+    if (rng:shuffle(t) ~= t) then
+        error("pcg32.shuffle must return the table")
+    end
+    shuffle(expected, 1, n)
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg32.shuffle must match the Fisher-Yates algorithm at position " .. k)
+        end
+    end
+
+    local seen = {}
+    for k = 1, n do
+        seen[t[k]] = true
+    end
+    for k = 1, n do
+        if (not seen[k]) then
+            error("pcg32.shuffle must keep every value of the table")
+        end
+    end
+
+    rng:shuffle(t, 101, 200)
+    shuffle(expected, 101, 200)
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg32.shuffle(t, i, j) must only shuffle the positions i to j")
+        end
+    end
+
+    rng:shuffle(t, 900)
+    shuffle(expected, 900, n)
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg32.shuffle(t, i) must shuffle the positions i to #t")
+        end
+    end
+
+    -- nothing to shuffle
+    rng:shuffle({})
+    rng:shuffle({1})
+    rng:shuffle(t, 10, 5)
+
+    -- an empty range whose i does not fit on the table index type
+    local snapshot = {}
+    for k = 1, #t do
+        snapshot[k] = t[k]
+    end
+    rng:shuffle(t, 4294967296 + 1, 10)
+    for k = 1, #t do
+        if (t[k] ~= snapshot[k]) then
+            error("pcg32.shuffle(t, 2^32 + 1, 10) must leave the table untouched")
+        end
+    end
+
+    if (rng:next() ~= twin:next()) then
+        error("pcg32.shuffle must not draw values when there is nothing to shuffle")
+    end
+
+    if (pcall(rng.shuffle, rng, t, 0)) then
+        error("pcg32.shuffle(t, 0) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_permutation()
+    print()
+    print("[PCG32] assert permutation and permutationbuffer")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local function draw(k)
+        return twin:next(k)
+    end
+
+    -- inside-out Fisher-Yates written in Lua
+    local function permutation(n)
+        local t = {}
+        for k = 1, n do
+            local r = 1 + draw(k)
+            t[k] = t[r]
+            t[r] = k
+        end
+        return t
+    end
+
+    local n = 1000
+    local t = rng:permutation(n)
+    local expected = permutation(n)
+    if (#t ~= n) then
+        error("Unexpected number of values provided by pcg32.permutation")
+    end
+
+    local seen = {}
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg32.permutation must match the inside-out Fisher-Yates algorithm at position " .. k)
+        end
+        seen[t[k]] = true
+    end
+    for k = 1, n do
+        if (not seen[k]) then
+            error("pcg32.permutation must hold every value from 1 to n")
+        end
+    end
+
+    if (next(rng:permutation(0)) ~= nil) then
+        error("pcg32.permutation(0) must be empty")
+    end
+    if (rng:permutation(1)[1] ~= 1) then
+        error("pcg32.permutation(1) must be {1}")
+    end
+    draw(1)
+
+    if (pcall(rng.permutation, rng, -1)) then
+        error("pcg32.permutation(-1) must fail")
+    end
+
+    local has_ffi, ffi = pcall(require, "ffi")
+    if (has_ffi) then
+        local buf32 = ffi.new("uint32_t[?]", n)
+        rng:permutationbuffer(buf32, n)
+        expected = permutation(n)
+        for k = 1, n do
+            if (tonumber(buf32[k - 1]) ~= expected[k] - 1) then
+                error("pcg32.permutationbuffer must match pcg32.permutation minus 1 at position " .. k)
+            end
+        end
+
+        local buf64 = ffi.new("uint64_t[?]", n)
+        rng:permutationbuffer(buf64, n, 8)
+        expected = permutation(n)
+        for k = 1, n do
+            if (tonumber(buf64[k - 1]) ~= expected[k] - 1) then
+                error("pcg32.permutationbuffer(ptr, n, 8) must match pcg32.permutation minus 1 at position " .. k)
+            end
+        end
+    else
+        print("skipped: FFI is not available")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_sample()
+    print()
+    print("[PCG32] assert sample")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local function draw(k)
+        return twin:next(k)
+    end
+
+    -- Floyd's algorithm and partial Fisher-Yates written in Lua
+    local function sample(n, k)
+        local t = {}
+        if (k <= math.floor(n / 2)) then
+            local taken = {}
+            for j = n - k + 1, n do
+                local v = 1 + draw(j)
+                if (taken[v]) then
+                    v = j
+                end
+                taken[v] = true
+                t[#t + 1] = v
+            end
+        else
+            local values = {}
+            for j = 1, n do
+                values[j] = j
+            end
+            for j = 1, k do
+                local r = j + draw(n - j + 1)
+                t[j] = values[r]
+                values[r] = values[j]
+            end
+        end
+        return t
+    end
+
+    local cases = {{1000000, 10}, {1000, 100}, {1000, 500}, {1000, 501}, {1000, 1000}, {10, 0}, {0, 0}, {1, 1}}
+    for _, case in ipairs(cases) do
+        local n, k = case[1], case[2]
+        local t = rng:sample(n, k)
+        local expected = sample(n, k)
+        if (#t ~= k) then
+            error(("Unexpected number of values provided by pcg32.sample(%i, %i)"):format(n, k))
+        end
+        local seen = {}
+        for i = 1, k do
+            local v = t[i]
+            if (v ~= expected[i]) then
+                error(("pcg32.sample(%i, %i) must match the reference algorithm at position %i"):format(n, k, i))
+            end
+            if (v < 1 or v > n or seen[v]) then
+                error(("pcg32.sample(%i, %i) must provide distinct values in [1, n]"):format(n, k))
+            end
+            seen[v] = true
+        end
+    end
+
+    if (pcall(rng.sample, rng, 10, 11)) then
+        error("pcg32.sample(10, 11) must fail")
+    end
+    if (pcall(rng.sample, rng, 10, -1)) then
+        error("pcg32.sample(10, -1) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_samplesorted()
+    print()
+    print("[PCG32] assert samplesorted")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local cases = {{1000000, 10}, {1000, 100}, {1000, 500}, {1000, 1000}, {100, 99}, {10, 0}, {0, 0}, {1, 1}, {5, 1}}
+    for _, case in ipairs(cases) do
+        local n, k = case[1], case[2]
+        local t = rng:samplesorted(n, k)
+        if (#t ~= k) then
+            error(("Unexpected number of values provided by pcg32.samplesorted(%i, %i)"):format(n, k))
+        end
+        local previous = 0
+        for i = 1, k do
+            local v = t[i]
+            if (v <= previous or v > n) then
+                error(("pcg32.samplesorted(%i, %i) must provide increasing values in [1, n]"):format(n, k))
+            end
+            previous = v
+        end
+
+        local count = 0
+        for i, v in twin:itersorted(n, k) do
+            count = count + 1
+            if (i ~= count or v ~= t[i]) then
+                error(("pcg32.itersorted(%i, %i) must match pcg32.samplesorted(%i, %i) at position %i"):format(n, k, n, k, count))
+            end
+        end
+        if (count ~= k) then
+            error(("Unexpected number of values provided by pcg32.itersorted(%i, %i)"):format(n, k))
+        end
+    end
+
+    -- every integer must be selected with probability k / n
+    local runs = 4000
+    local frequencies = {}
+    for v = 1, 10 do
+        frequencies[v] = 0
+    end
+    for _ = 1, runs do
+        for _, v in ipairs(rng:samplesorted(10, 3)) do
+            frequencies[v] = frequencies[v] + 1
+        end
+    end
+    for v = 1, 10 do
+        if (math.abs(frequencies[v] - runs * 3 / 10) > 150) then
+            error(("pcg32.samplesorted(10, 3) selected %i with unexpected frequency %i"):format(v, frequencies[v]))
+        end
+    end
+
+    for v = 1, 10 do
+        frequencies[v] = 0
+    end
+    for _ = 1, runs do
+        for _, v in rng:itersorted(1000000, 2) do
+            local bucket = 1 + math.floor((v - 1) / 100000)
+            frequencies[bucket] = frequencies[bucket] + 1
+        end
+    end
+    for v = 1, 10 do
+        if (math.abs(frequencies[v] - runs * 2 / 10) > 150) then
+            error(("pcg32.itersorted(1000000, 2) selected the bucket %i with unexpected frequency %i"):format(v, frequencies[v]))
+        end
+    end
+
+    if (pcall(rng.samplesorted, rng, 10, 11)) then
+        error("pcg32.samplesorted(10, 11) must fail")
+    end
+    if (pcall(rng.samplesorted, rng, 10, -1)) then
+        error("pcg32.samplesorted(10, -1) must fail")
+    end
+    if (pcall(rng.itersorted, rng, -1, 0)) then
+        error("pcg32.itersorted(-1, 0) must fail")
+    end
+
+    local iterator = rng:itersorted(10, 5)
+    rng:close()
+    if (pcall(iterator, nil, 0)) then
+        error("pcg32.itersorted iterator must fail after close")
+    end
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32_assert_normal_exponential()
+    print()
+    print("[PCG32] assert normal and exponential")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    -- the single and bulk forms consume the rng in the same manner
+    local t = rng:normal(2.5, 3, 1000)
+    local e = rng:exponential(4, 1000)
+    if (#t ~= 1000 or #e ~= 1000) then
+        error("Unexpected number of values provided by pcg32.normal and pcg32.exponential")
+    end
+    for i = 1, #t do
+        if (t[i] ~= 2.5 + 3 * twin:normal()) then
+            error(("pcg32.normal(mu, sigma, n) must match pcg32.normal() at position %i"):format(i))
+        end
+    end
+    for i = 1, #e do
+        if (e[i] ~= (1 / 4) * twin:exponential() or e[i] < 0) then
+            error(("pcg32.exponential(lambda, n) must match pcg32.exponential() at position %i"):format(i))
+        end
+    end
+
+    -- standard normal cumulative distribution function (Abramowitz and Stegun, 26.2.17)
+    local function normal_cdf(x)
+        local z = math.abs(x)
+        local k = 1 / (1 + 0.2316419 * z)
+        local p = 1 - math.exp(-0.5 * z * z) / math.sqrt(2 * math.pi) * k * (0.319381530 + k * (-0.356563782 + k * (1.781477937 + k * (-1.821255978 + k * 1.330274429))))
+        return x >= 0 and p or 1 - p
+    end
+
+    local function exponential_cdf(x)
+        return 1 - math.exp(-x)
+    end
+
+    -- Kolmogorov-Smirnov statistic of the sample values against cdf
+    local function ks(values, cdf)
+        local d = 0
+        table.sort(values)
+        for i = 1, #values do
+            local f = cdf(values[i])
+            d = math.max(d, math.abs(f - i / #values), math.abs(f - (i - 1) / #values))
+        end
+        return d
+    end
+
+    local n = 100000
+    local samples = {normal = rng:normal(0, 1, n), exponential = rng:exponential(1, n)}
+    local cdfs = {normal = normal_cdf, exponential = exponential_cdf}
+    local means = {normal = 0, exponential = 1}
+    -- fourth central moments, which bound the error of the sample variance
+    local moments = {normal = 3, exponential = 9}
+    for name, values in pairs(samples) do
+        local sum, sum2 = 0, 0
+        for i = 1, n do
+            sum = sum + values[i]
+            sum2 = sum2 + values[i] * values[i]
+        end
+        local mean = sum / n
+        local variance = sum2 / n - mean * mean
+        if (math.abs(mean - means[name]) > 5 / math.sqrt(n) or math.abs(variance - 1) > 5 * math.sqrt((moments[name] - 1) / n)) then
+            error(("pcg32.%s provided unexpected moments: mean %f, variance %f"):format(name, mean, variance))
+        end
+        local d = ks(values, cdfs[name])
+        if (d > 1.95 / math.sqrt(n)) then
+            error(("pcg32.%s failed the Kolmogorov-Smirnov test: D = %f"):format(name, d))
+        end
+    end
+
+    -- the tails beyond the base layer of the ziggurat are reached
+    local tail = 0
+    for _, x in ipairs(rng:normal(0, 1, 200000)) do
+        if (math.abs(x) > 3.6541528853610088) then
+            tail = tail + 1
+        end
+    end
+    if (tail == 0 or math.abs(tail - 200000 * 2.58052e-4) > 5 * math.sqrt(200000 * 2.58052e-4)) then
+        error(("pcg32.normal reached the tails with unexpected frequency %i"):format(tail))
+    end
+
+    if (rng:normal(1, 0) ~= 1) then
+        error("pcg32.normal(mu, 0) must provide mu")
+    end
+    if (pcall(rng.normal, rng, 0, -1)) then
+        error("pcg32.normal(0, -1) must fail")
+    end
+    if (pcall(rng.normal, rng, 0 / 0, 1)) then
+        error("pcg32.normal(nan, 1) must fail")
+    end
+    if (pcall(rng.normal, rng, 0, 1, -1)) then
+        error("pcg32.normal(0, 1, -1) must fail")
+    end
+    if (pcall(rng.exponential, rng, 0)) then
+        error("pcg32.exponential(0) must fail")
+    end
+    if (pcall(rng.exponential, rng, -1)) then
+        error("pcg32.exponential(-1) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
 local tests = {
     pcg32_100_numbers,
     pcg32_100_numbers_from_bytearray,
@@ -278,7 +1503,23 @@ local tests = {
     pcg32_random_four_bytes,
     pcg32_assert_next,
     pcg32_assert_next_from_bytearray,
-    pcg32_assert_advance
+    pcg32_assert_advance,
+    pcg32_assert_fill,
+    pcg32_assert_bytes,
+    pcg32_assert_fillbuffer,
+    pcg32_assert_nextdouble_nextfloat,
+    pcg32_assert_bounded_next,
+    pcg32_assert_split,
+    pcg32_assert_getstate_setstate,
+    pcg32_assert_integer_and_binary_args,
+    pcg32_assert_sampler,
+    pcg32_assert_iter,
+    pcg32_assert_bits_bool,
+    pcg32_assert_shuffle,
+    pcg32_assert_permutation,
+    pcg32_assert_sample,
+    pcg32_assert_samplesorted,
+    pcg32_assert_normal_exponential
 }
 
 for i, test_func in ipairs(tests) do
@@ -0,0 +1,217 @@
+-- Allow lua-pcg to be tested
+-- without edits on DOSBox
+-- (16-bit OS) when lua-pcg is
+-- is merged with Lua's
+-- interpreter source code (lua.c),
+-- To do that, lua.c is edited
+-- to load lua-pcg.
+if (pcg == nil) then
+    pcg = require("lua-pcg")
+end
+local pcg32 = pcg.pcg32
+local pcg32x8 = pcg.pcg32x8
+
+print()
+print("------------------------------------------")
+print("PCG32X8")
+print("------------------------------------------")
+print()
+print("******************************************")
+print()
+print("lua-pcg version: " .. pcg.version)
+print("32-bit integer: " .. tostring(pcg.has32bitinteger))
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("pcg32x8 kernel: " .. tostring(pcg32x8.kernel))
+
+local lanes = 8
+local initstate_pcg32, initseq_pcg32 = '0x853c49e6748fea9b', '0xda3e39cb94b95bdb'
+
+local function read_lines()
+    local lines = {}
+    local pcg_file = assert(io.open("tests/next32.txt", "r"), "Unable to open next32.txt file")
+    for line in pcg_file:lines() do
+        table.insert(lines, line)
+    end
+    pcg_file:close()
+    return lines
+end
+
+-- creates one pcg32 twin for each lane of a pcg32x8
+-- created through pcg32x8.new('0x2a', '0x10')
+local function new_twins()
+    local twins = {}
+    for lane = 1, lanes do
+        twins[lane] = pcg32.new('0x2a', ("0x%02x"):format(0x10 + lane - 1))
+    end
+    return twins
+end
+
+local function close_twins(twins)
+    for lane = 1, lanes do
+        twins[lane]:close()
+    end
+end
+
+local function pcg32x8_assert_lanes_next()
+    print()
+    print("[PCG32X8] assert next on every lane")
+
+    local rng = pcg32x8.new()
+    for lane = 1, lanes do
+        rng:seed(initstate_pcg32, initseq_pcg32, lane)
+    end
+
+    local lines = read_lines()
+    for i = 1, #lines do
+        local values = {rng:next()}
+        if (#values ~= lanes) then
+            error("Unexpected number of values provided by pcg32x8.next")
+        end
+
+        for lane = 1, lanes do
+            if (lines[i] ~= ("[%05i] 0x%08X"):format(i, values[lane])) then
+                error("Invalid pcg32x8.next output of lane " .. lane .. " on line " .. i .. " from next32.txt")
+            end
+        end
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32x8_assert_lanes_fill()
+    print()
+    print("[PCG32X8] assert fill on every lane")
+
+    local rng = pcg32x8.new()
+    for lane = 1, lanes do
+        rng:seed(initstate_pcg32, initseq_pcg32, lane)
+    end
+
+    local lines = read_lines()
+    local rounds = math.floor(#lines / lanes)
+    local t = rng:fill(lanes * rounds)
+    if (#t ~= lanes * rounds) then
+        error("Unexpected number of values provided by pcg32x8.fill")
+    end
+
+    for i = 1, rounds do
+        for lane = 1, lanes do
+            if (lines[i] ~= ("[%05i] 0x%08X"):format(i, t[lanes * (i - 1) + lane])) then
+                error("Invalid pcg32x8.fill output of lane " .. lane .. " on line " .. i .. " from next32.txt")
+            end
+        end
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function pcg32x8_assert_streams()
+    print()
+    print("[PCG32X8] assert lane streams, partial rounds and advance")
+
+    local rng = pcg32x8.new('0x2a', '0x10')
+    local twins = new_twins()
+
+    -- partial rounds only step the first lanes
+    for _, n in ipairs({0, 1, 3, 8, 13, 200, 301}) do
+        local t = rng:fill(n)
+        if (#t ~= n) then
+            error("Unexpected number of values provided by pcg32x8.fill(" .. n .. ")")
+        end
+
+        for i = 1, n do
+            local lane = (i - 1) % lanes + 1
+            if (t[i] ~= twins[lane]:next()) then
+                error("Invalid pcg32x8.fill(" .. n .. ") output at position " .. i)
+            end
+        end
+    end
+
+    rng:advance('0x1234')
+    for lane = 1, lanes do
+        twins[lane]:advance('0x1234')
+    end
+
+    local values = {rng:next()}
+    for lane = 1, lanes do
+        if (values[lane] ~= twins[lane]:next()) then
+            error("Invalid pcg32x8.next output of lane " .. lane .. " after advance")
+        end
+    end
+
+    for _, lane in ipairs({0, 9}) do
+        if (pcall(rng.seed, rng, '0x1', '0x1', lane)) then
+            error("pcg32x8.seed must reject lanes out of [1, 8] range")
+        end
+    end
+
+    close_twins(twins)
+    rng:close()
+
+    if (pcall(rng.next, rng)) then
+        error("pcg32x8.next must fail after close")
+    end
+
+    print("done")
+    print()
+end
+
+local function pcg32x8_assert_fillbuffer()
+    print()
+    print("[PCG32X8] assert fillbuffer")
+
+    local rng = pcg32x8.new('0x2a', '0x10')
+
+    if (pcall(rng.fillbuffer, rng, {}, 1)) then
+        error("pcg32x8.fillbuffer must reject arguments other than lightuserdata or cdata")
+    end
+
+    local has_ffi, ffi = pcall(require, "ffi")
+    if (has_ffi) then
+        local twins = new_twins()
+
+        local n = 1000 + 5
+        local buf = ffi.new("uint32_t[?]", n)
+        rng:fillbuffer(buf, n)
+
+        for i = 0, n - 1 do
+            if (tonumber(buf[i]) ~= twins[i % lanes + 1]:next()) then
+                error("Invalid pcg32x8.fillbuffer output at position " .. i)
+            end
+        end
+
+        close_twins(twins)
+    else
+        print("skipped: FFI is not available")
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local tests = {
+    pcg32x8_assert_lanes_next,
+    pcg32x8_assert_lanes_fill,
+    pcg32x8_assert_streams,
+    pcg32x8_assert_fillbuffer
+}
+
+for i, test_func in ipairs(tests) do
+    test_func()
+    print("******************************************")
+end
+
+print()
+print("------------------------------------------")
+print("------------------------------------------")
+print()
+print()
@@ -269,6 +269,1321 @@ local function pcg64_assert_advance()
     print()
 end
 
+local function pcg64_assert_fill()
+    print()
+    print("[PCG64] assert fill and fillinto")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local values = rng:fill(1000)
+    if (#values ~= 1000) then
+        error("Unexpected number of values provided by pcg64.fill")
+    end
+    for i = 1, #values do
+        if (values[i] ~= twin:next()) then
+            error("Invalid pcg64.fill output at position " .. i)
+        end
+    end
+
+    values = rng:fill(1000, 30)
+    for i = 1, #values do
+        if (values[i] ~= twin:next(30)) then
+            error("Invalid pcg64.fill(n, bound) output at position " .. i)
+        end
+    end
+
+    values = rng:fill(1000, -50, 30)
+    for i = 1, #values do
+        if (values[i] ~= twin:next(-50, 30)) then
+            error("Invalid pcg64.fill(n, a, b) output at position " .. i)
+        end
+    end
+
+    if (#rng:fill(0) ~= 0) then
+        error("pcg64.fill(0) must return an empty table")
+    end
+
+    local t = {"first", "second"}
+    for k = 1, 3 do
+        if (rng:fillinto(t, 3, 502, 15, 40) ~= t) then
+            error("pcg64.fillinto must return the table provided")
+        end
+        if (t[1] ~= "first" or t[2] ~= "second" or #t ~= 502) then
+            error("pcg64.fillinto changed positions out of range")
+        end
+        for i = 3, #t do
+            if (t[i] ~= twin:next(15, 40)) then
+                error("Invalid pcg64.fillinto output at position " .. i)
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_bytes()
+    print()
+    print("[PCG64] assert bytes")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local lines = {}
+    local pcg_file = assert(io.open("tests/next64.txt", "r"), "Unable to open next64.txt file")
+    for line in pcg_file:lines() do
+        table.insert(lines, line)
+    end
+    pcg_file:close()
+
+    local data = rng:bytes(8 * #lines)
+    if (#data ~= 8 * #lines) then
+        error("Unexpected number of bytes provided by pcg64.bytes")
+    end
+
+    for i = 1, #lines do
+        local buffer = {("[%05i] 0x"):format(i)}
+        for j = 8 * i, 8 * (i - 1) + 1, -1 do
+            table.insert(buffer, ("%02X"):format(data:byte(j)))
+        end
+
+        if (lines[i] ~= table.concat(buffer)) then
+            error("Invalid pcg64.bytes output on line " .. i .. " from next64.txt")
+        end
+    end
+
+    rng:close()
+
+    rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    for n = 0, 2 * 8 + 1 do
+        data = rng:bytes(n)
+        if (#data ~= n) then
+            error("Unexpected number of bytes provided by pcg64.bytes(" .. n .. ")")
+        end
+
+        local expected = {}
+        while (#expected < n) do
+            for _, b in ipairs(twin:nextbytes()) do
+                table.insert(expected, b)
+            end
+        end
+
+        for j = 1, n do
+            if (data:byte(j) ~= expected[j]) then
+                error("Invalid pcg64.bytes(" .. n .. ") output at position " .. j)
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_fillbuffer()
+    print()
+    print("[PCG64] assert fillbuffer")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    if (pcall(rng.fillbuffer, rng, {}, 1)) then
+        error("pcg64.fillbuffer must reject arguments other than lightuserdata or cdata")
+    end
+
+    local has_ffi, ffi = pcall(require, "ffi")
+    if (has_ffi) then
+        local lines = {}
+        local pcg_file = assert(io.open("tests/next64.txt", "r"), "Unable to open next64.txt file")
+        for line in pcg_file:lines() do
+            table.insert(lines, line)
+        end
+        pcg_file:close()
+
+        -- each 64-bit value is split on two consecutive 32-bit elements (low, high)
+        local buf = ffi.new("uint32_t[?]", 2 * #lines)
+        rng:fillbuffer(buf, 2 * #lines, 4)
+
+        for i = 1, #lines do
+            local low, high = tonumber(buf[2 * i - 2]), tonumber(buf[2 * i - 1])
+            if (lines[i] ~= ("[%05i] 0x%08X%08X"):format(i, high, low)) then
+                error("Invalid pcg64.fillbuffer output on line " .. i .. " from next64.txt")
+            end
+        end
+
+        local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+        twin:fillbuffer(ffi.new("uint32_t[?]", 2 * #lines), 2 * #lines, 4)
+
+        local buf64 = ffi.new("uint64_t[?]", 100)
+        rng:fillbuffer(buf64, 100)
+        local words = ffi.new("uint32_t[?]", 200)
+        twin:fillbuffer(words, 200, 4)
+        for i = 0, 99 do
+            local expected = ffi.cast("uint64_t", words[2 * i]) + ffi.cast("uint64_t", words[2 * i + 1]) * ffi.cast("uint64_t", 4294967296)
+            if (buf64[i] ~= expected) then
+                error("Invalid pcg64.fillbuffer output at position " .. i)
+            end
+        end
+
+        -- pointers are dereferenced rather than overwritten
+        local target = ffi.new("uint32_t[?]", 16)
+        local ptr = ffi.cast("uint32_t *", target)
+        local address = tonumber(ffi.cast("uintptr_t", ptr))
+        rng:fillbuffer(ptr, 16, 4)
+        local expected_words = ffi.new("uint32_t[?]", 16)
+        twin:fillbuffer(expected_words, 16, 4)
+        if (tonumber(ffi.cast("uintptr_t", ptr)) ~= address) then
+            error("pcg64.fillbuffer must not overwrite a pointer cdata")
+        end
+        for i = 0, 15 do
+            if (target[i] ~= expected_words[i]) then
+                error("Invalid pcg64.fillbuffer output through a pointer cdata at position " .. i)
+            end
+        end
+
+        -- integer addresses
+        rng:fillbuffer(ffi.cast("uintptr_t", ptr), 16, 4)
+        twin:fillbuffer(expected_words, 16, 4)
+        for i = 0, 15 do
+            if (target[i] ~= expected_words[i]) then
+                error("Invalid pcg64.fillbuffer output through an integer address at position " .. i)
+            end
+        end
+
+        if (pcall(rng.fillbuffer, rng, ffi.new("double", 1), 1)) then
+            error("pcg64.fillbuffer must reject cdata that cannot be converted to a pointer")
+        end
+
+        twin:close()
+    else
+        print("skipped: FFI is not available")
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_nextdouble_nextfloat()
+    print()
+    print("[PCG64] assert nextdouble and nextfloat")
+
+    local unpack_args = table.unpack or unpack
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local function next_words()
+        local b = twin:nextbytes()
+        local low = b[1] + 256 * (b[2] + 256 * (b[3] + 256 * b[4]))
+        local high = b[5] + 256 * (b[6] + 256 * (b[7] + 256 * b[8]))
+        return low, high
+    end
+
+    -- expected values computed from the twin generator
+    local function expected_double()
+        local low, high = next_words()
+        return (high * 2097152 + math.floor(low / 2048)) / 9007199254740992
+    end
+
+    local function expected_float()
+        local low, high = next_words()
+        return math.floor(high / 256) / 16777216
+    end
+
+    for i = 1, 1000 do
+        local x = rng:nextdouble()
+        if (x ~= expected_double() or x < 0 or x >= 1) then
+            error("Invalid pcg64.nextdouble output on iteration " .. i)
+        end
+
+        x = rng:nextfloat()
+        if (x ~= expected_float() or x < 0 or x >= 1) then
+            error("Invalid pcg64.nextfloat output on iteration " .. i)
+        end
+
+        x = rng:nextdouble(-2.5, 7.5)
+        if (x ~= -2.5 + 10 * expected_double() or x < -2.5 or x > 7.5) then
+            error("Invalid pcg64.nextdouble(a, b) output on iteration " .. i)
+        end
+
+        x = rng:nextfloat(3)
+        if (x ~= 3 * expected_float() or x < 0 or x > 3) then
+            error("Invalid pcg64.nextfloat(b) output on iteration " .. i)
+        end
+    end
+
+    local t = rng:filldouble(100, 10, 20)
+    if (#t ~= 100) then
+        error("Unexpected number of values provided by pcg64.filldouble")
+    end
+
+    for i = 1, #t do
+        if (t[i] ~= 10 + 10 * expected_double()) then
+            error("Invalid pcg64.filldouble output at position " .. i)
+        end
+    end
+
+    t = rng:fillfloat(100)
+    if (#t ~= 100) then
+        error("Unexpected number of values provided by pcg64.fillfloat")
+    end
+
+    for i = 1, #t do
+        if (t[i] ~= expected_float()) then
+            error("Invalid pcg64.fillfloat output at position " .. i)
+        end
+    end
+
+    if (#(rng:filldouble(0)) ~= 0 or #(rng:fillfloat(0, 1, 2)) ~= 0) then
+        error("pcg64.filldouble and pcg64.fillfloat must provide empty tables for n = 0")
+    end
+
+    local invalid_args = {
+        {0},
+        {-1},
+        {1, 1},
+        {2, 1},
+        {0, 1 / 0},
+        {1, 2, 3}
+    }
+
+    for _, args in ipairs(invalid_args) do
+        if (pcall(rng.nextdouble, rng, unpack_args(args)) or pcall(rng.nextfloat, rng, unpack_args(args))) then
+            error("pcg64.nextdouble and pcg64.nextfloat must reject invalid arguments")
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_bounded_next()
+    print()
+    print("[PCG64] assert bounded next")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    -- bounds below 2^21 keep every product exact on Lua 5.1 numbers
+    local bounds = {1, 2, 3, 5, 6, 7, 64, 100, 1000, 1024, 12345, 65536, 1048573}
+
+    local function next_words()
+        local b = twin:nextbytes()
+        local low = b[1] + 256 * (b[2] + 256 * (b[3] + 256 * b[4]))
+        local high = b[5] + 256 * (b[6] + 256 * (b[7] + 256 * b[8]))
+        return low, high
+    end
+
+    -- computes the 128-bit product (low, middle, top) of a 64-bit value and bound
+    local function product(bound)
+        local low, high = next_words()
+        local p = low * bound
+        local q = high * bound + math.floor(p / 4294967296)
+        return p % 4294967296, q % 4294967296, math.floor(q / 4294967296)
+    end
+
+    -- reference implementation of Lemire's method with a power-of-two fast path
+    local function expected_bounded(bound)
+        if (1048576 % bound == 0) then
+            local low = next_words()
+            return low % bound
+        end
+
+        local low, middle, top = product(bound)
+        if (middle == 0 and low < bound) then
+            local r = 4294967296 % bound
+            local threshold = (bound - (r * r) % bound) % bound
+            while (middle == 0 and low < threshold) do
+                low, middle, top = product(bound)
+            end
+        end
+
+        return top
+    end
+
+    for _, bound in ipairs(bounds) do
+        for i = 1, 200 do
+            local n = rng:next(bound)
+            if (n ~= expected_bounded(bound)) then
+                error(("Invalid pcg64.next(%i) output on iteration %i"):format(bound, i))
+            end
+
+            n = rng:next(-7, bound - 7)
+            if (n ~= expected_bounded(bound) - 7) then
+                error(("Invalid pcg64.next(-7, %i) output on iteration %i"):format(bound - 7, i))
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_bounded_next_64bit()
+    print()
+    print("[PCG64] assert bounded next on 64-bit bounds")
+
+    -- 64-bit bounds can only be written as integers on Lua 5.3+ with 64-bit integers
+    if (math.type == nil or not pcg.has64bitinteger) then
+        print("skipped: 64-bit integers are not available")
+        print("done")
+        print()
+        return
+    end
+
+    -- bounds whose thresholds require a true 64-bit division
+    local expected = {
+        {0x5555555555556000, {0x1C842443153D351B, 0x1E8B7E5509EDA798, 0x00F2CD54E53746A5, 0x233B9914EB2EB56D, 0x2C0C0C1B99BEF9D1, 0x2806AB0FD7F3D4E7, 0x434816AEBAE7C666, 0x4F7BF4EDE2B37469}},
+        {0x7FFFFFFFFFFFFFFF, {0x78B1F09E4F1B6777, 0x1852C88EA15007B4, 0x75626F4773B27A3B, 0x21EEA44AF169CD43, 0x1E9CCA2B881AB543, 0x2EA7CCC0239E7B09, 0x549E7813DAECCA8D, 0x54B95B2491CEC597}},
+        {0x0000123456789ABC, {0x00000E8569929DE1, 0x000001A84806F818, 0x00000957E85A25A4, 0x000008D75F5944F1, 0x0000001987919945, 0x000011F60D666BF7, 0x0000086699889A25, 0x00001020F030B5BC}},
+        {0x4000000000000001, {0x1586DD4333CFFA18, 0x05537E8F724BB684, 0x2CA9AE93798759F3, 0x0E959262F73496C4, 0x2394B5355A2D738D, 0x1305F3C78317F1EB, 0x0EAE4BFDAF63FF23, 0x1D6678E9A4ED2427}}
+    }
+    local expected_between = {3045465452262072992, 774455449184111792, 2270624951431706472, -4234864389681252025, 1601146783025635511, -3168916991742606836, -3654678481912934432, 3974086651668082453}
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    for _, entry in ipairs(expected) do
+        local bound, values = entry[1], entry[2]
+        for i = 1, #values do
+            if (rng:next(bound) ~= values[i]) then
+                error(("Invalid pcg64.next(0x%016X) output on iteration %i"):format(bound, i))
+            end
+        end
+    end
+
+    for i = 1, #expected_between do
+        if (rng:next(-0x4000000000000000, 0x3FFFFFFFFFFFFFFF) ~= expected_between[i]) then
+            error(("Invalid pcg64.next(a, b) output on iteration %i"):format(i))
+        end
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_split()
+    print()
+    print("[PCG64] assert split")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local k = 10
+    local delta = 100
+    local values = twin:fill(k * delta + 1)
+
+    local children = rng:split(k, "0x64")
+    if (#children ~= k) then
+        error("Unexpected number of generators provided by pcg64.split(k, delta)")
+    end
+    for i = 1, k do
+        local block = children[i]:fill(delta)
+        for j = 1, delta do
+            if (block[j] ~= values[(i - 1) * delta + j]) then
+                error(("Invalid pcg64.split(k, delta) output on child %i at position %i"):format(i, j))
+            end
+        end
+        children[i]:close()
+    end
+    if (rng:next() ~= values[k * delta + 1]) then
+        error("pcg64.split(k, delta) must move the parent past the blocks of the children")
+    end
+
+    twin:seed(initstate_pcg64, initseq_pcg64)
+    rng:seed(initstate_pcg64, initseq_pcg64)
+    children = rng:split(k)
+    local twins = twin:split(k)
+    if (#children ~= k or #twins ~= k) then
+        error("Unexpected number of generators provided by pcg64.split(k)")
+    end
+    local seen = {}
+    for i = 1, k do
+        local v = children[i]:next()
+        if (v ~= twins[i]:next()) then
+            error("pcg64.split(k) must derive the children from the state of the parent")
+        end
+        if (seen[v]) then
+            error("pcg64.split(k) derived children that output the same value")
+        end
+        seen[v] = true
+        children[i]:close()
+        twins[i]:close()
+    end
+    if (rng:next() ~= twin:next()) then
+        error("pcg64.split(k) must advance the parent deterministically")
+    end
+
+    if (pcall(rng.split, rng, 0)) then
+        error("pcg64.split(0) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_getstate_setstate()
+    print()
+    print("[PCG64] assert getstate, setstate and fromstate")
+
+    local function tohex(s)
+        return (s:gsub(".", function(c) return ("%02x"):format(c:byte()) end))
+    end
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local state = rng:getstate()
+    if (#state ~= 41) then
+        error("Unexpected number of bytes provided by pcg64.getstate")
+    end
+    if (tohex(state) ~= "d1d503ea0d4756e2048609860494058cb7b7722997737cb40300000000000000000000000000000000") then
+        error("Invalid pcg64.getstate output")
+    end
+
+    local values = rng:fill(100)
+    local clone = pcg64.fromstate(state)
+    rng:setstate(state)
+    for i = 1, #values do
+        if (rng:next() ~= values[i]) then
+            error("Invalid pcg64.next output after pcg64.setstate at position " .. i)
+        end
+        if (clone:next() ~= values[i]) then
+            error("Invalid pcg64.next output after pcg64.fromstate at position " .. i)
+        end
+    end
+    if (rng:getstate() ~= clone:getstate()) then
+        error("pcg64.getstate must match on generators at the same position")
+    end
+
+    if (pcall(rng.setstate, rng, state:sub(2))) then
+        error("pcg64.setstate must fail on a string with the wrong size")
+    end
+    local even = state:sub(1, 16) .. string.char(state:byte(17) - 1) .. state:sub(18)
+    if (pcall(pcg64.fromstate, even)) then
+        error("pcg64.fromstate must fail on an even increment")
+    end
+
+    -- the bit cache is part of the state, such that bits and bool are replayed
+    rng:bits(5)
+    local checkpoint = rng:getstate()
+    local bits = {}
+    for i = 1, 20 do
+        bits[i] = rng:bits(7)
+    end
+    local restored = pcg64.fromstate(checkpoint)
+    rng:setstate(checkpoint)
+    for i = 1, #bits do
+        if (rng:bits(7) ~= bits[i]) then
+            error("pcg64.setstate must restore the cached bits at position " .. i)
+        end
+        if (restored:bits(7) ~= bits[i]) then
+            error("pcg64.fromstate must restore the cached bits at position " .. i)
+        end
+    end
+    restored:close()
+
+    local too_many = checkpoint:sub(1, 40) .. string.char(64)
+    if (pcall(pcg64.fromstate, too_many)) then
+        error("pcg64.fromstate must fail on a cache holding 64 bits or more")
+    end
+    local stray = checkpoint:sub(1, 40 - 1) .. string.char(128) .. string.char(0)
+    if (pcall(rng.setstate, rng, stray)) then
+        error("pcg64.setstate must fail on cached bits beyond the number of cached bits")
+    end
+
+    rng:close()
+    clone:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_integer_and_binary_args()
+    print()
+    print("[PCG64] assert integer and binary string arguments")
+
+    local unpack = table.unpack or unpack
+
+    local rng = pcg64.new(42, 54)
+    local twin = pcg64.new("0x2a", "0x36")
+    for i = 1, 100 do
+        if (rng:next() ~= twin:next()) then
+            error("pcg64.new(42, 54) must match pcg64.new(\"0x2a\", \"0x36\") at position " .. i)
+        end
+    end
+
+    rng:advance(1000)
+    twin:advance("0x3e8")
+    if (rng:next() ~= twin:next()) then
+        error("pcg64.advance(1000) must match pcg64.advance(\"0x3e8\")")
+    end
+
+    local values = rng:fill(10)
+    rng:advance(-10)
+    for i = 1, #values do
+        if (rng:next() ~= values[i]) then
+            error("pcg64.advance(-10) must jump back 10 steps")
+        end
+    end
+
+    local binary_initstate = string.char(unpack(initstate_pcg64_bytearray))
+    local binary_initseq = string.char(unpack(initseq_pcg64_bytearray))
+    rng:seed({binary = binary_initstate}, {binary = binary_initseq})
+    twin:seed(initstate_pcg64, initseq_pcg64)
+    for i = 1, 100 do
+        if (rng:next() ~= twin:next()) then
+            error("pcg64.seed must accept little-endian binary strings at position " .. i)
+        end
+    end
+
+    -- strings are always hex, even when they hold exactly 16 bytes
+    local function binary(hex)
+        local bytes = {}
+        hex = hex:sub(3)
+        for i = 1, 16 do
+            local digits = hex:sub(-2 * i, -2 * i + 1)
+            if (i * 2 > #hex) then
+                digits = (i * 2 - 1 == #hex) and hex:sub(1, 1) or "0"
+            end
+            bytes[i] = tonumber(digits, 16)
+        end
+        return string.char(unpack(bytes))
+    end
+    for _, delta in ipairs({"0x7830", "0x3837363534", "0x30303030307830"}) do
+        rng:seed(initstate_pcg64, initseq_pcg64)
+        twin:seed(initstate_pcg64, initseq_pcg64)
+        rng:advance({binary = binary(delta)})
+        twin:advance(delta)
+        if (rng:next() ~= twin:next()) then
+            error("pcg64.advance({binary = s}) must match pcg64.advance(" .. delta .. ")")
+        end
+        if (pcall(rng.advance, rng, binary(delta))) then
+            error("pcg64.advance must not take a bare binary string as binary")
+        end
+    end
+    if (pcall(rng.advance, rng, {binary = binary("0x1"):sub(2)})) then
+        error("pcg64.advance must fail on a binary string with the wrong size")
+    end
+    if (pcall(rng.advance, rng, {binary = 1})) then
+        error("pcg64.advance must fail on a field 'binary' that is not a string")
+    end
+
+    if (pcall(rng.advance, rng, 1.5)) then
+        error("pcg64.advance(1.5) must fail")
+    end
+
+    -- malformed hex strings are never taken as binary
+    local malformed_hex = {
+        {{"0123456789abcdef", "0x1"}, "Hex prefix not found"},
+        {{"0x0123456789abcg", "0x1"}, "is not a digit"},
+        {{"0x1", "0X0123456789ABCG"}, "is not a digit"},
+        {{"fedcba9876543210", "0x1"}, "Hex prefix not found"},
+    }
+    for _, case in ipairs(malformed_hex) do
+        local ok, err = pcall(pcg64.new, unpack(case[1]))
+        if (ok or not tostring(err):find(case[2], 1, true)) then
+            error("pcg64.new(\"" .. case[1][1] .. "\", \"" .. case[1][2] .. "\") must raise \"" .. case[2] .. "\"")
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_sampler()
+    print()
+    print("[PCG64] assert sampler")
+
+    local unpack = table.unpack or unpack
+
+    local cases = {{6}, {16}, {1}, {0x7FFFFFFF}, {15, 40}, {-100, 100}}
+
+    -- bounds whose thresholds require a true 64-bit division
+    if (math.type ~= nil and pcg.has64bitinteger) then
+        cases[#cases + 1] = {0x5555555555556000}
+        cases[#cases + 1] = {-0x4000000000000000, 0x3FFFFFFFFFFFFFFF}
+    end
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    for _, bounds in ipairs(cases) do
+        local sampler = rng:sampler(unpack(bounds))
+        for i = 1, 100 do
+            if (sampler() ~= twin:next(unpack(bounds))) then
+                error("pcg64.sampler must match pcg64.next on iteration " .. i)
+            end
+        end
+
+        local values = sampler(100)
+        if (#values ~= 100) then
+            error("Unexpected number of values provided by a pcg64.sampler")
+        end
+        for i = 1, #values do
+            if (values[i] ~= twin:next(unpack(bounds))) then
+                error("pcg64.sampler(n) must match pcg64.next at position " .. i)
+            end
+        end
+    end
+
+    if (pcall(rng.sampler, rng)) then
+        error("pcg64.sampler() must fail")
+    end
+    if (pcall(rng.sampler, rng, 0)) then
+        error("pcg64.sampler(0) must fail")
+    end
+
+    local sampler = rng:sampler(6)
+    rng:close()
+    twin:close()
+
+    if (pcall(sampler)) then
+        error("a pcg64.sampler must fail after pcg64.close")
+    end
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_iter()
+    print()
+    print("[PCG64] assert iter")
+
+    local unpack = table.unpack or unpack
+
+    local cases = {{}, {6}, {16}, {15, 40}, {-100, 100}}
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    for _, bounds in ipairs(cases) do
+        local count = 0
+        for i, x in rng:iter(100, unpack(bounds)) do
+            count = count + 1
+            if (i ~= count) then
+                error("pcg64.iter must yield consecutive indices")
+            end
+            if (x ~= twin:next(unpack(bounds))) then
+                error("pcg64.iter must match pcg64.next on iteration " .. i)
+            end
+        end
+        if (count ~= 100) then
+            error("Unexpected number of iterations on pcg64.iter")
+        end
+    end
+
+    for _ in rng:iter(0) do
+        error("pcg64.iter(0) must not iterate")
+    end
+
+    if (pcall(rng.iter, rng, -1)) then
+        error("pcg64.iter(-1) must fail")
+    end
+
+    local iter, state, control = rng:iter(10)
+    rng:close()
+    twin:close()
+
+    if (pcall(iter, state, control)) then
+        error("a pcg64.iter must fail after pcg64.close")
+    end
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_bits_bool()
+    print()
+    print("[PCG64] assert bits and bool")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    -- 64 bits on an empty cache are a whole value
+    for i = 1, 10 do
+        if (rng:bits(64) ~= twin:next()) then
+            error("pcg64.bits(64) must match pcg64.next on iteration " .. i)
+        end
+    end
+
+    -- bits are taken from the lowest to the highest one
+    for i = 1, 10 do
+        local bytes = twin:nextbytes()
+        for j = 1, 8 do
+            if (rng:bits(8) ~= bytes[j]) then
+                error("pcg64.bits(8) must match the bytes of pcg64.nextbytes on iteration " .. i)
+            end
+        end
+    end
+
+    for i = 1, 10 do
+        local bytes = twin:nextbytes()
+        for j = 1, 8 do
+            local byte = bytes[j]
+            for _ = 1, 8 do
+                if (rng:bool() ~= (byte % 2 == 1)) then
+                    error("pcg64.bool must match the bits of pcg64.nextbytes on iteration " .. i)
+                end
+                byte = math.floor(byte / 2)
+            end
+        end
+    end
+
+    -- the cached bits become the lowest bits of a value crossing two draws
+    rng:bits(64 - 4)
+    local high = math.floor(twin:nextbytes()[8] / 16)
+    local low = twin:nextbytes()[1] % 16
+    if (rng:bits(8) ~= high + 16 * low) then
+        error("pcg64.bits must join the cached bits with the bits of a new draw")
+    end
+
+    -- seed, advance and setstate discard the cached bits
+    local state = twin:getstate()
+    rng:bool()
+    rng:setstate(state)
+    if (rng:bits(64) ~= twin:next()) then
+        error("pcg64.setstate must discard the cached bits")
+    end
+    rng:bool()
+    twin:next()
+    rng:advance(10)
+    twin:advance(10)
+    if (rng:bits(64) ~= twin:next()) then
+        error("pcg64.advance must discard the cached bits")
+    end
+    rng:bool()
+    rng:seed(initstate_pcg64, initseq_pcg64)
+    twin:seed(initstate_pcg64, initseq_pcg64)
+    if (rng:bits(64) ~= twin:next()) then
+        error("pcg64.seed must discard the cached bits")
+    end
+
+    -- the discarded bits never leak into the values drawn afterwards
+    rng:bits(3)
+    twin:next()
+    rng:advance(1)
+    twin:advance(1)
+    if (rng:bits(4) ~= twin:nextbytes()[1] % 16) then
+        error("pcg64.advance must clear the cached bits")
+    end
+    rng:bits(2)
+    rng:seed(initstate_pcg64, initseq_pcg64)
+    twin:seed(initstate_pcg64, initseq_pcg64)
+    if (rng:bool() ~= (twin:nextbytes()[1] % 2 == 1)) then
+        error("pcg64.seed must clear the cached bits")
+    end
+    state = twin:getstate()
+    rng:bits(2)
+    rng:setstate(state)
+    if (rng:bits(4) ~= twin:nextbytes()[1] % 16) then
+        error("pcg64.setstate must clear the cached bits")
+    end
+
+    if (pcall(rng.bits, rng, 0)) then
+        error("pcg64.bits(0) must fail")
+    end
+    if (pcall(rng.bits, rng, 64 + 1)) then
+        error("pcg64.bits(64 + 1) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_shuffle()
+    print()
+    print("[PCG64] assert shuffle")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    -- Fisher-Yates written in Lua
+    local function shuffle(t, i, j)
+        for k = j, i + 1, -1 do
+            local r = i + twin:next(k - i + 1)
+            t[k], t[r] = t[r], t[k]
+        end
+        return t
+    end
+
+    local n = 1000
+    local t, expected = {}, {}
+    for k = 1, n do
+        t[k] = k
+        expected[k] = k
+    end
+
+    if (rng:shuffle(t) ~= t) then
+        error("pcg64.shuffle must return the table")
+    end
+    shuffle(expected, 1, n)
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg64.shuffle must match the Fisher-Yates algorithm at position " .. k)
+        end
+    end
+
+    local seen = {}
+    for k = 1, n do
+        seen[t[k]] = true
+    end
+    for k = 1, n do
+        if (not seen[k]) then
+            error("pcg64.shuffle must keep every value of the table")
+        end
+    end
+
+    rng:shuffle(t, 101, 200)
+    shuffle(expected, 101, 200)
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg64.shuffle(t, i, j) must only shuffle the positions i to j")
+        end
+    end
+
+    rng:shuffle(t, 900)
+    shuffle(expected, 900, n)
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg64.shuffle(t, i) must shuffle the positions i to #t")
+        end
+    end
+
+    -- nothing to shuffle
+    rng:shuffle({})
+    rng:shuffle({1})
+    rng:shuffle(t, 10, 5)
+
+    -- an empty range whose i does not fit on the table index type
+    local snapshot = {}
+    for k = 1, #t do
+        snapshot[k] = t[k]
+    end
+    rng:shuffle(t, 4294967296 + 1, 10)
+    for k = 1, #t do
+        if (t[k] ~= snapshot[k]) then
+            error("pcg64.shuffle(t, 2^32 + 1, 10) must leave the table untouched")
+        end
+    end
+
+    if (rng:next() ~= twin:next()) then
+        error("pcg64.shuffle must not draw values when there is nothing to shuffle")
+    end
+
+    if (pcall(rng.shuffle, rng, t, 0)) then
+        error("pcg64.shuffle(t, 0) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function is_power_of_two(k)
+    while (k % 2 == 0) do
+        k = k / 2
+    end
+    return k == 1
+end
+
+-- draws an index in [0, k) for k < 2^21 as the permutations and samples
+-- of pcg64 do: Lemire's method on the upper 32 bits of a 64-bit value
+local function pcg64_draw_index(rng, k)
+    local threshold = (4294967296 - k) % k
+    while (true) do
+        local bytes = rng:nextbytes()
+        local r = bytes[5] + 256 * (bytes[6] + 256 * (bytes[7] + 256 * bytes[8]))
+        if (is_power_of_two(k)) then
+            return r % k
+        end
+        local m = r * k
+        if (m % 4294967296 >= threshold) then
+            return math.floor(m / 4294967296)
+        end
+    end
+end
+
+local function pcg64_assert_permutation()
+    print()
+    print("[PCG64] assert permutation and permutationbuffer")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local function draw(k)
+        return pcg64_draw_index(twin, k)
+    end
+
+    -- inside-out Fisher-Yates written in Lua
+    local function permutation(n)
+        local t = {}
+        for k = 1, n do
+            local r = 1 + draw(k)
+            t[k] = t[r]
+            t[r] = k
+        end
+        return t
+    end
+
+    local n = 1000
+    local t = rng:permutation(n)
+    local expected = permutation(n)
+    if (#t ~= n) then
+        error("Unexpected number of values provided by pcg64.permutation")
+    end
+
+    local seen = {}
+    for k = 1, n do
+        if (t[k] ~= expected[k]) then
+            error("pcg64.permutation must match the inside-out Fisher-Yates algorithm at position " .. k)
+        end
+        seen[t[k]] = true
+    end
+    for k = 1, n do
+        if (not seen[k]) then
+            error("pcg64.permutation must hold every value from 1 to n")
+        end
+    end
+
+    if (next(rng:permutation(0)) ~= nil) then
+        error("pcg64.permutation(0) must be empty")
+    end
+    if (rng:permutation(1)[1] ~= 1) then
+        error("pcg64.permutation(1) must be {1}")
+    end
+    draw(1)
+
+    if (pcall(rng.permutation, rng, -1)) then
+        error("pcg64.permutation(-1) must fail")
+    end
+
+    local has_ffi, ffi = pcall(require, "ffi")
+    if (has_ffi) then
+        local buf32 = ffi.new("uint32_t[?]", n)
+        rng:permutationbuffer(buf32, n)
+        expected = permutation(n)
+        for k = 1, n do
+            if (tonumber(buf32[k - 1]) ~= expected[k] - 1) then
+                error("pcg64.permutationbuffer must match pcg64.permutation minus 1 at position " .. k)
+            end
+        end
+
+        local buf64 = ffi.new("uint64_t[?]", n)
+        rng:permutationbuffer(buf64, n, 8)
+        expected = permutation(n)
+        for k = 1, n do
+            if (tonumber(buf64[k - 1]) ~= expected[k] - 1) then
+                error("pcg64.permutationbuffer(ptr, n, 8) must match pcg64.permutation minus 1 at position " .. k)
+            end
+        end
+    else
+        print("skipped: FFI is not available")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_sample()
+    print()
+    print("[PCG64] assert sample")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local function draw(k)
+        return pcg64_draw_index(twin, k)
+    end
+
+    -- Floyd's algorithm and partial Fisher-Yates written in Lua
+    local function sample(n, k)
+        local t = {}
+        if (k <= math.floor(n / 2)) then
+            local taken = {}
+            for j = n - k + 1, n do
+                local v = 1 + draw(j)
+                if (taken[v]) then
+                    v = j
+                end
+                taken[v] = true
+                t[#t + 1] = v
+            end
+        else
+            local values = {}
+            for j = 1, n do
+                values[j] = j
+            end
+            for j = 1, k do
+                local r = j + draw(n - j + 1)
+                t[j] = values[r]
+                values[r] = values[j]
+            end
+        end
+        return t
+    end
+
+    local cases = {{1000000, 10}, {1000, 100}, {1000, 500}, {1000, 501}, {1000, 1000}, {10, 0}, {0, 0}, {1, 1}}
+    for _, case in ipairs(cases) do
+        local n, k = case[1], case[2]
+        local t = rng:sample(n, k)
+        local expected = sample(n, k)
+        if (#t ~= k) then
+            error(("Unexpected number of values provided by pcg64.sample(%i, %i)"):format(n, k))
+        end
+        local seen = {}
+        for i = 1, k do
+            local v = t[i]
+            if (v ~= expected[i]) then
+                error(("pcg64.sample(%i, %i) must match the reference algorithm at position %i"):format(n, k, i))
+            end
+            if (v < 1 or v > n or seen[v]) then
+                error(("pcg64.sample(%i, %i) must provide distinct values in [1, n]"):format(n, k))
+            end
+            seen[v] = true
+        end
+    end
+
+    if (pcall(rng.sample, rng, 10, 11)) then
+        error("pcg64.sample(10, 11) must fail")
+    end
+    if (pcall(rng.sample, rng, 10, -1)) then
+        error("pcg64.sample(10, -1) must fail")
+    end
+    if (math.type ~= nil and pcg.has64bitinteger and pcall(rng.sample, rng, 0x200000000, 0x80000001)) then
+        error("pcg64.sample(8589934592, 2147483649) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_samplesorted()
+    print()
+    print("[PCG64] assert samplesorted")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    local cases = {{1000000, 10}, {1000, 100}, {1000, 500}, {1000, 1000}, {100, 99}, {10, 0}, {0, 0}, {1, 1}, {5, 1}}
+    for _, case in ipairs(cases) do
+        local n, k = case[1], case[2]
+        local t = rng:samplesorted(n, k)
+        if (#t ~= k) then
+            error(("Unexpected number of values provided by pcg64.samplesorted(%i, %i)"):format(n, k))
+        end
+        local previous = 0
+        for i = 1, k do
+            local v = t[i]
+            if (v <= previous or v > n) then
+                error(("pcg64.samplesorted(%i, %i) must provide increasing values in [1, n]"):format(n, k))
+            end
+            previous = v
+        end
+
+        local count = 0
+        for i, v in twin:itersorted(n, k) do
+            count = count + 1
+            if (i ~= count or v ~= t[i]) then
+                error(("pcg64.itersorted(%i, %i) must match pcg64.samplesorted(%i, %i) at position %i"):format(n, k, n, k, count))
+            end
+        end
+        if (count ~= k) then
+            error(("Unexpected number of values provided by pcg64.itersorted(%i, %i)"):format(n, k))
+        end
+    end
+
+    -- every integer must be selected with probability k / n
+    local runs = 4000
+    local frequencies = {}
+    for v = 1, 10 do
+        frequencies[v] = 0
+    end
+    for _ = 1, runs do
+        for _, v in ipairs(rng:samplesorted(10, 3)) do
+            frequencies[v] = frequencies[v] + 1
+        end
+    end
+    for v = 1, 10 do
+        if (math.abs(frequencies[v] - runs * 3 / 10) > 150) then
+            error(("pcg64.samplesorted(10, 3) selected %i with unexpected frequency %i"):format(v, frequencies[v]))
+        end
+    end
+
+    for v = 1, 10 do
+        frequencies[v] = 0
+    end
+    for _ = 1, runs do
+        for _, v in rng:itersorted(1000000, 2) do
+            local bucket = 1 + math.floor((v - 1) / 100000)
+            frequencies[bucket] = frequencies[bucket] + 1
+        end
+    end
+    for v = 1, 10 do
+        if (math.abs(frequencies[v] - runs * 2 / 10) > 150) then
+            error(("pcg64.itersorted(1000000, 2) selected the bucket %i with unexpected frequency %i"):format(v, frequencies[v]))
+        end
+    end
+
+    if (pcall(rng.samplesorted, rng, 10, 11)) then
+        error("pcg64.samplesorted(10, 11) must fail")
+    end
+    if (pcall(rng.samplesorted, rng, 10, -1)) then
+        error("pcg64.samplesorted(10, -1) must fail")
+    end
+    if (pcall(rng.itersorted, rng, -1, 0)) then
+        error("pcg64.itersorted(-1, 0) must fail")
+    end
+
+    local iterator = rng:itersorted(10, 5)
+    rng:close()
+    if (pcall(iterator, nil, 0)) then
+        error("pcg64.itersorted iterator must fail after close")
+    end
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64_assert_normal_exponential()
+    print()
+    print("[PCG64] assert normal and exponential")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    -- the single and bulk forms consume the rng in the same manner
+    local t = rng:normal(2.5, 3, 1000)
+    local e = rng:exponential(4, 1000)
+    if (#t ~= 1000 or #e ~= 1000) then
+        error("Unexpected number of values provided by pcg64.normal and pcg64.exponential")
+    end
+    for i = 1, #t do
+        if (t[i] ~= 2.5 + 3 * twin:normal()) then
+            error(("pcg64.normal(mu, sigma, n) must match pcg64.normal() at position %i"):format(i))
+        end
+    end
+    for i = 1, #e do
+        if (e[i] ~= (1 / 4) * twin:exponential() or e[i] < 0) then
+            error(("pcg64.exponential(lambda, n) must match pcg64.exponential() at position %i"):format(i))
+        end
+    end
+
+    -- standard normal cumulative distribution function (Abramowitz and Stegun, 26.2.17)
+    local function normal_cdf(x)
+        local z = math.abs(x)
+        local k = 1 / (1 + 0.2316419 * z)
+        local p = 1 - math.exp(-0.5 * z * z) / math.sqrt(2 * math.pi) * k * (0.319381530 + k * (-0.356563782 + k * (1.781477937 + k * (-1.821255978 + k * 1.330274429))))
+        return x >= 0 and p or 1 - p
+    end
+
+    local function exponential_cdf(x)
+        return 1 - math.exp(-x)
+    end
+
+    -- Kolmogorov-Smirnov statistic of the sample values against cdf
+    local function ks(values, cdf)
+        local d = 0
+        table.sort(values)
+        for i = 1, #values do
+            local f = cdf(values[i])
+            d = math.max(d, math.abs(f - i / #values), math.abs(f - (i - 1) / #values))
+        end
+        return d
+    end
+
+    local n = 100000
+    local samples = {normal = rng:normal(0, 1, n), exponential = rng:exponential(1, n)}
+    local cdfs = {normal = normal_cdf, exponential = exponential_cdf}
+    local means = {normal = 0, exponential = 1}
+    -- fourth central moments, which bound the error of the sample variance
+    local moments = {normal = 3, exponential = 9}
+    for name, values in pairs(samples) do
+        local sum, sum2 = 0, 0
+        for i = 1, n do
+            sum = sum + values[i]
+            sum2 = sum2 + values[i] * values[i]
+        end
+        local mean = sum / n
+        local variance = sum2 / n - mean * mean
+        if (math.abs(mean - means[name]) > 5 / math.sqrt(n) or math.abs(variance - 1) > 5 * math.sqrt((moments[name] - 1) / n)) then
+            error(("pcg64.%s provided unexpected moments: mean %f, variance %f"):format(name, mean, variance))
+        end
+        local d = ks(values, cdfs[name])
+        if (d > 1.95 / math.sqrt(n)) then
+            error(("pcg64.%s failed the Kolmogorov-Smirnov test: D = %f"):format(name, d))
+        end
+    end
+
+    -- the tails beyond the base layer of the ziggurat are reached
+    local tail = 0
+    for _, x in ipairs(rng:normal(0, 1, 200000)) do
+        if (math.abs(x) > 3.6541528853610088) then
+            tail = tail + 1
+        end
+    end
+    if (tail == 0 or math.abs(tail - 200000 * 2.58052e-4) > 5 * math.sqrt(200000 * 2.58052e-4)) then
+        error(("pcg64.normal reached the tails with unexpected frequency %i"):format(tail))
+    end
+
+    if (rng:normal(1, 0) ~= 1) then
+        error("pcg64.normal(mu, 0) must provide mu")
+    end
+    if (pcall(rng.normal, rng, 0, -1)) then
+        error("pcg64.normal(0, -1) must fail")
+    end
+    if (pcall(rng.normal, rng, 0 / 0, 1)) then
+        error("pcg64.normal(nan, 1) must fail")
+    end
+    if (pcall(rng.normal, rng, 0, 1, -1)) then
+        error("pcg64.normal(0, 1, -1) must fail")
+    end
+    if (pcall(rng.exponential, rng, 0)) then
+        error("pcg64.exponential(0) must fail")
+    end
+    if (pcall(rng.exponential, rng, -1)) then
+        error("pcg64.exponential(-1) must fail")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
 local tests = {
     pcg64_100_numbers,
     pcg64_100_numbers_from_bytearray,
@@ -279,7 +1594,24 @@ local tests = {
     pcg64_random_eight_bytes,
     pcg64_assert_next,
     pcg64_assert_next_from_bytearray,
-    pcg64_assert_advance
+    pcg64_assert_advance,
+    pcg64_assert_fill,
+    pcg64_assert_bytes,
+    pcg64_assert_fillbuffer,
+    pcg64_assert_nextdouble_nextfloat,
+    pcg64_assert_bounded_next,
+    pcg64_assert_bounded_next_64bit,
+    pcg64_assert_split,
+    pcg64_assert_getstate_setstate,
+    pcg64_assert_integer_and_binary_args,
+    pcg64_assert_sampler,
+    pcg64_assert_iter,
+    pcg64_assert_bits_bool,
+    pcg64_assert_shuffle,
+    pcg64_assert_permutation,
+    pcg64_assert_sample,
+    pcg64_assert_samplesorted,
+    pcg64_assert_normal_exponential
 }
 
 for i, test_func in ipairs(tests) do
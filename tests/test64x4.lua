@@ -0,0 +1,198 @@
+-- Allow lua-pcg to be tested
+-- without edits on DOSBox
+-- (16-bit OS) when lua-pcg is
+-- is merged with Lua's
+-- interpreter source code (lua.c),
+-- To do that, lua.c is edited
+-- to load lua-pcg.
+if (pcg == nil) then
+    pcg = require("lua-pcg")
+end
+local pcg64 = pcg.pcg64
+local pcg64x4 = pcg.pcg64x4
+
+print()
+print("------------------------------------------")
+print("PCG64X4")
+print("------------------------------------------")
+print()
+print("******************************************")
+print()
+print("lua-pcg version: " .. pcg.version)
+print("32-bit integer: " .. tostring(pcg.has32bitinteger))
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+
+local lanes = 4
+local initstate_pcg64, initseq_pcg64 = '0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb'
+
+-- creates one pcg64 twin for each lane of a pcg64x4
+-- created through pcg64x4.new('0x2a', '0x10')
+local function new_twins()
+    local twins = {}
+    for lane = 1, lanes do
+        twins[lane] = pcg64.new('0x2a', ("0x%02x"):format(0x10 + lane - 1))
+    end
+    return twins
+end
+
+local function close_twins(twins)
+    for lane = 1, lanes do
+        twins[lane]:close()
+    end
+end
+
+local function pcg64x4_assert_lanes_next()
+    print()
+    print("[PCG64X4] assert next on every lane")
+
+    local rng = pcg64x4.new()
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+    for lane = 1, lanes do
+        rng:seed(initstate_pcg64, initseq_pcg64, lane)
+    end
+
+    -- the full 64-bit values can only be compared on Lua 5.3+ with 64-bit integers
+    local lines = {}
+    if (math.type ~= nil and pcg.has64bitinteger) then
+        local pcg_file = assert(io.open("tests/next64.txt", "r"), "Unable to open next64.txt file")
+        for line in pcg_file:lines() do
+            table.insert(lines, line)
+        end
+        pcg_file:close()
+    else
+        for i = 1, 1000 do
+            lines[i] = twin:next()
+        end
+    end
+
+    for i = 1, #lines do
+        local values = {rng:next()}
+        if (#values ~= lanes) then
+            error("Unexpected number of values provided by pcg64x4.next")
+        end
+
+        for lane = 1, lanes do
+            local value = values[lane]
+            if (type(lines[i]) == "string") then
+                value = ("[%05i] 0x%016X"):format(i, value)
+            end
+
+            if (lines[i] ~= value) then
+                error("Invalid pcg64x4.next output of lane " .. lane .. " on line " .. i)
+            end
+        end
+    end
+
+    twin:close()
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function pcg64x4_assert_streams()
+    print()
+    print("[PCG64X4] assert lane streams, partial rounds and advance")
+
+    local rng = pcg64x4.new('0x2a', '0x10')
+    local twins = new_twins()
+
+    -- partial rounds only step the first lanes
+    for _, n in ipairs({0, 1, 3, 4, 13, 200, 301}) do
+        local t = rng:fill(n)
+        if (#t ~= n) then
+            error("Unexpected number of values provided by pcg64x4.fill(" .. n .. ")")
+        end
+
+        for i = 1, n do
+            local lane = (i - 1) % lanes + 1
+            if (t[i] ~= twins[lane]:next()) then
+                error("Invalid pcg64x4.fill(" .. n .. ") output at position " .. i)
+            end
+        end
+    end
+
+    rng:advance('0x1234')
+    for lane = 1, lanes do
+        twins[lane]:advance('0x1234')
+    end
+
+    local values = {rng:next()}
+    for lane = 1, lanes do
+        if (values[lane] ~= twins[lane]:next()) then
+            error("Invalid pcg64x4.next output of lane " .. lane .. " after advance")
+        end
+    end
+
+    for _, lane in ipairs({0, 5}) do
+        if (pcall(rng.seed, rng, '0x1', '0x1', lane)) then
+            error("pcg64x4.seed must reject lanes out of [1, 4] range")
+        end
+    end
+
+    close_twins(twins)
+    rng:close()
+
+    if (pcall(rng.next, rng)) then
+        error("pcg64x4.next must fail after close")
+    end
+
+    print("done")
+    print()
+end
+
+local function pcg64x4_assert_fillbuffer()
+    print()
+    print("[PCG64X4] assert fillbuffer")
+
+    local rng = pcg64x4.new('0x2a', '0x10')
+
+    if (pcall(rng.fillbuffer, rng, {}, 1)) then
+        error("pcg64x4.fillbuffer must reject arguments other than lightuserdata or cdata")
+    end
+
+    local has_ffi, ffi = pcall(require, "ffi")
+    if (has_ffi) then
+        local twins = new_twins()
+
+        local n = 1000 + 3
+        local buf = ffi.new("uint64_t[?]", n)
+        rng:fillbuffer(buf, n)
+
+        local value = ffi.new("uint64_t[1]")
+        for i = 0, n - 1 do
+            twins[i % lanes + 1]:fillbuffer(value, 1)
+            if (buf[i] ~= value[0]) then
+                error("Invalid pcg64x4.fillbuffer output at position " .. i)
+            end
+        end
+
+        close_twins(twins)
+    else
+        print("skipped: FFI is not available")
+    end
+
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local tests = {
+    pcg64x4_assert_lanes_next,
+    pcg64x4_assert_streams,
+    pcg64x4_assert_fillbuffer
+}
+
+for i, test_func in ipairs(tests) do
+    test_func()
+    print("******************************************")
+end
+
+print()
+print("------------------------------------------")
+print("------------------------------------------")
+print()
+print()
@@ -0,0 +1,176 @@
+-- Allow lua-pcg to be tested
+-- without edits on DOSBox
+-- (16-bit OS) when lua-pcg is
+-- is merged with Lua's
+-- interpreter source code (lua.c),
+-- To do that, lua.c is edited
+-- to load lua-pcg.
+if (pcg == nil) then
+    pcg = require("lua-pcg")
+end
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+local alias = pcg.alias
+
+print()
+print("------------------------------------------")
+print("ALIAS")
+print("------------------------------------------")
+print()
+print("******************************************")
+print()
+print("lua-pcg version: " .. pcg.version)
+print("32-bit integer: " .. tostring(pcg.has32bitinteger))
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+
+local initstate_pcg32, initseq_pcg32 = '0x853c49e6748fea9b', '0xda3e39cb94b95bdb'
+local initstate_pcg64, initseq_pcg64 = '0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb'
+
+-- the probability of each integer of an alias table built from weights
+local function probabilities(weights)
+    local sum = 0
+    local p = {}
+    for i = 1, #weights do
+        sum = sum + weights[i]
+    end
+    for i = 1, #weights do
+        p[i] = weights[i] / sum
+    end
+    return p
+end
+
+local function alias_assert_frequencies()
+    print()
+    print("[ALIAS] assert frequencies")
+
+    local runs = 20000
+    local rngs = {
+        pcg32 = pcg32.new(initstate_pcg32, initseq_pcg32),
+        pcg64 = pcg64.new(initstate_pcg64, initseq_pcg64)
+    }
+    local cases = {
+        {1, 2, 3, 4, 0},
+        {0, 0, 5},
+        {1, 1, 1, 1, 1, 1, 1, 1},
+        {0.1, 10, 0.5, 3.25, 7, 0, 1e-3, 2},
+        {1}
+    }
+
+    for name, rng in pairs(rngs) do
+        for c, weights in ipairs(cases) do
+            local a = alias.new(weights)
+            if (a:size() ~= #weights) then
+                error(("Unexpected size of the alias table of the case %i"):format(c))
+            end
+
+            local p = probabilities(weights)
+            local frequencies = {}
+            for i = 1, #weights do
+                frequencies[i] = 0
+            end
+            for _, v in ipairs(a:sample(rng, runs)) do
+                if (v < 1 or v > #weights) then
+                    error(("alias:sample(%s, n) provided %i out of range on the case %i"):format(name, v, c))
+                end
+                frequencies[v] = frequencies[v] + 1
+            end
+            for i = 1, #weights do
+                local expected = runs * p[i]
+                local sd = math.sqrt(runs * p[i] * (1 - p[i]))
+                if (math.abs(frequencies[i] - expected) > 5 * sd + 1) then
+                    error(("alias:sample(%s, n) selected %i with unexpected frequency %i on the case %i"):format(name, i, frequencies[i], c))
+                end
+                if (weights[i] == 0 and frequencies[i] ~= 0) then
+                    error(("alias:sample(%s, n) must never select integers of zero weight"):format(name))
+                end
+            end
+        end
+        rng:close()
+    end
+
+    print("done")
+    print()
+end
+
+local function alias_assert_bulk()
+    print()
+    print("[ALIAS] assert bulk sample")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local a = alias.new({5, 1, 0, 2, 9, 3})
+
+    local t = a:sample(rng, 1000)
+    if (#t ~= 1000) then
+        error("Unexpected number of values provided by alias:sample(rng, 1000)")
+    end
+    for i = 1, #t do
+        if (t[i] ~= a:sample(twin)) then
+            error(("alias:sample(rng, n) must match alias:sample(rng) at position %i"):format(i))
+        end
+    end
+    if (#a:sample(rng, 0) ~= 0) then
+        error("alias:sample(rng, 0) must provide an empty table")
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function alias_assert_errors()
+    print()
+    print("[ALIAS] assert errors")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local invalid = {{}, {0, 0}, {1, -1}, {1, 0 / 0}, {1, 1 / 0}, {1, "2"}, {1, true}}
+    for i, weights in ipairs(invalid) do
+        if (pcall(alias.new, weights)) then
+            error(("alias.new must fail on the invalid case %i"):format(i))
+        end
+    end
+    if (pcall(alias.new, 1)) then
+        error("alias.new must fail without a table")
+    end
+
+    local a = alias.new({1, 2})
+    if (pcall(a.sample, a, {})) then
+        error("alias:sample must fail without a pcg32 or pcg64 instance")
+    end
+    if (pcall(a.sample, a, rng, -1)) then
+        error("alias:sample(rng, -1) must fail")
+    end
+    if (pcall(a.sample, rng, rng)) then
+        error("alias:sample must fail on other objects")
+    end
+
+    rng:close()
+    if (pcall(a.sample, a, rng)) then
+        error("alias:sample must fail after the rng was closed")
+    end
+
+    print("done")
+    print()
+end
+
+local tests = {
+    alias_assert_frequencies,
+    alias_assert_bulk,
+    alias_assert_errors
+}
+
+for i, test_func in ipairs(tests) do
+    test_func()
+    print("******************************************")
+end
+
+print()
+print("------------------------------------------")
+print("------------------------------------------")
+print()
+print()
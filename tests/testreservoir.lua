@@ -0,0 +1,296 @@
+-- Allow lua-pcg to be tested
+-- without edits on DOSBox
+-- (16-bit OS) when lua-pcg is
+-- is merged with Lua's
+-- interpreter source code (lua.c),
+-- To do that, lua.c is edited
+-- to load lua-pcg.
+if (pcg == nil) then
+    pcg = require("lua-pcg")
+end
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+local reservoir = pcg.reservoir
+
+print()
+print("------------------------------------------")
+print("RESERVOIR")
+print("------------------------------------------")
+print()
+print("******************************************")
+print()
+print("lua-pcg version: " .. pcg.version)
+print("32-bit integer: " .. tostring(pcg.has32bitinteger))
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+
+local initstate_pcg32, initseq_pcg32 = '0x853c49e6748fea9b', '0xda3e39cb94b95bdb'
+local initstate_pcg64, initseq_pcg64 = '0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb'
+
+-- uniform floating-point number in (0, 1] drawn by the reservoirs
+local function uniform(rng)
+    return 1.0 - rng:nextdouble()
+end
+
+-- Algorithm L written in Lua
+local function reference_unweighted(twin, k, items)
+    local t = {}
+    local w, skip
+    for i, item in ipairs(items) do
+        if (i <= k) then
+            t[i] = item
+            if (i == k) then
+                w = math.exp(math.log(uniform(twin)) / k)
+                skip = math.floor(math.log(uniform(twin)) / math.log(1.0 - w))
+            end
+        elseif (skip >= 1) then
+            skip = skip - 1
+        else
+            t[1 + twin:next(k)] = item
+            w = w * math.exp(math.log(uniform(twin)) / k)
+            skip = math.floor(math.log(uniform(twin)) / math.log(1.0 - w))
+        end
+    end
+    return t
+end
+
+-- A-ExpJ written in Lua, on a sorted list in place of a heap
+local function reference_weighted(twin, k, items, weights)
+    local t = {}
+    local nodes = {}
+    local skip
+    local function sort()
+        table.sort(nodes, function(a, b) return a.key < b.key end)
+    end
+    for i, item in ipairs(items) do
+        local weight = weights[i]
+        if (weight > 0) then
+            if (#nodes < k) then
+                nodes[#nodes + 1] = {key = math.log(uniform(twin)) / weight, slot = #nodes + 1}
+                t[#nodes] = item
+                sort()
+                if (#nodes == k) then
+                    skip = math.log(uniform(twin)) / nodes[1].key
+                end
+            else
+                skip = skip - weight
+                if (skip <= 0) then
+                    local m = math.exp(weight * nodes[1].key)
+                    local u = m + (1.0 - m) * uniform(twin)
+                    nodes[1].key = math.log(u) / weight
+                    t[nodes[1].slot] = item
+                    sort()
+                    skip = math.log(uniform(twin)) / nodes[1].key
+                end
+            end
+        end
+    end
+    return t
+end
+
+local function reservoir_assert_unweighted()
+    print()
+    print("[RESERVOIR] assert unweighted")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local cases = {{5, 3}, {5, 5}, {1, 1000}, {10, 10000}, {100, 5000}}
+    for _, case in ipairs(cases) do
+        local k, n = case[1], case[2]
+        local items = {}
+        for i = 1, n do
+            items[i] = "item" .. i
+        end
+
+        local r = reservoir.new(rng, k)
+        for _, item in ipairs(items) do
+            r:push(item)
+        end
+        if (r:count() ~= n) then
+            error(("Unexpected count of reservoir.new(rng, %i) after %i pushes"):format(k, n))
+        end
+
+        local t = r:result()
+        local expected = reference_unweighted(twin, k, items)
+        if (#t ~= math.min(k, n)) then
+            error(("Unexpected number of items on reservoir.new(rng, %i) after %i pushes"):format(k, n))
+        end
+        for i = 1, #t do
+            if (t[i] ~= expected[i]) then
+                error(("reservoir.new(rng, %i) must match the reference algorithm at position %i"):format(k, i))
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function reservoir_assert_weighted()
+    print()
+    print("[RESERVOIR] assert weighted")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    local cases = {{5, 3}, {5, 5}, {1, 1000}, {10, 10000}, {100, 5000}}
+    for _, case in ipairs(cases) do
+        local k, n = case[1], case[2]
+        local items = {}
+        local weights = {}
+        for i = 1, n do
+            items[i] = i
+            weights[i] = (i % 7 == 0) and 0 or (i % 5) + 0.5
+        end
+
+        local r = reservoir.new(rng, k, true)
+        for i, item in ipairs(items) do
+            r:push(item, weights[i])
+        end
+        if (r:count() ~= n) then
+            error(("Unexpected count of reservoir.new(rng, %i, true) after %i pushes"):format(k, n))
+        end
+
+        local t = r:result()
+        local expected = reference_weighted(twin, k, items, weights)
+        if (#t ~= #expected) then
+            error(("Unexpected number of items on reservoir.new(rng, %i, true) after %i pushes"):format(k, n))
+        end
+        for i = 1, #t do
+            if (t[i] ~= expected[i]) then
+                error(("reservoir.new(rng, %i, true) must match the reference algorithm at position %i"):format(k, i))
+            end
+            if (weights[t[i]] == 0) then
+                error("reservoir.new(rng, k, true) must never select items of zero weight")
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function reservoir_assert_frequencies()
+    print()
+    print("[RESERVOIR] assert frequencies")
+
+    local runs = 4000
+    local rngs = {
+        pcg32 = pcg32.new(initstate_pcg32, initseq_pcg32),
+        pcg64 = pcg64.new(initstate_pcg64, initseq_pcg64)
+    }
+
+    for name, rng in pairs(rngs) do
+        -- every item must be selected with probability k / n
+        local frequencies = {}
+        for i = 1, 20 do
+            frequencies[i] = 0
+        end
+        for _ = 1, runs do
+            local r = reservoir.new(rng, 5)
+            for i = 1, 20 do
+                r:push(i)
+            end
+            for _, item in ipairs(r:result()) do
+                frequencies[item] = frequencies[item] + 1
+            end
+        end
+        for i = 1, 20 do
+            if (math.abs(frequencies[i] - runs * 5 / 20) > 150) then
+                error(("reservoir.new(%s, 5) selected %i with unexpected frequency %i"):format(name, i, frequencies[i]))
+            end
+        end
+
+        -- with k = 1, every item must be selected with probability proportional to its weight
+        for i = 1, 4 do
+            frequencies[i] = 0
+        end
+        for _ = 1, runs do
+            local r = reservoir.new(rng, 1, true)
+            for i = 1, 4 do
+                r:push(i, i)
+            end
+            local item = r:result()[1]
+            frequencies[item] = frequencies[item] + 1
+        end
+        for i = 1, 4 do
+            if (math.abs(frequencies[i] - runs * i / 10) > 200) then
+                error(("reservoir.new(%s, 1, true) selected %i with unexpected frequency %i"):format(name, i, frequencies[i]))
+            end
+        end
+
+        rng:close()
+    end
+
+    print("done")
+    print()
+end
+
+local function reservoir_assert_errors()
+    print()
+    print("[RESERVOIR] assert errors")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+
+    if (pcall(reservoir.new, {}, 1)) then
+        error("reservoir.new must fail without a pcg32 or pcg64 instance")
+    end
+    if (pcall(reservoir.new, rng, 0)) then
+        error("reservoir.new(rng, 0) must fail")
+    end
+
+    local r = reservoir.new(rng, 2)
+    local w = reservoir.new(rng, 2, true)
+    if (pcall(r.push, r, nil)) then
+        error("reservoir:push(nil) must fail")
+    end
+    if (pcall(r.push, r, 1, 2)) then
+        error("reservoir:push(item, weight) must fail on unweighted reservoirs")
+    end
+    if (pcall(w.push, w, 1, -1)) then
+        error("reservoir:push(item, -1) must fail")
+    end
+    if (pcall(w.push, w, 1, 0 / 0)) then
+        error("reservoir:push(item, nan) must fail")
+    end
+    if (r:count() ~= 0 or w:count() ~= 0) then
+        error("failed pushes must not be counted")
+    end
+
+    rng:close()
+    if (pcall(r.push, r, 1)) then
+        error("reservoir:push must fail after the rng was closed")
+    end
+    if (pcall(reservoir.new, rng, 1)) then
+        error("reservoir.new must fail after the rng was closed")
+    end
+
+    print("done")
+    print()
+end
+
+local tests = {
+    reservoir_assert_unweighted,
+    reservoir_assert_weighted,
+    reservoir_assert_frequencies,
+    reservoir_assert_errors
+}
+
+for i, test_func in ipairs(tests) do
+    test_func()
+    print("******************************************")
+end
+
+print()
+print("------------------------------------------")
+print("------------------------------------------")
+print()
+print()
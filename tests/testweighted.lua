@@ -0,0 +1,258 @@
+-- Allow lua-pcg to be tested
+-- without edits on DOSBox
+-- (16-bit OS) when lua-pcg is
+-- is merged with Lua's
+-- interpreter source code (lua.c),
+-- To do that, lua.c is edited
+-- to load lua-pcg.
+if (pcg == nil) then
+    pcg = require("lua-pcg")
+end
+local pcg32 = pcg.pcg32
+local pcg64 = pcg.pcg64
+local weighted = pcg.weighted
+
+print()
+print("------------------------------------------")
+print("WEIGHTED")
+print("------------------------------------------")
+print()
+print("******************************************")
+print()
+print("lua-pcg version: " .. pcg.version)
+print("32-bit integer: " .. tostring(pcg.has32bitinteger))
+print("64-bit integer: " .. tostring(pcg.has64bitinteger))
+print("64-bit emulation: " .. tostring(pcg.emulation64bit))
+print("128-bit emulation: " .. tostring(pcg.emulation128bit))
+
+local initstate_pcg32, initseq_pcg32 = '0x853c49e6748fea9b', '0xda3e39cb94b95bdb'
+local initstate_pcg64, initseq_pcg64 = '0x979c9a98d84620057d3e9cb6cfe0549b', '0x0000000000000001da3e39cb94b95bdb'
+
+local function weighted_assert_set_get()
+    print()
+    print("[WEIGHTED] assert set and get")
+
+    local w = weighted.new(5)
+    if (w:size() ~= 5 or w:total() ~= 0) then
+        error("weighted.new(5) must hold 5 weights set to 0")
+    end
+    for i = 1, 5 do
+        if (w:get(i) ~= 0) then
+            error(("weighted.new(5) must hold the weight 0 at %i"):format(i))
+        end
+    end
+
+    w:set(2, 1.5)
+    w:set(5, 3)
+    w:set(2, 0.25)
+    if (w:get(2) ~= 0.25 or w:get(5) ~= 3 or w:total() ~= 3.25) then
+        error("weighted:set must update the weights and the total")
+    end
+
+    -- the total never drifts, since the sums are recomputed on every update
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local many = weighted.new(1000)
+    for _ = 1, 10000 do
+        many:set(1 + rng:next(1000), rng:nextdouble() * 1000)
+    end
+    for i = 1, 1000 do
+        many:set(i, 0)
+    end
+    if (many:total() ~= 0) then
+        error("weighted:total() must be exactly 0 after every weight was set to 0")
+    end
+    rng:close()
+
+    print("done")
+    print()
+end
+
+local function weighted_assert_reference()
+    print()
+    print("[WEIGHTED] assert reference")
+
+    local n = 37
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local twin = pcg32.new(initstate_pcg32, initseq_pcg32)
+    local updates = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local w = weighted.new(n)
+    local weights = {}
+    for i = 1, n do
+        weights[i] = 0
+    end
+
+    -- integer weights hold exact sums, such that a linear scan matches the tree
+    local function reference()
+        local total = 0
+        for i = 1, n do
+            total = total + weights[i]
+        end
+        local u = twin:nextdouble() * total
+        local sum = 0
+        for i = 1, n do
+            sum = sum + weights[i]
+            if (u < sum) then
+                return i
+            end
+        end
+    end
+
+    for iteration = 1, 2000 do
+        local i = 1 + updates:next(n)
+        local value = (updates:next(4) == 0) and 0 or updates:next(1000)
+        weights[i] = value
+        w:set(i, value)
+        if (w:total() > 0) then
+            local expected = reference()
+            local v = w:sample(rng)
+            if (v ~= expected) then
+                error(("weighted:sample(rng) must match the reference at the iteration %i"):format(iteration))
+            end
+        end
+    end
+
+    rng:close()
+    twin:close()
+    updates:close()
+
+    print("done")
+    print()
+end
+
+local function weighted_assert_frequencies()
+    print()
+    print("[WEIGHTED] assert frequencies")
+
+    local runs = 20000
+    local rngs = {
+        pcg32 = pcg32.new(initstate_pcg32, initseq_pcg32),
+        pcg64 = pcg64.new(initstate_pcg64, initseq_pcg64)
+    }
+
+    for name, rng in pairs(rngs) do
+        local w = weighted.new(5)
+        for i = 1, 4 do
+            w:set(i, i)
+        end
+
+        for phase = 1, 2 do
+            local total = w:total()
+            local frequencies = {0, 0, 0, 0, 0}
+            for _, v in ipairs(w:sample(rng, runs)) do
+                frequencies[v] = frequencies[v] + 1
+            end
+            for i = 1, 5 do
+                local p = w:get(i) / total
+                local sd = math.sqrt(runs * p * (1 - p))
+                if (math.abs(frequencies[i] - runs * p) > 5 * sd + 1) then
+                    error(("weighted:sample(%s, n) selected %i with unexpected frequency %i"):format(name, i, frequencies[i]))
+                end
+                if (p == 0 and frequencies[i] ~= 0) then
+                    error(("weighted:sample(%s, n) must never select integers of zero weight"):format(name))
+                end
+            end
+
+            -- the distribution changes on the next phase
+            w:set(4, 0)
+            w:set(5, 10)
+        end
+
+        rng:close()
+    end
+
+    print("done")
+    print()
+end
+
+local function weighted_assert_bulk()
+    print()
+    print("[WEIGHTED] assert bulk sample")
+
+    local rng = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local twin = pcg64.new(initstate_pcg64, initseq_pcg64)
+    local w = weighted.new(100)
+    for i = 1, 100 do
+        w:set(i, (i % 3) * 0.5)
+    end
+
+    local t = w:sample(rng, 1000)
+    if (#t ~= 1000) then
+        error("Unexpected number of values provided by weighted:sample(rng, 1000)")
+    end
+    for i = 1, #t do
+        if (t[i] ~= w:sample(twin)) then
+            error(("weighted:sample(rng, n) must match weighted:sample(rng) at position %i"):format(i))
+        end
+    end
+
+    rng:close()
+    twin:close()
+
+    print("done")
+    print()
+end
+
+local function weighted_assert_errors()
+    print()
+    print("[WEIGHTED] assert errors")
+
+    local rng = pcg32.new(initstate_pcg32, initseq_pcg32)
+
+    if (pcall(weighted.new, 0)) then
+        error("weighted.new(0) must fail")
+    end
+
+    local w = weighted.new(3)
+    if (pcall(w.sample, w, rng)) then
+        error("weighted:sample must fail when every weight is 0")
+    end
+
+    local invalid = {{0, 1}, {4, 1}, {1, -1}, {1, 0 / 0}, {1, 1 / 0}}
+    for i, case in ipairs(invalid) do
+        if (pcall(w.set, w, case[1], case[2])) then
+            error(("weighted:set must fail on the invalid case %i"):format(i))
+        end
+    end
+
+    w:set(1, 1e308)
+    if (pcall(w.set, w, 2, 1e308)) then
+        error("weighted:set must fail when the total overflows")
+    end
+    if (w:get(2) ~= 0 or w:total() ~= 1e308) then
+        error("weighted:set must leave the weights untouched when it fails")
+    end
+
+    if (pcall(w.sample, w, {})) then
+        error("weighted:sample must fail without a pcg32 or pcg64 instance")
+    end
+    if (pcall(w.sample, w, rng, -1)) then
+        error("weighted:sample(rng, -1) must fail")
+    end
+
+    rng:close()
+    if (pcall(w.sample, w, rng)) then
+        error("weighted:sample must fail after the rng was closed")
+    end
+
+    print("done")
+    print()
+end
+
+local tests = {
+    weighted_assert_set_get,
+    weighted_assert_reference,
+    weighted_assert_frequencies,
+    weighted_assert_bulk,
+    weighted_assert_errors
+}
+
+for i, test_func in ipairs(tests) do
+    test_func()
+    print("******************************************")
+end
+
+print()
+print("------------------------------------------")
+print("------------------------------------------")
+print()
+print()